@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace benchmark_stats {
+
+inline double get_mean(const std::vector<double>& samples)
+{
+    double sum = 0;
+    for (const double sample : samples) sum += sample;
+    return samples.empty() ? 0 : sum / static_cast<double>(samples.size());
+}
+
+/// Unbiased sample variance, 0 for fewer than 2 samples.
+inline double get_variance(const std::vector<double>& samples)
+{
+    if (samples.size() < 2) return 0;
+    const double mean = get_mean(samples);
+    double sum = 0;
+    for (const double sample : samples) sum += (sample - mean) * (sample - mean);
+    return sum / static_cast<double>(samples.size() - 1);
+}
+
+/// Nearest-rank percentile of sorted samples, `p` in [0, 1].
+inline double get_percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) return 0;
+    const size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+namespace detail {
+
+/// Continued fraction of the incomplete beta function (modified Lentz).
+inline double beta_continued_fraction(double a, double b, double x)
+{
+    constexpr int max_iterations = 300;
+    constexpr double epsilon = 1e-14;
+    constexpr double tiny = 1e-300;
+    double c = 1;
+    double d = 1 - (a + b) * x / (a + 1);
+    if (std::abs(d) < tiny) d = tiny;
+    d = 1 / d;
+    double result = d;
+    for (int m = 1; m <= max_iterations; m++) {
+        const double m2 = 2 * m;
+        double aa = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+        d = 1 + aa * d;
+        if (std::abs(d) < tiny) d = tiny;
+        c = 1 + aa / c;
+        if (std::abs(c) < tiny) c = tiny;
+        d = 1 / d;
+        result *= d * c;
+        aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+        d = 1 + aa * d;
+        if (std::abs(d) < tiny) d = tiny;
+        c = 1 + aa / c;
+        if (std::abs(c) < tiny) c = tiny;
+        d = 1 / d;
+        const double delta = d * c;
+        result *= delta;
+        if (std::abs(delta - 1) < epsilon) break;
+    }
+    return result;
+}
+
+/// Regularized incomplete beta function I_x(a, b).
+inline double incomplete_beta(double a, double b, double x)
+{
+    if (x <= 0) return 0;
+    if (x >= 1) return 1;
+    const double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                                  a * std::log(x) + b * std::log(1 - x));
+    if (x < (a + 1) / (a + b + 2)) {
+        return front * beta_continued_fraction(a, b, x) / a;
+    } else {
+        return 1 - front * beta_continued_fraction(b, a, 1 - x) / b;
+    }
+}
+
+} // namespace detail
+
+/**
+ * Probability that a Student t variable with `df` degrees of freedom exceeds
+ * `t`.
+ */
+inline double get_student_t_upper_tail(double t, double df)
+{
+    const double tail = 0.5 * detail::incomplete_beta(df / 2, 0.5, df / (df + t * t));
+    return t > 0 ? tail : 1 - tail;
+}
+
+struct WelchTest
+{
+    double t = 0;
+    double df = 0;
+    /// One-sided p-value of mean(candidate) > mean(reference).
+    double p_value = 1;
+};
+
+/**
+ * Welch's t-test of whether `candidate` has a larger mean than `reference`,
+ * without assuming equal variances.  Both need at least 2 samples, otherwise
+ * the p-value is NaN.
+ */
+inline WelchTest welch_t_test(
+    const std::vector<double>& reference, const std::vector<double>& candidate)
+{
+    WelchTest result;
+    if (reference.size() < 2 || candidate.size() < 2) {
+        result.p_value = std::numeric_limits<double>::quiet_NaN();
+        return result;
+    }
+    const double n1 = static_cast<double>(reference.size());
+    const double n2 = static_cast<double>(candidate.size());
+    const double v1 = get_variance(reference) / n1;
+    const double v2 = get_variance(candidate) / n2;
+    const double difference = get_mean(candidate) - get_mean(reference);
+    if (v1 + v2 == 0) {
+        // No spread on either side: any difference is significant.
+        result.p_value = difference > 0 ? 0 : 1;
+        return result;
+    }
+    result.t = difference / std::sqrt(v1 + v2);
+    result.df = (v1 + v2) * (v1 + v2) / (v1 * v1 / (n1 - 1) + v2 * v2 / (n2 - 1));
+    result.p_value = get_student_t_upper_tail(result.t, result.df);
+    return result;
+}
+
+} // namespace benchmark_stats
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <arrangement/EigenTypedef.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Protocol between arrangement_worker and its clients (POSIX only).
+ *
+ * Clients connect to the worker's Unix socket and send fixed-size JobRequest
+ * messages, one at a time, each answered by a JobReply.  Meshes do not go
+ * through the socket: the client writes its input to a POSIX shared memory
+ * segment and passes its name, the worker maps it, runs the job and writes
+ * the output to a new segment whose name is in the reply.  The client owns
+ * both segments afterwards and unlinks them.
+ *
+ * A segment holds a MeshHeader followed by the arrays of the mesh, each
+ * starting at a multiple of 8 bytes:
+ *   vertices  double[num_vertices][3]
+ *   faces     Index[num_faces][3]
+ *   labels    int[num_faces]
+ *   patches   int[num_faces]             (output only)
+ *   cells     Index[num_patches][2]      (output only)
+ * where Index is the scalar of arrangement::MatrixIr.
+ */
+namespace worker_protocol {
+
+using Index = arrangement::MatrixIr::Scalar;
+
+constexpr uint32_t s_magic = 0x4d525241; // "ARRM"
+constexpr uint32_t s_version = 1;
+
+struct MeshHeader
+{
+    uint32_t magic = s_magic;
+    uint32_t version = s_version;
+    /// sizeof(Index) of the writer, 4 or 8 depending on ARRANGEMENT_64BIT_INDEX.
+    uint32_t index_size = sizeof(Index);
+    uint32_t has_output = 0;
+    uint64_t num_vertices = 0;
+    uint64_t num_faces = 0;
+    uint64_t num_patches = 0;
+    uint64_t num_cells = 0;
+};
+
+struct JobRequest
+{
+    uint32_t magic = s_magic;
+    /// Threads used by the engine for this job, 0 for the worker default.
+    uint32_t num_threads = 0;
+    char engine[16] = {};
+    char input[64] = {};
+};
+
+enum class JobStatus : int32_t { Ok = 0, Error = 1, Busy = 2 };
+
+struct JobReply
+{
+    uint32_t magic = s_magic;
+    JobStatus status = JobStatus::Ok;
+    /// Time the request waited for a worker, and the engine run time, in seconds.
+    double queue_time = 0;
+    double run_time = 0;
+    char output[64] = {};
+    char error[256] = {};
+};
+
+/// Copy `str` into a fixed-size field, truncating it.
+template <size_t N>
+void set_field(char (&field)[N], const std::string& str)
+{
+    const size_t n = std::min(str.size(), N - 1);
+    std::memcpy(field, str.data(), n);
+    field[n] = '\0';
+}
+
+template <size_t N>
+std::string get_field(const char (&field)[N])
+{
+    return std::string(field, strnlen(field, N));
+}
+
+inline size_t align(size_t size)
+{
+    return (size + 7) / 8 * 8;
+}
+
+struct MeshLayout
+{
+    size_t vertices = 0;
+    size_t faces = 0;
+    size_t labels = 0;
+    size_t patches = 0;
+    size_t cells = 0;
+    size_t size = 0;
+};
+
+inline MeshLayout get_layout(const MeshHeader& header)
+{
+    MeshLayout layout;
+    layout.vertices = align(sizeof(MeshHeader));
+    layout.faces = layout.vertices + align(header.num_vertices * 3 * sizeof(double));
+    layout.labels = layout.faces + align(header.num_faces * 3 * sizeof(Index));
+    layout.patches = layout.labels + align(header.num_faces * sizeof(int));
+    layout.cells = layout.patches;
+    layout.size = layout.patches;
+    if (header.has_output) {
+        layout.cells = layout.patches + align(header.num_faces * sizeof(int));
+        layout.size = layout.cells + align(header.num_patches * 2 * sizeof(Index));
+    }
+    return layout;
+}
+
+inline std::string get_errno_message(const std::string& what)
+{
+    return what + ": " + std::strerror(errno);
+}
+
+/**
+ * A mapped POSIX shared memory segment.  The mapping is released on
+ * destruction, the name is only removed by unlink().
+ */
+class SharedMemory
+{
+public:
+    static SharedMemory create(const std::string& name, size_t size)
+    {
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error(get_errno_message("shm_open " + name));
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            const auto message = get_errno_message("ftruncate " + name);
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error(message);
+        }
+        return SharedMemory(name, fd, size, PROT_READ | PROT_WRITE);
+    }
+
+    static SharedMemory open(const std::string& name)
+    {
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) throw std::runtime_error(get_errno_message("shm_open " + name));
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            const auto message = get_errno_message("fstat " + name);
+            close(fd);
+            throw std::runtime_error(message);
+        }
+        return SharedMemory(name, fd, static_cast<size_t>(info.st_size), PROT_READ);
+    }
+
+    SharedMemory(SharedMemory&& other) noexcept
+        : m_name(std::move(other.m_name))
+        , m_data(other.m_data)
+        , m_size(other.m_size)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    SharedMemory& operator=(SharedMemory&&) = delete;
+    SharedMemory(const SharedMemory&) = delete;
+
+    ~SharedMemory()
+    {
+        if (m_data != nullptr) munmap(m_data, m_size);
+    }
+
+    void unlink() const { shm_unlink(m_name.c_str()); }
+
+    const std::string& name() const { return m_name; }
+    char* data() const { return static_cast<char*>(m_data); }
+    size_t size() const { return m_size; }
+
+private:
+    SharedMemory(std::string name, int fd, size_t size, int protection)
+        : m_name(std::move(name))
+        , m_size(size)
+    {
+        m_data = size == 0 ? nullptr : mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        close(fd);
+        if (m_data == MAP_FAILED) {
+            m_data = nullptr;
+            throw std::runtime_error(get_errno_message("mmap " + m_name));
+        }
+    }
+
+private:
+    std::string m_name;
+    void* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+/// Check the header of a segment and return it.
+inline MeshHeader read_header(const SharedMemory& memory)
+{
+    MeshHeader header;
+    if (memory.size() < sizeof(MeshHeader)) throw std::runtime_error("Truncated mesh buffer");
+    std::memcpy(&header, memory.data(), sizeof(MeshHeader));
+    if (header.magic != s_magic || header.version != s_version) {
+        throw std::runtime_error("Not a mesh buffer: " + memory.name());
+    }
+    if (header.index_size != sizeof(Index)) {
+        throw std::runtime_error("Mesh buffer index size mismatch (ARRANGEMENT_64BIT_INDEX)");
+    }
+    // Bound the counts first, so that the layout cannot overflow.
+    const size_t size = memory.size();
+    if (header.num_vertices > size / (3 * sizeof(double)) ||
+        header.num_faces > size / (3 * sizeof(Index)) ||
+        header.num_patches > size / (2 * sizeof(Index)) ||
+        get_layout(header).size > size) {
+        throw std::runtime_error("Truncated mesh buffer: " + memory.name());
+    }
+    return header;
+}
+
+template <typename T>
+void write_array(char* dst, const T* src, size_t count)
+{
+    if (count > 0) std::memcpy(dst, src, count * sizeof(T));
+}
+
+template <typename T>
+void read_array(T* dst, const char* src, size_t count)
+{
+    if (count > 0) std::memcpy(dst, src, count * sizeof(T));
+}
+
+/// Write an input mesh to a new segment.
+inline SharedMemory write_input(const std::string& name,
+    const arrangement::MatrixFr& vertices,
+    const arrangement::MatrixIr& faces,
+    const arrangement::VectorI& labels)
+{
+    MeshHeader header;
+    header.num_vertices = static_cast<uint64_t>(vertices.rows());
+    header.num_faces = static_cast<uint64_t>(faces.rows());
+    const auto layout = get_layout(header);
+    auto memory = SharedMemory::create(name, layout.size);
+    std::memcpy(memory.data(), &header, sizeof(MeshHeader));
+    write_array(memory.data() + layout.vertices, vertices.data(), vertices.size());
+    write_array(memory.data() + layout.faces, faces.data(), faces.size());
+    write_array(memory.data() + layout.labels, labels.data(), labels.size());
+    return memory;
+}
+
+/// Read an input mesh, throws if the buffer is malformed.
+inline void read_input(const SharedMemory& memory,
+    arrangement::MatrixFr& vertices,
+    arrangement::MatrixIr& faces,
+    arrangement::VectorI& labels)
+{
+    const auto header = read_header(memory);
+    const auto layout = get_layout(header);
+    vertices.resize(static_cast<Eigen::Index>(header.num_vertices), 3);
+    faces.resize(static_cast<Eigen::Index>(header.num_faces), 3);
+    labels.resize(static_cast<Eigen::Index>(header.num_faces));
+    read_array(vertices.data(), memory.data() + layout.vertices, vertices.size());
+    read_array(faces.data(), memory.data() + layout.faces, faces.size());
+    read_array(labels.data(), memory.data() + layout.labels, labels.size());
+    if (faces.size() > 0 &&
+        (faces.minCoeff() < 0 ||
+            static_cast<uint64_t>(faces.maxCoeff()) >= header.num_vertices)) {
+        throw std::runtime_error("Face index out of range in mesh buffer: " + memory.name());
+    }
+}
+
+/// Write to a new segment the output of an engine after run().
+template <typename Engine>
+SharedMemory write_output(const std::string& name, const Engine& engine)
+{
+    const auto& vertices = engine.get_vertices();
+    const auto& faces = engine.get_faces();
+    const auto& labels = engine.get_out_face_labels();
+    const auto& patches = engine.get_patches();
+    const auto& cells = engine.get_cells();
+
+    MeshHeader header;
+    header.has_output = 1;
+    header.num_vertices = static_cast<uint64_t>(vertices.rows());
+    header.num_faces = static_cast<uint64_t>(faces.rows());
+    header.num_patches = static_cast<uint64_t>(cells.rows());
+    header.num_cells = static_cast<uint64_t>(engine.get_num_cells());
+    const auto layout = get_layout(header);
+    auto memory = SharedMemory::create(name, layout.size);
+    std::memcpy(memory.data(), &header, sizeof(MeshHeader));
+    write_array(memory.data() + layout.vertices, vertices.data(), vertices.size());
+    write_array(memory.data() + layout.faces, faces.data(), faces.size());
+    write_array(memory.data() + layout.labels, labels.data(), labels.size());
+    write_array(memory.data() + layout.patches, patches.data(), patches.size());
+    write_array(memory.data() + layout.cells, cells.data(), cells.size());
+    return memory;
+}
+
+/// Write all of `size` bytes, false if the peer is gone.
+inline bool write_all(int fd, const void* data, size_t size)
+{
+    const char* ptr = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t n = ::write(fd, ptr, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        ptr += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/// Read all of `size` bytes, false on end of stream or error.
+inline bool read_all(int fd, void* data, size_t size)
+{
+    char* ptr = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t n = ::read(fd, ptr, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        ptr += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline sockaddr_un get_socket_address(const std::string& path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+inline int connect_to_worker(const std::string& path)
+{
+    const auto address = get_socket_address(path);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error(get_errno_message("socket"));
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        const auto message = get_errno_message("connect " + path);
+        close(fd);
+        throw std::runtime_error(message);
+    }
+    return fd;
+}
+
+} // namespace worker_protocol
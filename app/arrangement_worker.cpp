@@ -0,0 +1,356 @@
+#include <arrangement/Arrangement.h>
+#include <arrangement/EigenTypedef.h>
+#include <arrangement/EngineRegistry.h>
+
+#include "WorkerProtocol.h"
+
+#include <CLI/CLI.hpp>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+volatile std::sig_atomic_t s_stop = 0;
+
+void handle_signal(int)
+{
+    s_stop = 1;
+}
+
+std::vector<std::string> get_available_engines()
+{
+    std::vector<std::string> engines;
+    for (const std::string name : {"fast", "mesh", "geogram"}) {
+        if (arrangement::EngineRegistry::is_available(name)) engines.push_back(name);
+    }
+    return engines;
+}
+
+arrangement::Arrangement::Ptr create_engine(const std::string& name,
+    arrangement::MatrixFr vertices,
+    const arrangement::MatrixIr& faces,
+    const arrangement::VectorI& labels)
+{
+    auto engine =
+        name == "auto"
+            ? arrangement::Arrangement::create_auto_arrangement(std::move(vertices), faces, labels)
+            : arrangement::EngineRegistry::create(name, std::move(vertices), faces, labels);
+    if (engine == nullptr) {
+        throw std::runtime_error("Engine not available: " + name);
+    }
+    return engine;
+}
+
+using Clock = std::chrono::steady_clock;
+
+struct Connection
+{
+    int fd = -1;
+    Clock::time_point accepted;
+};
+
+/**
+ * Accepted connections waiting for a worker.  Bounded, so that a burst of
+ * clients is told the worker is busy instead of piling up.
+ */
+class ConnectionQueue
+{
+public:
+    explicit ConnectionQueue(size_t capacity)
+        : m_capacity(capacity)
+    {}
+
+    /// False if the queue is full or closed.
+    bool push(const Connection& connection)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_closed || m_connections.size() >= m_capacity) return false;
+            m_connections.push_back(connection);
+        }
+        m_condition.notify_one();
+        return true;
+    }
+
+    /// Wait for a connection, false once the queue is closed and drained.
+    bool pop(Connection& connection)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [&] { return m_closed || !m_connections.empty(); });
+        if (m_connections.empty()) return false;
+        connection = m_connections.front();
+        m_connections.pop_front();
+        return true;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_condition.notify_all();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Connection> m_connections;
+    size_t m_capacity = 0;
+    bool m_closed = false;
+};
+
+/**
+ * One thread of the pool.  Engines are created on first use and kept warm:
+ * later jobs for the same engine go through Arrangement::reset(), which
+ * keeps the engine's working buffers.
+ */
+class Worker
+{
+public:
+    Worker(size_t index, size_t num_threads)
+        : m_index(index)
+        , m_num_threads(num_threads)
+    {}
+
+    /**
+     * Run each engine once on a tet, so that the first job does not pay for
+     * one-time initializations (Geogram, TBB's thread pool, ...).
+     */
+    void warm_up(const std::vector<std::string>& engines)
+    {
+        arrangement::MatrixFr vertices(4, 3);
+        vertices << 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1;
+        arrangement::MatrixIr faces(4, 3);
+        faces << 0, 2, 1, 0, 1, 3, 0, 3, 2, 1, 2, 3;
+        arrangement::VectorI labels = arrangement::VectorI::Zero(4);
+        for (const auto& name : engines) {
+            try {
+                run(name, vertices, faces, labels, m_num_threads);
+            } catch (const std::exception& e) {
+                std::cerr << "Cannot warm up " << name << ": " << e.what() << std::endl;
+                m_engines.erase(name);
+            }
+        }
+    }
+
+    /// Serve the jobs of a client until it disconnects or the worker stops.
+    void serve(const Connection& connection)
+    {
+        double queue_time =
+            std::chrono::duration<double>(Clock::now() - connection.accepted).count();
+        while (!s_stop) {
+            struct pollfd pfd = {connection.fd, POLLIN, 0};
+            const int ready = poll(&pfd, 1, 250);
+            if (ready < 0 && errno != EINTR) break;
+            if (ready <= 0) continue;
+
+            worker_protocol::JobRequest request;
+            if (!worker_protocol::read_all(connection.fd, &request, sizeof(request))) break;
+            auto reply = run_job(request);
+            reply.queue_time = queue_time;
+            queue_time = 0;
+            if (!worker_protocol::write_all(connection.fd, &reply, sizeof(reply))) {
+                // The client is gone and will not unlink the output.
+                if (reply.status == worker_protocol::JobStatus::Ok) {
+                    shm_unlink(reply.output);
+                }
+                break;
+            }
+        }
+        close(connection.fd);
+    }
+
+    size_t get_num_jobs() const { return m_num_jobs; }
+
+private:
+    worker_protocol::JobReply run_job(const worker_protocol::JobRequest& request)
+    {
+        worker_protocol::JobReply reply;
+        const std::string name = worker_protocol::get_field(request.engine);
+        try {
+            if (request.magic != worker_protocol::s_magic) {
+                throw std::runtime_error("Bad request");
+            }
+            arrangement::MatrixFr vertices;
+            arrangement::MatrixIr faces;
+            arrangement::VectorI labels;
+            {
+                const auto input =
+                    worker_protocol::SharedMemory::open(worker_protocol::get_field(request.input));
+                worker_protocol::read_input(input, vertices, faces, labels);
+            }
+
+            const auto begin = Clock::now();
+            const auto& engine = run(name,
+                std::move(vertices),
+                faces,
+                labels,
+                request.num_threads > 0 ? request.num_threads : m_num_threads);
+            reply.run_time = std::chrono::duration<double>(Clock::now() - begin).count();
+
+            const std::string output = "/arrw-" + std::to_string(getpid()) + "-" +
+                                       std::to_string(m_index) + "-" +
+                                       std::to_string(m_num_jobs);
+            worker_protocol::write_output(output, *engine);
+            worker_protocol::set_field(reply.output, output);
+            m_num_jobs++;
+        } catch (const std::exception& e) {
+            // The engine may be left in any state, start afresh next time.
+            m_engines.erase(name);
+            reply.status = worker_protocol::JobStatus::Error;
+            worker_protocol::set_field(reply.error, e.what());
+        }
+        return reply;
+    }
+
+    /// Run `name` on the input with the warm engine, creating it if needed.
+    const arrangement::Arrangement::Ptr& run(const std::string& name,
+        arrangement::MatrixFr vertices,
+        const arrangement::MatrixIr& faces,
+        const arrangement::VectorI& labels,
+        size_t num_threads)
+    {
+        auto& engine = m_engines[name];
+        if (engine == nullptr) {
+            engine = create_engine(name, std::move(vertices), faces, labels);
+        } else {
+            engine->reset(std::move(vertices), faces, labels);
+        }
+        engine->set_num_threads(num_threads);
+        engine->run();
+        // Cells are computed on first access by some engines.
+        engine->get_num_cells();
+        return engine;
+    }
+
+private:
+    size_t m_index = 0;
+    size_t m_num_threads = 1;
+    size_t m_num_jobs = 0;
+    std::map<std::string, arrangement::Arrangement::Ptr> m_engines;
+};
+
+int listen_on(const std::string& path, size_t backlog)
+{
+    const auto address = worker_protocol::get_socket_address(path);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error(worker_protocol::get_errno_message("socket"));
+    // A stale socket file of a previous worker would make bind() fail.
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(fd, static_cast<int>(backlog)) != 0) {
+        const auto message = worker_protocol::get_errno_message("bind " + path);
+        close(fd);
+        throw std::runtime_error(message);
+    }
+    return fd;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    struct
+    {
+        std::string socket_path = "/tmp/arrangement_worker.sock";
+        size_t num_workers = std::max(1u, std::thread::hardware_concurrency());
+        size_t num_threads = 1;
+        size_t queue_size = 64;
+        std::vector<std::string> warm_engines = get_available_engines();
+    } args;
+
+    CLI::App app{"Serve arrangement jobs over a Unix socket with a pool of warm engines"};
+    app.add_option("--socket", args.socket_path, "Path of the Unix socket to listen on");
+    app.add_option("--workers", args.num_workers, "Number of jobs run concurrently")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--threads",
+        args.num_threads,
+        "Threads per job unless the request sets it (0 for all)");
+    app.add_option("--queue",
+        args.queue_size,
+        "Clients waiting for a worker beyond which new ones are turned away");
+    app.add_option("--warm",
+           args.warm_engines,
+           "Engines run once per worker at startup (fast, mesh, geogram, planar, auto)")
+        ->delimiter(',');
+    CLI11_PARSE(app, argc, argv);
+
+    struct sigaction action = {};
+    action.sa_handler = handle_signal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    int listen_fd = -1;
+    try {
+        listen_fd = listen_on(args.socket_path, args.queue_size);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // Warm up on this thread, one worker after the other: one-time
+    // initializations of the engines are not all thread-safe.
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (size_t i = 0; i < args.num_workers; i++) {
+        workers.push_back(std::make_unique<Worker>(i, args.num_threads));
+        workers.back()->warm_up(args.warm_engines);
+    }
+
+    ConnectionQueue queue(args.queue_size);
+    std::vector<std::thread> threads;
+    for (const auto& worker_ptr : workers) {
+        threads.emplace_back([&, worker = worker_ptr.get()] {
+            Connection connection;
+            while (queue.pop(connection)) worker->serve(connection);
+        });
+    }
+    std::cout << "Listening on " << args.socket_path << " with " << args.num_workers
+              << " workers" << std::endl;
+
+    while (!s_stop) {
+        struct pollfd pfd = {listen_fd, POLLIN, 0};
+        const int ready = poll(&pfd, 1, 250);
+        if (ready <= 0) continue;
+        const int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) continue;
+        if (!queue.push({fd, Clock::now()})) {
+            worker_protocol::JobReply reply;
+            reply.status = worker_protocol::JobStatus::Busy;
+            worker_protocol::set_field(reply.error, "All workers busy");
+            worker_protocol::write_all(fd, &reply, sizeof(reply));
+            close(fd);
+        }
+    }
+
+    queue.close();
+    close(listen_fd);
+    unlink(args.socket_path.c_str());
+    for (auto& thread : threads) thread.join();
+
+    size_t num_jobs = 0;
+    for (const auto& worker : workers) num_jobs += worker->get_num_jobs();
+    std::cout << "Served " << num_jobs << " jobs" << std::endl;
+    return 0;
+}
@@ -0,0 +1,675 @@
+#include <arrangement/Arrangement.h>
+#include <arrangement/EigenTypedef.h>
+#include <arrangement/EngineRegistry.h>
+
+#include "BenchmarkStats.h"
+
+#include <igl/read_triangle_mesh.h>
+
+#include <CLI/CLI.hpp>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// Outcome of one (input, engine) job.
+struct JobResult
+{
+    std::string input;
+    std::string engine;
+    /// "ok", "error", "timeout" or "crashed".
+    std::string status;
+    std::string error;
+    /// Engine picked by the auto engine.
+    std::string selected_engine;
+    /// Sizes, wall time, peak memory and per-stage values ("time.<stage>",
+    /// "memory.<stage>"), keyed by column name.
+    std::map<std::string, double> values;
+    /// Index of the repeated run of the whole corpus.
+    size_t repetition = 0;
+};
+
+/// Columns reported first, in this order.  Stage columns follow, sorted.
+const std::vector<std::string> s_base_columns = {"num_input_vertices",
+    "num_input_faces",
+    "num_output_vertices",
+    "num_output_faces",
+    "num_cells",
+    "wall_time",
+    "peak_rss_mb"};
+
+const std::vector<std::string> s_mesh_extensions = {".obj", ".off", ".ply", ".stl", ".mesh"};
+
+std::vector<std::string> get_available_engines()
+{
+    std::vector<std::string> engines;
+    for (const std::string name : {"fast", "mesh", "geogram"}) {
+        if (arrangement::EngineRegistry::is_available(name)) engines.push_back(name);
+    }
+    engines.push_back("auto");
+    return engines;
+}
+
+arrangement::Arrangement::Ptr create_engine(const std::string& name,
+    const arrangement::MatrixFr& vertices,
+    const arrangement::MatrixIr& faces,
+    const arrangement::VectorI& labels)
+{
+    auto engine = name == "auto"
+                      ? arrangement::Arrangement::create_auto_arrangement(vertices, faces, labels)
+                      : arrangement::EngineRegistry::create(name, vertices, faces, labels);
+    if (engine == nullptr) {
+        throw std::runtime_error("Engine not available: " + name);
+    }
+    return engine;
+}
+
+/// Keep a message on one line of the child's report.
+std::string flatten(std::string str)
+{
+    std::replace_if(str.begin(), str.end(), [](char c) { return c == '\n' || c == '\r'; }, ' ');
+    return str;
+}
+
+/**
+ * Body of the child process: read the mesh, run the engine and write the
+ * result to `out` as "key value" lines.  Returns the exit code.
+ */
+int run_job(const std::string& input, const std::string& engine_name, size_t num_threads, FILE* out)
+{
+    try {
+        arrangement::MatrixFr vertices;
+        arrangement::MatrixIr faces;
+        if (!igl::read_triangle_mesh(input, vertices, faces)) {
+            throw std::runtime_error("Cannot read mesh");
+        }
+        arrangement::VectorI labels = arrangement::VectorI::Zero(faces.rows());
+        std::fprintf(out, "num_input_vertices %zu\n", static_cast<size_t>(vertices.rows()));
+        std::fprintf(out, "num_input_faces %zu\n", static_cast<size_t>(faces.rows()));
+        std::fflush(out);
+
+        auto engine = create_engine(engine_name, vertices, faces, labels);
+        engine->set_num_threads(num_threads);
+        const auto begin = std::chrono::steady_clock::now();
+        engine->run();
+        // Cells are computed on first access by some engines, time them too.
+        const size_t num_cells = engine->get_num_cells();
+        const auto end = std::chrono::steady_clock::now();
+
+        const auto& metrics = engine->get_metrics();
+        std::fprintf(out, "wall_time %.9g\n", std::chrono::duration<double>(end - begin).count());
+        std::fprintf(out, "num_output_vertices %zu\n",
+            static_cast<size_t>(engine->get_vertices().rows()));
+        std::fprintf(
+            out, "num_output_faces %zu\n", static_cast<size_t>(engine->get_faces().rows()));
+        std::fprintf(out, "num_cells %zu\n", num_cells);
+        for (const auto& [stage, time] : metrics.timings) {
+            std::fprintf(out, "time.%s %.9g\n", stage.c_str(), time);
+        }
+        for (const auto& [stage, memory] : metrics.memory) {
+            std::fprintf(out, "memory.%s %.9g\n", stage.c_str(),
+                static_cast<double>(memory.peak_rss_delta) / (1 << 20));
+        }
+        auto itr = metrics.notes.find("engine");
+        if (itr != metrics.notes.end()) {
+            std::fprintf(out, "note.engine %s\n", flatten(itr->second).c_str());
+        }
+        std::fprintf(out, "status ok\n");
+        std::fflush(out);
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(out, "error %s\n", flatten(e.what()).c_str());
+    } catch (...) {
+        std::fprintf(out, "error Unknown exception\n");
+    }
+    std::fflush(out);
+    return 1;
+}
+
+/// Peak RSS of a terminated child in MB.
+double to_megabytes(const struct rusage& usage)
+{
+#ifdef __APPLE__
+    return static_cast<double>(usage.ru_maxrss) / (1 << 20); // Bytes
+#else
+    return static_cast<double>(usage.ru_maxrss) / (1 << 10); // Kilobytes
+#endif
+}
+
+/**
+ * Run one job in a forked process, killing it after `timeout` seconds (0 for
+ * no limit).  A crash or a kill of the child is reported, not propagated.
+ */
+JobResult run_isolated(
+    const std::string& input, const std::string& engine, size_t num_threads, double timeout)
+{
+    JobResult result{input, engine, "crashed", "", "", {}};
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error("pipe() failed");
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    const pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("fork() failed");
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        FILE* out = fdopen(fds[1], "w");
+        _exit(run_job(input, engine, num_threads, out));
+    }
+    close(fds[1]);
+
+    // Read the report until the child closes the pipe or the time is up.
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+    std::string report;
+    bool timed_out = false;
+    char buffer[4096];
+    while (true) {
+        int wait_ms = -1;
+        if (timeout > 0) {
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+            wait_ms = static_cast<int>(std::max<long long>(0,
+                std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count()));
+        }
+        struct pollfd pfd = {fds[0], POLLIN, 0};
+        const int ready = poll(&pfd, 1, wait_ms);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready == 0) {
+            timed_out = true;
+            kill(pid, SIGKILL);
+            break;
+        }
+        const ssize_t n = read(fds[0], buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        report.append(buffer, static_cast<size_t>(n));
+    }
+    close(fds[0]);
+
+    int status = 0;
+    struct rusage usage = {};
+    while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+    }
+    result.values["peak_rss_mb"] = to_megabytes(usage);
+
+    std::istringstream lines(report);
+    std::string line;
+    while (std::getline(lines, line)) {
+        const size_t split = line.find(' ');
+        if (split == std::string::npos) continue;
+        const std::string key = line.substr(0, split);
+        const std::string value = line.substr(split + 1);
+        if (key == "status") {
+            result.status = value;
+        } else if (key == "error") {
+            result.status = "error";
+            result.error = value;
+        } else if (key == "note.engine") {
+            result.selected_engine = value;
+        } else {
+            result.values[key] = std::stod(value);
+        }
+    }
+
+    if (timed_out) {
+        result.status = "timeout";
+        std::ostringstream message;
+        message << "Exceeded " << timeout << " s";
+        result.error = message.str();
+    } else if (WIFSIGNALED(status)) {
+        result.status = "crashed";
+        result.error = "Killed by signal " + std::to_string(WTERMSIG(status));
+    } else if (result.status == "crashed") {
+        result.error = "Exited with code " + std::to_string(WEXITSTATUS(status));
+    }
+    return result;
+}
+
+std::vector<std::string> collect_inputs(const std::string& directory)
+{
+    std::vector<std::string> inputs;
+    for (const auto& entry : fs::recursive_directory_iterator(directory)) {
+        if (!entry.is_regular_file()) continue;
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (std::find(s_mesh_extensions.begin(), s_mesh_extensions.end(), extension) !=
+            s_mesh_extensions.end()) {
+            inputs.push_back(entry.path().string());
+        }
+    }
+    std::sort(inputs.begin(), inputs.end());
+    return inputs;
+}
+
+std::vector<std::string> get_columns(const std::vector<JobResult>& results)
+{
+    std::vector<std::string> columns = s_base_columns;
+    std::set<std::string> stage_columns;
+    for (const auto& result : results) {
+        for (const auto& [key, value] : result.values) {
+            if (std::find(columns.begin(), columns.end(), key) == columns.end()) {
+                stage_columns.insert(key);
+            }
+        }
+    }
+    columns.insert(columns.end(), stage_columns.begin(), stage_columns.end());
+    return columns;
+}
+
+std::string escape_csv(const std::string& str)
+{
+    if (str.find_first_of(",\"\n") == std::string::npos) return str;
+    std::string result = "\"";
+    for (const char c : str) {
+        if (c == '"') result.push_back('"');
+        result.push_back(c);
+    }
+    return result + "\"";
+}
+
+std::string escape_json(const std::string& str)
+{
+    std::string result;
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            result.push_back('\\');
+            result.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+            result += buffer;
+        } else {
+            result.push_back(c);
+        }
+    }
+    return result;
+}
+
+void write_csv(const std::string& filename, const std::vector<JobResult>& results)
+{
+    std::ofstream out(filename);
+    if (!out) throw std::runtime_error("Cannot open " + filename);
+    const auto columns = get_columns(results);
+    out << "input,engine,repetition,status,error,selected_engine";
+    for (const auto& column : columns) out << "," << column;
+    out << "\n" << std::setprecision(9);
+    for (const auto& result : results) {
+        out << escape_csv(result.input) << "," << result.engine << "," << result.repetition << ","
+            << result.status << "," << escape_csv(result.error) << "," << result.selected_engine;
+        for (const auto& column : columns) {
+            out << ",";
+            auto itr = result.values.find(column);
+            if (itr != result.values.end()) out << itr->second;
+        }
+        out << "\n";
+    }
+}
+
+/// Split a line written by write_csv() into its fields.
+std::vector<std::string> split_csv(const std::string& line)
+{
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        const char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back().push_back('"');
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back().push_back(c);
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else {
+            fields.back().push_back(c);
+        }
+    }
+    return fields;
+}
+
+/// Read back a report written by write_csv(), e.g. a stored baseline.
+std::vector<JobResult> read_csv(const std::string& filename)
+{
+    std::ifstream in(filename);
+    if (!in) throw std::runtime_error("Cannot open " + filename);
+    std::string line;
+    std::getline(in, line);
+    const auto header = split_csv(line);
+    constexpr size_t num_text_columns = 6;
+    if (header.size() < num_text_columns || header[0] != "input" || header[2] != "repetition") {
+        throw std::runtime_error("Not a benchmark_corpus CSV report: " + filename);
+    }
+
+    std::vector<JobResult> results;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        const auto fields = split_csv(line);
+        if (fields.size() != header.size()) {
+            throw std::runtime_error("Malformed row in " + filename + ": " + line);
+        }
+        JobResult result{fields[0], fields[1], fields[3], fields[4], fields[5], {}};
+        result.repetition = std::stoul(fields[2]);
+        for (size_t i = num_text_columns; i < fields.size(); i++) {
+            if (!fields[i].empty()) result.values[header[i]] = std::stod(fields[i]);
+        }
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+/// Per-engine aggregate over all inputs.
+struct Summary
+{
+    size_t num_jobs = 0;
+    std::map<std::string, size_t> num_by_status;
+    /// Wall times and peak RSS of the successful jobs.
+    std::vector<double> wall_times;
+    double max_peak_rss_mb = 0;
+};
+
+std::map<std::string, Summary> summarize(const std::vector<JobResult>& results)
+{
+    std::map<std::string, Summary> summaries;
+    for (const auto& result : results) {
+        Summary& summary = summaries[result.engine];
+        summary.num_jobs++;
+        summary.num_by_status[result.status]++;
+        if (result.status != "ok") continue;
+        summary.wall_times.push_back(result.values.at("wall_time"));
+        summary.max_peak_rss_mb =
+            std::max(summary.max_peak_rss_mb, result.values.at("peak_rss_mb"));
+    }
+    for (auto& [engine, summary] : summaries) {
+        std::sort(summary.wall_times.begin(), summary.wall_times.end());
+    }
+    return summaries;
+}
+
+double get_total(const std::vector<double>& sorted)
+{
+    double total = 0;
+    for (const double value : sorted) total += value;
+    return total;
+}
+
+void write_json(const std::string& filename,
+    const std::vector<JobResult>& results,
+    const std::map<std::string, Summary>& summaries)
+{
+    std::ofstream out(filename);
+    if (!out) throw std::runtime_error("Cannot open " + filename);
+    out << std::setprecision(9) << "{\n\"jobs\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+        out << (i == 0 ? "" : ",") << "\n  {\"input\": \"" << escape_json(result.input)
+            << "\", \"engine\": \"" << result.engine
+            << "\", \"repetition\": " << result.repetition << ", \"status\": \"" << result.status
+            << "\", \"error\": \"" << escape_json(result.error) << "\"";
+        if (!result.selected_engine.empty()) {
+            out << ", \"selected_engine\": \"" << result.selected_engine << "\"";
+        }
+        for (const auto& [key, value] : result.values) {
+            out << ", \"" << key << "\": " << value;
+        }
+        out << "}";
+    }
+    out << "\n],\n\"summary\": {";
+    bool first = true;
+    for (const auto& [engine, summary] : summaries) {
+        out << (first ? "" : ",") << "\n  \"" << engine << "\": {\"num_jobs\": "
+            << summary.num_jobs;
+        for (const auto& [status, count] : summary.num_by_status) {
+            out << ", \"num_" << status << "\": " << count;
+        }
+        out << ", \"total_time\": " << get_total(summary.wall_times)
+            << ", \"median_time\": " << benchmark_stats::get_percentile(summary.wall_times, 0.5)
+            << ", \"p90_time\": " << benchmark_stats::get_percentile(summary.wall_times, 0.9)
+            << ", \"max_peak_rss_mb\": " << summary.max_peak_rss_mb << "}";
+        first = false;
+    }
+    out << "\n}\n}\n";
+}
+
+void print_summary(const std::map<std::string, Summary>& summaries)
+{
+    std::cout << std::left << std::setw(10) << "engine" << std::right << std::setw(8) << "jobs"
+              << std::setw(8) << "ok" << std::setw(8) << "error" << std::setw(9) << "timeout"
+              << std::setw(9) << "crashed" << std::setw(12) << "total (s)" << std::setw(12)
+              << "median (s)" << std::setw(12) << "p90 (s)" << std::setw(14) << "peak RSS (MB)"
+              << "\n";
+    for (const auto& [engine, summary] : summaries) {
+        auto count = [&](const std::string& status) {
+            auto itr = summary.num_by_status.find(status);
+            return itr == summary.num_by_status.end() ? size_t(0) : itr->second;
+        };
+        std::cout << std::left << std::setw(10) << engine << std::right << std::setw(8)
+                  << summary.num_jobs << std::setw(8) << count("ok") << std::setw(8)
+                  << count("error") << std::setw(9) << count("timeout") << std::setw(9)
+                  << count("crashed") << std::setprecision(4) << std::setw(12)
+                  << get_total(summary.wall_times) << std::setw(12)
+                  << benchmark_stats::get_percentile(summary.wall_times, 0.5) << std::setw(12)
+                  << benchmark_stats::get_percentile(summary.wall_times, 0.9) << std::setw(14)
+                  << summary.max_peak_rss_mb << "\n";
+    }
+}
+
+/// Inputs on which every run of `engine` succeeded.
+std::set<std::string> get_successful_inputs(
+    const std::vector<JobResult>& results, const std::string& engine)
+{
+    std::set<std::string> inputs;
+    std::set<std::string> failed;
+    for (const auto& result : results) {
+        if (result.engine != engine) continue;
+        (result.status == "ok" ? inputs : failed).insert(result.input);
+    }
+    for (const auto& input : failed) inputs.erase(input);
+    return inputs;
+}
+
+/**
+ * Time of each stage (and of the whole job, as "wall_time") summed over
+ * `inputs`, one sample per repetition of the corpus.
+ */
+std::map<std::string, std::vector<double>> get_stage_samples(const std::vector<JobResult>& results,
+    const std::string& engine,
+    const std::set<std::string>& inputs)
+{
+    std::map<std::string, std::map<size_t, double>> totals;
+    for (const auto& result : results) {
+        if (result.engine != engine || inputs.count(result.input) == 0) continue;
+        for (const auto& [key, value] : result.values) {
+            if (key == "wall_time" || key.rfind("time.", 0) == 0) {
+                totals[key][result.repetition] += value;
+            }
+        }
+    }
+    std::map<std::string, std::vector<double>> samples;
+    for (const auto& [stage, per_repetition] : totals) {
+        for (const auto& [repetition, total] : per_repetition) {
+            samples[stage].push_back(total);
+        }
+    }
+    return samples;
+}
+
+/**
+ * Compare the stage times of each engine against a baseline report, on the
+ * inputs that succeeded in both.  A stage regresses if its mean time grew by
+ * more than `threshold` (relative) and, with at least 2 repetitions on both
+ * sides, Welch's t-test rejects "not slower" at level `alpha`.
+ *
+ * @return Whether any stage regressed.
+ */
+bool compare_to_baseline(const std::vector<JobResult>& baseline,
+    const std::vector<JobResult>& results,
+    double threshold,
+    double alpha)
+{
+    std::set<std::string> engines;
+    for (const auto& result : results) engines.insert(result.engine);
+
+    bool regressed = false;
+    std::cout << "\n"
+              << std::left << std::setw(10) << "engine" << std::setw(28) << "stage" << std::right
+              << std::setw(14) << "baseline (s)" << std::setw(14) << "current (s)"
+              << std::setw(10) << "change" << std::setw(10) << "p-value"
+              << "  verdict\n";
+    for (const auto& engine : engines) {
+        std::set<std::string> inputs;
+        const auto baseline_inputs = get_successful_inputs(baseline, engine);
+        const auto current_inputs = get_successful_inputs(results, engine);
+        std::set_intersection(baseline_inputs.begin(),
+            baseline_inputs.end(),
+            current_inputs.begin(),
+            current_inputs.end(),
+            std::inserter(inputs, inputs.begin()));
+        if (inputs.empty()) {
+            std::cout << std::left << std::setw(10) << engine << "no input succeeded in both\n";
+            continue;
+        }
+
+        const auto reference = get_stage_samples(baseline, engine, inputs);
+        const auto candidate = get_stage_samples(results, engine, inputs);
+        for (const auto& [stage, samples] : candidate) {
+            auto itr = reference.find(stage);
+            if (itr == reference.end()) continue;
+            const double reference_mean = benchmark_stats::get_mean(itr->second);
+            const double candidate_mean = benchmark_stats::get_mean(samples);
+            const double change =
+                reference_mean > 0 ? candidate_mean / reference_mean - 1 : 0.0;
+            const auto test = benchmark_stats::welch_t_test(itr->second, samples);
+            // Without enough samples for the test, the threshold alone decides.
+            const bool untested = std::isnan(test.p_value);
+
+            std::string verdict = "";
+            if (change > threshold && (untested || test.p_value < alpha)) {
+                verdict = "REGRESSION";
+                regressed = true;
+            } else if (change < -threshold && (untested || 1 - test.p_value < alpha)) {
+                verdict = "improvement";
+            }
+            std::cout << std::left << std::setw(10) << engine << std::setw(28) << stage
+                      << std::right << std::setprecision(4) << std::setw(14) << reference_mean
+                      << std::setw(14) << candidate_mean << std::setw(9) << change * 100 << "%"
+                      << std::setw(10) << test.p_value << "  " << verdict << "\n";
+        }
+    }
+    return regressed;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    struct
+    {
+        std::string input_dir;
+        std::vector<std::string> engines = get_available_engines();
+        double timeout = 300;
+        size_t num_threads = 0;
+        size_t max_inputs = 0;
+        std::string csv_file;
+        std::string json_file;
+        size_t num_repetitions = 1;
+        std::string baseline_file;
+        double threshold = 0.05;
+        double alpha = 0.01;
+    } args;
+
+    CLI::App app{"Run every engine on a directory of meshes, one process per job"};
+    app.add_option("input_dir", args.input_dir, "Directory searched recursively for meshes")
+        ->required()
+        ->check(CLI::ExistingDirectory);
+    app.add_option("--engines", args.engines, "Engines to run (fast, mesh, geogram, planar, auto)")
+        ->delimiter(',');
+    app.add_option("--timeout", args.timeout, "Time limit per job in seconds (0 for none)");
+    app.add_option("--threads", args.num_threads, "Maximum number of threads (0 for all)");
+    app.add_option("--max-inputs", args.max_inputs, "Only run the first inputs (0 for all)");
+    app.add_option("--csv", args.csv_file, "Write one row per job to this CSV file");
+    app.add_option("--json", args.json_file, "Write the jobs and summary to this JSON file");
+    app.add_option("--repeat",
+        args.num_repetitions,
+        "Run the whole corpus this many times, for the baseline comparison");
+    app.add_option("--baseline",
+        args.baseline_file,
+        "CSV report of a previous run to compare with; exit with 1 on regression");
+    app.add_option("--threshold",
+        args.threshold,
+        "Relative slowdown of a stage above which it can be a regression");
+    app.add_option("--alpha", args.alpha, "Significance level of the Welch's t-test");
+    CLI11_PARSE(app, argc, argv);
+
+    // Read the baseline first to fail early.
+    std::vector<JobResult> baseline;
+    if (!args.baseline_file.empty()) {
+        baseline = read_csv(args.baseline_file);
+    }
+
+    auto inputs = collect_inputs(args.input_dir);
+    if (args.max_inputs > 0 && inputs.size() > args.max_inputs) {
+        inputs.resize(args.max_inputs);
+    }
+
+    std::vector<JobResult> results;
+    for (size_t r = 0; r < args.num_repetitions; r++) {
+        for (size_t i = 0; i < inputs.size(); i++) {
+            for (const auto& engine : args.engines) {
+                auto result = run_isolated(inputs[i], engine, args.num_threads, args.timeout);
+                result.repetition = r;
+                std::cout << "[" << (i + 1) << "/" << inputs.size() << "] " << engine << " "
+                          << inputs[i] << ": " << result.status;
+                if (result.status == "ok") {
+                    std::cout << " " << result.values["wall_time"] << " s";
+                } else {
+                    std::cout << " (" << result.error << ")";
+                }
+                std::cout << std::endl;
+                results.push_back(std::move(result));
+            }
+        }
+    }
+
+    const auto summaries = summarize(results);
+    print_summary(summaries);
+    if (!args.csv_file.empty()) write_csv(args.csv_file, results);
+    if (!args.json_file.empty()) write_json(args.json_file, results, summaries);
+    if (!args.baseline_file.empty() &&
+        compare_to_baseline(baseline, results, args.threshold, args.alpha)) {
+        return 1;
+    }
+    return 0;
+}
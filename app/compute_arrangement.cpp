@@ -1,5 +1,7 @@
 #include <arrangement/Arrangement.h>
+#include <arrangement/AutoArrangement.h>
 #include <arrangement/EigenTypedef.h>
+#include <arrangement/Trace.h>
 
 #include <igl/read_triangle_mesh.h>
 #include <igl/write_triangle_mesh.h>
@@ -16,19 +18,46 @@ int main(int argc, char** argv)
         std::string engine = "fast";
         std::string input_mesh;
         std::string output_mesh;
+        size_t num_threads = 0;
+        double timeout = 0;
+        std::string kernel = "epeck";
+        double grid_size = -1;
+        bool merge_coplanar = false;
+        std::string trace_file;
     } args;
 
     CLI::App app{"Compute arrangement"};
-    app.add_option("--engine", args.engine, "Engine to use (fast, mesh)");
+    app.add_option("--engine", args.engine, "Engine to use (fast, mesh, planar, auto)");
+    app.add_option("--threads", args.num_threads, "Maximum number of threads (0 for all)");
+    app.add_option(
+        "--timeout", args.timeout, "Time limit per attempt of the auto engine in seconds");
+    app.add_option("--kernel",
+        args.kernel,
+        "Kernel of the mesh engine (epeck, rational, gmpq, boost_rational, leda)");
+    app.add_option("--grid-size",
+        args.grid_size,
+        "Quantize the input to a grid of this spacing (0 to pick one, fast engine only)");
+    app.add_flag("--merge-coplanar", args.merge_coplanar, "Merge coplanar output faces");
+    app.add_option("--trace",
+        args.trace_file,
+        "Write a Chrome trace-event JSON file of the run (requires ARRANGEMENT_WITH_TRACE)");
     app.add_option("input_mesh", args.input_mesh, "Input mesh file")->required();
     app.add_option("output_mesh", args.output_mesh, "Output mesh file")->required();
     CLI11_PARSE(app, argc, argv);
 
+    if (!args.trace_file.empty()) {
+        arrangement::Trace::start();
+        arrangement::Trace::set_thread_name("main");
+    }
+
     arrangement::MatrixFr vertices;
     arrangement::MatrixIr faces;
     arrangement::VectorI face_labels;
 
-    igl::read_triangle_mesh(args.input_mesh, vertices, faces);
+    {
+        ARRANGEMENT_TRACE_SCOPE("read_mesh");
+        igl::read_triangle_mesh(args.input_mesh, vertices, faces);
+    }
     face_labels.resize(faces.rows());
     face_labels.setZero();
 
@@ -38,7 +67,30 @@ int main(int argc, char** argv)
     if (args.engine == "fast") {
         engine = arrangement::Arrangement::create_fast_arrangement(vertices, faces, face_labels);
     } else if (args.engine == "mesh") {
-        engine = arrangement::Arrangement::create_mesh_arrangement(vertices, faces, face_labels);
+        arrangement::MeshKernel kernel = arrangement::MeshKernel::Epeck;
+        bool found = false;
+        for (auto k : {arrangement::MeshKernel::Epeck,
+                 arrangement::MeshKernel::Rational,
+                 arrangement::MeshKernel::Gmpq,
+                 arrangement::MeshKernel::BoostRational,
+                 arrangement::MeshKernel::Leda}) {
+            if (args.kernel == arrangement::get_mesh_kernel_name(k)) {
+                kernel = k;
+                found = true;
+            }
+        }
+        if (!found) {
+            throw std::runtime_error("Unknown kernel: " + args.kernel);
+        }
+        engine = arrangement::Arrangement::create_mesh_arrangement(
+            vertices, faces, face_labels, arrangement::RegionOfInterest(), kernel);
+    } else if (args.engine == "planar") {
+        engine = arrangement::Arrangement::create_planar_arrangement(vertices, faces, face_labels);
+    } else if (args.engine == "auto") {
+        auto auto_engine =
+            std::make_shared<arrangement::AutoArrangement>(vertices, faces, face_labels);
+        auto_engine->set_timeout(args.timeout);
+        engine = auto_engine;
     } else {
         throw std::runtime_error("Unknown engine: " + args.engine);
     }
@@ -46,17 +98,29 @@ int main(int argc, char** argv)
         throw std::runtime_error("Failed to create arrangement engine");
     }
 
+    engine->set_num_threads(args.num_threads);
+    engine->set_merge_coplanar(args.merge_coplanar);
+    if (args.grid_size >= 0) {
+        engine->set_quantization(true, args.grid_size);
+    }
     engine->run();
 
     const auto& V = engine->get_vertices();
     const auto& F = engine->get_faces();
 
-    igl::write_triangle_mesh(args.output_mesh, V, F);
+    {
+        ARRANGEMENT_TRACE_SCOPE("write_meshes");
+        igl::write_triangle_mesh(args.output_mesh, V, F);
+
+        for (size_t i = 0; i < engine->get_num_cells(); i++) {
+            std::string cell_mesh_file = output_basename + "_cell_" + std::to_string(i) + ".obj";
+            const auto cell_faces = engine->get_cell_faces(i);
+            igl::write_triangle_mesh(cell_mesh_file, V, cell_faces);
+        }
+    }
 
-    for (size_t i = 0; i < engine->get_num_cells(); i++) {
-        std::string cell_mesh_file = output_basename + "_cell_" + std::to_string(i) + ".obj";
-        const auto cell_faces = engine->get_cell_faces(i);
-        igl::write_triangle_mesh(cell_mesh_file, V, cell_faces);
+    if (!args.trace_file.empty()) {
+        arrangement::Trace::stop(args.trace_file);
     }
 
     return 0;
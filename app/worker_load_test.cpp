@@ -0,0 +1,221 @@
+#include <arrangement/EigenTypedef.h>
+
+#include "BenchmarkStats.h"
+#include "WorkerProtocol.h"
+
+#include <igl/read_triangle_mesh.h>
+
+#include <CLI/CLI.hpp>
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Measurements of one client thread.
+struct ClientResult
+{
+    std::vector<double> latencies;
+    std::vector<double> run_times;
+    /// Longest time a connection waited for a free worker.
+    double max_queue_time = 0;
+    size_t num_errors = 0;
+    size_t num_busy = 0;
+    std::string first_error;
+};
+
+/**
+ * Send `num_warmup + num_jobs` jobs one after the other over one connection,
+ * cycling through the inputs.  Only the last `num_jobs` are measured.
+ */
+ClientResult run_client(const std::string& socket_path,
+    const std::vector<std::string>& inputs,
+    const std::string& engine,
+    size_t num_threads,
+    size_t client_index,
+    size_t num_warmup,
+    size_t num_jobs)
+{
+    ClientResult result;
+    auto fail = [&](const std::string& error) {
+        result.num_errors++;
+        if (result.first_error.empty()) result.first_error = error;
+    };
+
+    int fd = -1;
+    try {
+        fd = worker_protocol::connect_to_worker(socket_path);
+    } catch (const std::exception& e) {
+        fail(e.what());
+        return result;
+    }
+
+    for (size_t j = 0; j < num_warmup + num_jobs; j++) {
+        worker_protocol::JobRequest request;
+        request.num_threads = static_cast<uint32_t>(num_threads);
+        worker_protocol::set_field(request.engine, engine);
+        worker_protocol::set_field(request.input, inputs[(client_index + j) % inputs.size()]);
+
+        const auto begin = Clock::now();
+        worker_protocol::JobReply reply;
+        // A worker turning the client away replies without reading the
+        // request, so read the reply even if sending failed.
+        worker_protocol::write_all(fd, &request, sizeof(request));
+        if (!worker_protocol::read_all(fd, &reply, sizeof(reply))) {
+            fail("Connection lost");
+            break;
+        }
+        result.max_queue_time = std::max(result.max_queue_time, reply.queue_time);
+        if (reply.status == worker_protocol::JobStatus::Busy) {
+            result.num_busy++;
+            break;
+        }
+        if (reply.status != worker_protocol::JobStatus::Ok) {
+            if (j >= num_warmup) fail(worker_protocol::get_field(reply.error));
+            continue;
+        }
+        try {
+            // Read the output like a real client would, then drop it.
+            const auto output =
+                worker_protocol::SharedMemory::open(worker_protocol::get_field(reply.output));
+            output.unlink();
+            worker_protocol::read_header(output);
+        } catch (const std::exception& e) {
+            fail(e.what());
+            continue;
+        }
+        const auto end = Clock::now();
+        if (j >= num_warmup) {
+            result.latencies.push_back(std::chrono::duration<double>(end - begin).count());
+            result.run_times.push_back(reply.run_time);
+        }
+    }
+    close(fd);
+    return result;
+}
+
+void append(std::vector<double>& a, const std::vector<double>& b)
+{
+    a.insert(a.end(), b.begin(), b.end());
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    struct
+    {
+        std::vector<std::string> inputs;
+        std::string socket_path = "/tmp/arrangement_worker.sock";
+        std::string engine = "auto";
+        size_t num_clients = 4;
+        size_t num_jobs = 100;
+        size_t num_warmup = 2;
+        size_t num_threads = 0;
+    } args;
+
+    CLI::App app{"Measure the throughput and latency of an arrangement_worker"};
+    app.add_option("inputs", args.inputs, "Input meshes, sent in turn")
+        ->required()
+        ->check(CLI::ExistingFile);
+    app.add_option("--socket", args.socket_path, "Unix socket of the worker");
+    app.add_option("--engine", args.engine, "Engine to run (fast, mesh, geogram, planar, auto)");
+    app.add_option("--clients", args.num_clients, "Number of concurrent clients")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--jobs", args.num_jobs, "Measured jobs per client");
+    app.add_option("--warmup", args.num_warmup, "Unmeasured jobs per client sent first");
+    app.add_option("--threads",
+        args.num_threads,
+        "Threads per job (0 for the worker's default)");
+    CLI11_PARSE(app, argc, argv);
+    signal(SIGPIPE, SIG_IGN);
+
+    // Each input is written to shared memory once and read by every job that
+    // uses it, so that the measure is the worker's, not the client's I/O.
+    std::vector<worker_protocol::SharedMemory> segments;
+    std::vector<std::string> names;
+    try {
+        for (size_t i = 0; i < args.inputs.size(); i++) {
+            arrangement::MatrixFr vertices;
+            arrangement::MatrixIr faces;
+            if (!igl::read_triangle_mesh(args.inputs[i], vertices, faces)) {
+                throw std::runtime_error("Cannot read mesh " + args.inputs[i]);
+            }
+            arrangement::VectorI labels = arrangement::VectorI::Zero(faces.rows());
+            const std::string name =
+                "/arrc-" + std::to_string(getpid()) + "-" + std::to_string(i);
+            segments.push_back(worker_protocol::write_input(name, vertices, faces, labels));
+            names.push_back(name);
+        }
+    } catch (const std::exception& e) {
+        for (const auto& segment : segments) segment.unlink();
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<ClientResult> results(args.num_clients);
+    std::vector<std::thread> clients;
+    const auto begin = Clock::now();
+    for (size_t c = 0; c < args.num_clients; c++) {
+        clients.emplace_back([&, c] {
+            results[c] = run_client(args.socket_path,
+                names,
+                args.engine,
+                args.num_threads,
+                c,
+                args.num_warmup,
+                args.num_jobs);
+        });
+    }
+    for (auto& client : clients) client.join();
+    const double wall_time = std::chrono::duration<double>(Clock::now() - begin).count();
+    for (const auto& segment : segments) segment.unlink();
+
+    ClientResult total;
+    for (const auto& result : results) {
+        append(total.latencies, result.latencies);
+        append(total.run_times, result.run_times);
+        total.max_queue_time = std::max(total.max_queue_time, result.max_queue_time);
+        total.num_errors += result.num_errors;
+        total.num_busy += result.num_busy;
+        if (total.first_error.empty()) total.first_error = result.first_error;
+    }
+    std::sort(total.latencies.begin(), total.latencies.end());
+
+    // Warm-up jobs are included in the wall time, so the throughput is a
+    // lower bound when they are many.
+    const auto ms = [](double seconds) { return seconds * 1000; };
+    const size_t num_jobs = total.latencies.size();
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "jobs:          " << num_jobs << " ok, " << total.num_errors << " failed, "
+              << total.num_busy << " clients turned away" << std::endl;
+    std::cout << "throughput:    " << static_cast<double>(num_jobs) / wall_time << " jobs/s"
+              << std::endl;
+    std::cout << "latency (ms):  mean " << ms(benchmark_stats::get_mean(total.latencies))
+              << "  p50 " << ms(benchmark_stats::get_percentile(total.latencies, 0.5)) << "  p90 "
+              << ms(benchmark_stats::get_percentile(total.latencies, 0.9)) << "  p99 "
+              << ms(benchmark_stats::get_percentile(total.latencies, 0.99)) << "  max "
+              << ms(total.latencies.empty() ? 0 : total.latencies.back()) << std::endl;
+    const double run_time = benchmark_stats::get_mean(total.run_times);
+    std::cout << "run time (ms): mean " << ms(run_time) << "  overhead "
+              << ms(benchmark_stats::get_mean(total.latencies) - run_time)
+              << "  max wait for a worker "
+              << ms(total.max_queue_time)
+              << std::endl;
+    if (!total.first_error.empty()) {
+        std::cout << "first error:   " << total.first_error << std::endl;
+    }
+    return total.num_errors > 0 ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+
+#include "EigenTypedef.h"
+
+namespace arrangement {
+
+/**
+ * Bounding volume hierarchy over the triangles of a mesh.
+ *
+ * The tree stores a copy of the triangle bounding boxes only; the vertex and
+ * face matrices passed to the constructor must outlive the tree.
+ */
+class AABBTree
+{
+public:
+    struct RayHit
+    {
+        Index face = -1; ///< Index of the first face hit, -1 if nothing is hit.
+        Float t = 0; ///< Ray parameter of the hit point.
+        bool ambiguous = false; ///< Hit is too close to an edge, a vertex or another hit.
+    };
+
+public:
+    AABBTree() = default;
+
+    /**
+     * @brief Build the tree.
+     *
+     * @param vertices MatrixFr of size #vertices by 3.
+     * @param faces MatrixIr of size #faces by 3.
+     */
+    AABBTree(const MatrixFr& vertices, const MatrixIr& faces);
+
+    /**
+     * @brief Find the first face hit by the ray origin + t * direction, t > 0.
+     *
+     * The hit is flagged as ambiguous when the ray passes within numerical
+     * tolerance of a face boundary, is nearly parallel to the hit face, starts
+     * on a face, or when another face is hit at nearly the same t.
+     */
+    RayHit intersect_ray(const Vector3F& origin, const Vector3F& direction) const;
+
+    /**
+     * @brief Collect all faces whose bounding box overlaps the given box.
+     */
+    void query_box(
+        const Vector3F& box_min, const Vector3F& box_max, std::vector<Index>& faces) const;
+
+    /**
+     * @brief Get the number of faces in the tree.
+     */
+    size_t get_num_faces() const { return m_face_indices.size(); }
+
+private:
+    struct Node
+    {
+        Vector3F box_min;
+        Vector3F box_max;
+        Index left = -1; ///< Index of the left child, -1 for leaves.
+        Index right = -1; ///< Index of the right child, -1 for leaves.
+        Index begin = 0; ///< First entry of m_face_indices covered by this node.
+        Index end = 0; ///< One past the last entry of m_face_indices covered by this node.
+    };
+
+    Index build(Index begin, Index end);
+
+private:
+    const MatrixFr* m_vertices = nullptr;
+    const MatrixIr* m_faces = nullptr;
+    std::vector<Node> m_nodes;
+    std::vector<Index> m_face_indices;
+    Matrix3Fr m_face_box_min;
+    Matrix3Fr m_face_box_max;
+};
+
+} // namespace arrangement
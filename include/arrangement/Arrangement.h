@@ -1,31 +1,215 @@
 #pragma once
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #include "EigenTypedef.h"
+#include "IntersectionCurves.h"
+#include "Metrics.h"
+#include "OutputSink.h"
+#include "Part.h"
 
 namespace arrangement {
 
+/**
+ * Boolean operations supported by Arrangement::extract_boolean().
+ *
+ * A point is inside a label group if its winding number with respect to that
+ * group is positive.
+ */
+enum class BooleanOperation {
+    Union, ///< Inside at least one group.
+    Intersection, ///< Inside all groups.
+    Difference, ///< Inside group 0 and outside all other groups.
+    SymmetricDifference ///< Inside an odd number of groups.
+};
+
+/**
+ * Predicate over the per-group winding numbers of a cell.  Returns true if the
+ * cell should be part of the extracted region.
+ */
+using WindingNumberPredicate = std::function<bool(const VectorI&)>;
+
+/**
+ * Topology stages computed after self-intersections are resolved.  Stages can
+ * be combined into a bit mask.  Each stage depends on the previous ones.
+ */
+enum TopologyStage : unsigned {
+    TOPOLOGY_NONE = 0,
+    TOPOLOGY_PATCHES = 1u << 0, ///< get_patches(), get_num_patches()
+    TOPOLOGY_CELLS = 1u << 1, ///< get_cells(), get_num_cells(), get_cell_faces()
+    TOPOLOGY_WINDING_NUMBERS = 1u << 2, ///< get_winding_number()
+    TOPOLOGY_ALL = TOPOLOGY_PATCHES | TOPOLOGY_CELLS | TOPOLOGY_WINDING_NUMBERS
+};
+
+/**
+ * Kernels the mesh engine can resolve self-intersections with.  Kernels
+ * whose number type is not available in the build are rejected at run time,
+ * see MeshArrangement::is_kernel_available().
+ */
+enum class MeshKernel {
+    Epeck, ///< CGAL::Epeck: lazy exact constructions with interval filters (default).
+    Rational, ///< Non-lazy Cartesian kernel over CGAL::Exact_rational.
+    Gmpq, ///< Non-lazy Cartesian kernel over CGAL::Gmpq (requires GMP).
+    BoostRational, ///< Non-lazy Cartesian kernel over boost::multiprecision::cpp_rational.
+    Leda ///< Non-lazy Cartesian kernel over leda_rational (requires LEDA).
+};
+
+/**
+ * Name of a mesh kernel, e.g. for reports.
+ */
+inline const char* get_mesh_kernel_name(MeshKernel kernel)
+{
+    switch (kernel) {
+    case MeshKernel::Epeck: return "epeck";
+    case MeshKernel::Rational: return "rational";
+    case MeshKernel::Gmpq: return "gmpq";
+    case MeshKernel::BoostRational: return "boost_rational";
+    case MeshKernel::Leda: return "leda";
+    default: return "unknown";
+    }
+}
+
+/**
+ * Region of interest restricting where self-intersections are resolved.
+ *
+ * A face belongs to the region if it is selected by the face mask, or, when
+ * no mask is given, if its bounding box overlaps the region box.  An empty
+ * region (the default) covers the whole input.
+ */
+struct RegionOfInterest
+{
+    Vector3F box_min = Vector3F::Zero();
+    Vector3F box_max = Vector3F::Zero();
+    bool use_box = false;
+    VectorI face_mask; ///< #faces entries, non-zero for faces in the region.
+
+    static RegionOfInterest from_box(const Vector3F& box_min, const Vector3F& box_max)
+    {
+        RegionOfInterest roi;
+        roi.box_min = box_min;
+        roi.box_max = box_max;
+        roi.use_box = true;
+        return roi;
+    }
+
+    static RegionOfInterest from_face_mask(const VectorI& face_mask)
+    {
+        RegionOfInterest roi;
+        roi.face_mask = face_mask;
+        return roi;
+    }
+
+    bool empty() const { return !use_box && face_mask.size() == 0; }
+};
+
 class Arrangement
 {
 public:
     typedef std::shared_ptr<Arrangement> Ptr;
-    static Ptr create_mesh_arrangement(
-        const MatrixFr& vertices, const MatrixIr& faces, const VectorI& face_labels);
-    static Ptr create_fast_arrangement(
-        const MatrixFr& vertices, const MatrixIr& faces, const VectorI& face_labels);
-    static Ptr create_geogram_arrangement(
-        const MatrixFr& vertices, const MatrixIr& faces, const VectorI& face_labels);
+    static Ptr create_mesh_arrangement(MatrixFr vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        const RegionOfInterest& region_of_interest = RegionOfInterest(),
+        MeshKernel kernel = MeshKernel::Epeck);
+    static Ptr create_fast_arrangement(MatrixFr vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        const RegionOfInterest& region_of_interest = RegionOfInterest());
+    static Ptr create_geogram_arrangement(MatrixFr vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        const RegionOfInterest& region_of_interest = RegionOfInterest());
+    static Ptr create_auto_arrangement(MatrixFr vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        const RegionOfInterest& region_of_interest = RegionOfInterest());
+    static Ptr create_planar_arrangement(
+        MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels);
+
+    // Multi-part input, see Part.  The transformed vertices of the parts are
+    // written directly into the engine input.
+    static Ptr create_mesh_arrangement(const std::vector<Part>& parts,
+        const RegionOfInterest& region_of_interest = RegionOfInterest(),
+        MeshKernel kernel = MeshKernel::Epeck);
+    static Ptr create_fast_arrangement(const std::vector<Part>& parts,
+        const RegionOfInterest& region_of_interest = RegionOfInterest());
+    static Ptr create_geogram_arrangement(const std::vector<Part>& parts,
+        const RegionOfInterest& region_of_interest = RegionOfInterest());
+    static Ptr create_auto_arrangement(const std::vector<Part>& parts,
+        const RegionOfInterest& region_of_interest = RegionOfInterest());
+    static Ptr create_planar_arrangement(const std::vector<Part>& parts);
+
+    // Single precision input.  Vertices are widened once, directly into the
+    // engine, so the caller does not need a double precision copy.
+    template <typename Derived,
+        typename = std::enable_if_t<std::is_same_v<typename Derived::Scalar, float>>>
+    static Ptr create_mesh_arrangement(const Eigen::MatrixBase<Derived>& vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        const RegionOfInterest& region_of_interest = RegionOfInterest(),
+        MeshKernel kernel = MeshKernel::Epeck)
+    {
+        return create_mesh_arrangement(MatrixFr(vertices.template cast<Float>()),
+            faces,
+            face_labels,
+            region_of_interest,
+            kernel);
+    }
+    template <typename Derived,
+        typename = std::enable_if_t<std::is_same_v<typename Derived::Scalar, float>>>
+    static Ptr create_fast_arrangement(const Eigen::MatrixBase<Derived>& vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        const RegionOfInterest& region_of_interest = RegionOfInterest())
+    {
+        return create_fast_arrangement(
+            MatrixFr(vertices.template cast<Float>()), faces, face_labels, region_of_interest);
+    }
+    template <typename Derived,
+        typename = std::enable_if_t<std::is_same_v<typename Derived::Scalar, float>>>
+    static Ptr create_geogram_arrangement(const Eigen::MatrixBase<Derived>& vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        const RegionOfInterest& region_of_interest = RegionOfInterest())
+    {
+        return create_geogram_arrangement(
+            MatrixFr(vertices.template cast<Float>()), faces, face_labels, region_of_interest);
+    }
+    template <typename Derived,
+        typename = std::enable_if_t<std::is_same_v<typename Derived::Scalar, float>>>
+    static Ptr create_auto_arrangement(const Eigen::MatrixBase<Derived>& vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        const RegionOfInterest& region_of_interest = RegionOfInterest())
+    {
+        return create_auto_arrangement(
+            MatrixFr(vertices.template cast<Float>()), faces, face_labels, region_of_interest);
+    }
+    template <typename Derived,
+        typename = std::enable_if_t<std::is_same_v<typename Derived::Scalar, float>>>
+    static Ptr create_planar_arrangement(
+        const Eigen::MatrixBase<Derived>& vertices, const MatrixIr& faces, const VectorI& face_labels)
+    {
+        return create_planar_arrangement(
+            MatrixFr(vertices.template cast<Float>()), faces, face_labels);
+    }
 
 public:
     /**
      * @brief Constructor
      *
-     * @param vertices MatrixFr of size #vertices by 3.
+     * @param vertices MatrixFr of size #vertices by 3.  Taken by value, pass
+     * an rvalue to avoid a copy.
      * @param faces MatrixIr of size #faces by 3.
      * @param face_labels VectorI of size #faces.
      */
-    Arrangement(const MatrixFr& vertices, const MatrixIr& faces, const VectorI& face_labels)
-        : m_vertices(vertices)
+    Arrangement(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+        : m_vertices(std::move(vertices))
         , m_faces(faces)
         , m_in_face_labels(face_labels)
     {}
@@ -36,6 +220,62 @@ public:
      */
     virtual void run() = 0;
 
+    /**
+     * @brief Compute only the curves along which input faces intersect.
+     *
+     * This stops after the narrow phase: no remeshing, patches or cells are
+     * computed, and the engine state is left unchanged.  It operates on the
+     * current vertices and faces, so it should be called instead of run(), not
+     * after it.  All engines share the same exact narrow phase, on the exact
+     * input coordinates if set.  Pairs of faces sharing an edge are skipped
+     * unless they are folded onto each other, as are point contacts.  Pairs
+     * of coplanar faces that overlap contribute the boundary of their overlap.
+     *
+     * @return The intersection segments, their source face pairs and the
+     * polylines they form.
+     */
+    virtual IntersectionCurves compute_intersection_curves() const;
+
+    /**
+     * @brief Incrementally update the arrangement after some labeled parts
+     * were added, removed or moved.
+     *
+     * Must be called after run().  All output faces carrying a changed label
+     * are discarded and replaced by the given faces, which are resolved
+     * against the current output only where their bounding boxes overlap it.
+     * The cost of resolving follows the size of the change, but patches,
+     * cells and winding numbers are then recomputed over the whole output.
+     *
+     * @param changed_labels Labels whose faces changed.  A changed label
+     * without faces in the input below is removed.
+     * @param vertices MatrixFr of size #vertices by 3 of the changed parts.
+     * @param faces MatrixIr of size #faces by 3 of the changed parts.
+     * @param face_labels VectorI of size #faces.  Every label must be listed in
+     * `changed_labels`.
+     *
+     * @throws NotImplementedError if the engine does not support incremental
+     * updates.
+     */
+    virtual void update(const VectorI& changed_labels,
+        const MatrixFr& vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels);
+
+    /**
+     * @brief Replace the input so that the engine can be run again.
+     *
+     * The output, exact input coordinates and metrics are cleared, all
+     * options are kept (including the region of interest, which must match
+     * the new faces).  Engines keep their working buffers, so running many
+     * small jobs through one engine avoids reallocating them each time.
+     *
+     * @param vertices MatrixFr of size #vertices by 3.  Taken by value, pass
+     * an rvalue to avoid a copy.
+     * @param faces MatrixIr of size #faces by 3.
+     * @param face_labels VectorI of size #faces.
+     */
+    virtual void reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels);
+
     /**
      * @brief Get vertices
      *
@@ -54,6 +294,16 @@ public:
      */
     const MatrixIr& get_faces() const { return m_faces; }
 
+    /**
+     * @brief Get the output faces with 32-bit unsigned indices, which halves
+     * their size in builds with ARRANGEMENT_64BIT_INDEX.
+     *
+     * @throws RuntimeError if the vertex indices do not fit in 32 bits.
+     *
+     * @return MatrixU32r of size #faces by 3.
+     */
+    MatrixU32r get_faces_u32() const;
+
     /**
      * @brief Get face labels
      *
@@ -71,6 +321,7 @@ public:
      */
     size_t get_num_cells() const
     {
+        ensure_topology(TOPOLOGY_CELLS);
         if (m_cells.rows() > 0)
             return m_cells.maxCoeff() + 1;
         else
@@ -86,6 +337,7 @@ public:
      */
     MatrixIr get_cell_faces(const size_t cell_id) const
     {
+        ensure_topology(TOPOLOGY_CELLS);
         const size_t num_faces = m_faces.rows();
         MatrixIr faces(num_faces, 3);
         size_t face_count = 0;
@@ -109,7 +361,11 @@ public:
      * @return MatrixIr of size #patches by 2.  Each row gives the indices of the
      * cells on the positive and negative side of the patch.
      */
-    const MatrixIr& get_cells() const { return m_cells; }
+    const MatrixIr& get_cells() const
+    {
+        ensure_topology(TOPOLOGY_CELLS);
+        return m_cells;
+    }
 
     /**
      * @brief Get the number of patches.
@@ -118,6 +374,7 @@ public:
      */
     size_t get_num_patches() const
     {
+        ensure_topology(TOPOLOGY_PATCHES);
         if (m_patches.size() > 0)
             return m_patches.maxCoeff() + 1;
         else
@@ -130,7 +387,11 @@ public:
      * @return VectorI of size #faces.  Each entry gives the patch index for the
      * corresponding face.
      */
-    const VectorI& get_patches() const { return m_patches; }
+    const VectorI& get_patches() const
+    {
+        ensure_topology(TOPOLOGY_PATCHES);
+        return m_patches;
+    }
 
     /**
      * @brief Get the winding number on each side of faces.
@@ -138,7 +399,318 @@ public:
      * @return MatrixIr of size #faces by 2.  Each entry gives the winding number
      * on the positive and negative side of the face.
      */
-    const MatrixIr& get_winding_number() const { return m_winding_number; }
+    const MatrixIr& get_winding_number() const
+    {
+        ensure_topology(TOPOLOGY_WINDING_NUMBERS);
+        return m_winding_number;
+    }
+
+    /**
+     * @brief Compute the winding number of each cell with respect to groups of
+     * input labels.
+     *
+     * Winding numbers are propagated from the ambient cell (cell 0, winding
+     * number 0) across patches: crossing a patch from its positive side to its
+     * negative side increments the winding number of every group that has a
+     * face in the patch.  Each group is expected to form closed, consistently
+     * oriented surfaces.
+     *
+     * @param label_groups VectorI indexed by input face label.  Each entry gives
+     * the group index of that label, or a negative value to ignore the label.
+     *
+     * @return MatrixIr of size #cells by #groups.
+     */
+    MatrixIr get_cell_winding_numbers(const VectorI& label_groups) const;
+
+    /**
+     * @brief Extract the boundary of a boolean combination of label groups.
+     *
+     * @param op The boolean operation.
+     * @param label_groups VectorI indexed by input face label, see
+     * get_cell_winding_numbers().
+     *
+     * @return MatrixIr of size #faces by 3.  Each row gives the vertex indices of
+     * an output face, oriented with normal pointing out of the region.
+     */
+    MatrixIr extract_boolean(BooleanOperation op, const VectorI& label_groups) const;
+
+    /**
+     * @brief Extract the boundary of the region formed by all cells whose
+     * per-group winding numbers satisfy a predicate.
+     *
+     * Only the per-cell winding numbers are evaluated; cell geometry is never
+     * materialized.  Output faces are gathered in two parallel passes over
+     * chunks of faces: one counts the boundary faces of each chunk, the other
+     * writes them at the chunk offsets.
+     *
+     * @param label_groups VectorI indexed by input face label, see
+     * get_cell_winding_numbers().
+     * @param predicate Returns true for cells inside the region.
+     *
+     * @return MatrixIr of size #faces by 3.  Each row gives the vertex indices of
+     * an output face, oriented with normal pointing out of the region.
+     */
+    MatrixIr extract_region(
+        const VectorI& label_groups, const WindingNumberPredicate& predicate) const;
+
+    /**
+     * @brief Get exact vertex coordinates.
+     *
+     * Before run(), this returns the exact input coordinates set by
+     * set_exact_vertices(), if any.  After run(), this returns the exact output
+     * coordinates if exact output is enabled, and is empty otherwise.
+     *
+     * @return Exact coordinates of size #vertices * 3 in row-major order.  Each
+     * entry is a rational number encoded as "numerator/denominator" (or just
+     * "numerator" for integers).
+     */
+    const std::vector<std::string>& get_exact_vertices() const { return m_exact_vertices; }
+
+    /**
+     * @brief Provide exact input vertex coordinates.
+     *
+     * The exact coordinates take precedence over the floating point vertices
+     * passed to the constructor, which should be their rounded values.  This
+     * allows the exact output of a previous run to be fed back without
+     * rounding.
+     *
+     * @param coordinates Exact coordinates in the format of
+     * get_exact_vertices(), of size #vertices * 3.
+     */
+    void set_exact_vertices(const std::vector<std::string>& coordinates);
+
+    /**
+     * @brief Enable or disable exact output coordinates.
+     *
+     * @param exact_output Whether to export exact output coordinates.
+     */
+    void set_exact_output(const bool exact_output) { m_exact_output = exact_output; }
+
+    /**
+     * @brief Get whether exact output coordinates are exported.
+     */
+    bool get_exact_output() const { return m_exact_output; }
+
+    /**
+     * @brief Declare that the input is already free of self-intersections.
+     *
+     * When set, the engine skips resolving self-intersections and only
+     * extracts patches, cells and winding numbers.  This is valid for the exact
+     * output of a previous arrangement (or a subset of its faces).
+     *
+     * @param input_resolved Whether the input is already arranged.
+     */
+    void set_input_resolved(const bool input_resolved) { m_input_resolved = input_resolved; }
+
+    /**
+     * @brief Get whether the input is declared free of self-intersections.
+     */
+    bool get_input_resolved() const { return m_input_resolved; }
+
+    /**
+     * @brief Enable or disable snap rounding of the output.
+     *
+     * When enabled, the exactly resolved vertices are snap rounded to doubles
+     * (or to a uniform grid) and any intersection introduced by the rounding is
+     * resolved locally, so that the double output is guaranteed to be free of
+     * self-intersections.  Such output can be fed to another arrangement with
+     * set_input_resolved(true).
+     *
+     * @param snap_rounding Whether to snap round the output.
+     * @param grid_size Grid spacing, or 0 to round to the nearest doubles.
+     */
+    void set_snap_rounding(const bool snap_rounding, const Float grid_size = 0)
+    {
+        m_snap_rounding = snap_rounding;
+        m_snap_grid_size = grid_size;
+    }
+
+    /**
+     * @brief Get whether the output is snap rounded.
+     */
+    bool get_snap_rounding() const { return m_snap_rounding; }
+
+    /**
+     * @brief Get the snap rounding grid spacing (0 means rounding to doubles).
+     */
+    Float get_snap_grid_size() const { return m_snap_grid_size; }
+
+    /**
+     * @brief Enable or disable quantized input.
+     *
+     * When enabled, input vertices are snapped to integer multiples of
+     * grid_size before resolving self-intersections, and faces collapsed by
+     * the snapping are dropped.  Intersection points are then reconstructed
+     * with exact 128-bit integer arithmetic instead of Epeck constructions,
+     * which is exact as long as the grid coordinates fit in 29 bits
+     * (line-plane intersections) or 16 bits (3-plane intersections); other
+     * points fall back to Epeck.  The grid spacing is recorded in the metrics
+     * along with the number of points of each kind.  Only supported by
+     * FastArrangement, not combined with snap rounding, and ignored for
+     * resolved input.
+     *
+     * @param quantization Whether to quantize the input.
+     * @param grid_size Grid spacing, or 0 to pick a power of 2 such that grid
+     * coordinates fit in 26 bits.
+     */
+    void set_quantization(const bool quantization, const Float grid_size = 0)
+    {
+        m_quantization = quantization;
+        m_quantization_grid_size = grid_size;
+    }
+
+    /**
+     * @brief Get whether the input is quantized.
+     */
+    bool get_quantization() const { return m_quantization; }
+
+    /**
+     * @brief Get the quantization grid spacing (0 means chosen automatically).
+     */
+    Float get_quantization_grid_size() const { return m_quantization_grid_size; }
+
+    /**
+     * @brief Enable or disable merging of coplanar faces in the output.
+     *
+     * When enabled, run() merges faces that share an edge, a patch, a label
+     * and the same supporting plane (tested exactly), and retriangulates each
+     * merged region minimally from its boundary.  Boundary vertices are kept,
+     * so patches, cells and labels are preserved.  The stage time
+     * ("merge_coplanar") and the face counts before and after are recorded in
+     * the metrics.  GeogramArrangement requires ARRANGEMENT_IGL for it.
+     *
+     * @param merge_coplanar Whether to merge coplanar faces.
+     */
+    void set_merge_coplanar(const bool merge_coplanar) { m_merge_coplanar = merge_coplanar; }
+
+    /**
+     * @brief Get whether coplanar faces are merged in the output.
+     */
+    bool get_merge_coplanar() const { return m_merge_coplanar; }
+
+    /**
+     * @brief Enable or disable the per-run arena.
+     *
+     * When enabled, the temporaries of the region of interest and coplanar
+     * merge stages are allocated from a monotonic arena that is released in
+     * one shot at the end of run().  The arena block is kept and grown to the
+     * peak usage, so later runs after reset() do not allocate for them.  Its
+     * size is recorded in the metrics ("run_arena_bytes").  Used by
+     * MeshArrangement and FastArrangement.
+     *
+     * @param run_arena Whether to use a per-run arena.
+     */
+    void set_run_arena(const bool run_arena) { m_run_arena = run_arena; }
+
+    /**
+     * @brief Get whether a per-run arena is used.
+     */
+    bool get_run_arena() const { return m_run_arena; }
+
+    /**
+     * @brief Restrict the resolution of self-intersections to a region.
+     *
+     * Only intersections among faces of the region are resolved, so the cost
+     * scales with the size of the region.  Faces outside the region pass
+     * through untouched, except those sharing an edge with the region: they
+     * are retriangulated to include the vertices inserted on that edge so
+     * that the output stays conforming along the seam.  Intersections
+     * involving faces outside the region are ignored, so the output is only
+     * partially arranged: patches are computed, but cells and winding numbers
+     * are not.  Not supported by GeogramArrangement.
+     *
+     * @param region_of_interest The region, empty to resolve everything.
+     */
+    void set_region_of_interest(const RegionOfInterest& region_of_interest)
+    {
+        m_region_of_interest = region_of_interest;
+    }
+
+    /**
+     * @brief Get the region of interest.
+     */
+    const RegionOfInterest& get_region_of_interest() const { return m_region_of_interest; }
+
+    /**
+     * @brief Set the maximum number of threads used by run() and by the parallel
+     * queries of this arrangement.
+     *
+     * FastArrangement runs its TBB work inside a task arena of this size, so
+     * that concurrent jobs in the same process share the TBB worker pool instead
+     * of oversubscribing the machine.  GeogramArrangement caps geogram's thread
+     * pool, which is process-wide, for the duration of run(): concurrent
+     * geogram runs with a cap are serialized, and runs without one use the cap
+     * in effect.  The CGAL based stages are serial.
+     *
+     * @param num_threads Maximum number of threads, 0 means all hardware threads.
+     */
+    void set_num_threads(const size_t num_threads) { m_num_threads = num_threads; }
+
+    /**
+     * @brief Get the maximum number of threads (0 means all hardware threads).
+     */
+    size_t get_num_threads() const { return m_num_threads; }
+
+    /**
+     * @brief Select the topology stages computed by run().
+     *
+     * Stages not selected are computed lazily, on first access of the
+     * corresponding getters.  The resolved mesh is kept until all stages are
+     * done, so only the remaining stages are paid for.  Defaults to
+     * TOPOLOGY_ALL, except for FastArrangement which skips winding numbers.
+     *
+     * @param stages Bit mask of TopologyStage values.
+     */
+    void set_eager_stages(const unsigned stages) { m_eager_stages = stages; }
+
+    /**
+     * @brief Get the topology stages computed by run().
+     */
+    unsigned get_eager_stages() const { return m_eager_stages; }
+
+    /**
+     * @brief Compute the given topology stages (and the stages they depend on)
+     * if they are not computed yet.  Safe to call concurrently.
+     *
+     * @param stages Bit mask of TopologyStage values.
+     */
+    void ensure_topology(unsigned stages) const;
+
+    /**
+     * @brief Get the topology stages computed so far.
+     */
+    unsigned get_computed_stages() const { return m_computed_stages.load(); }
+
+    /**
+     * @brief Stream the output of run() to a sink instead of keeping it.
+     *
+     * run() hands vertices, faces, labels and the topology stages computed by
+     * run() (see set_eager_stages()) to the sink in chunks, releasing each
+     * buffer once written.  MeshArrangement and FastArrangement convert the
+     * exact vertices chunk by chunk and never hold the full output in double
+     * precision; AutoArrangement streams the result of the selected engine
+     * once it has run.  Afterwards the arrangement holds neither the input nor the
+     * output: getters return empty matrices, pending topology stages are
+     * dropped and run() must not be called again.  Only metrics remain.
+     *
+     * @param sink The sink, which must outlive run(), or nullptr to keep the
+     * output.
+     */
+    void set_output_sink(OutputSink* sink) { m_output_sink = sink; }
+
+    /**
+     * @brief Get the output sink, nullptr if the output is kept.
+     */
+    OutputSink* get_output_sink() const { return m_output_sink; }
+
+    /**
+     * @brief Get the metrics recorded by the last run().
+     *
+     * All engines record the "resolve" and "extract" stage timings in seconds
+     * as well as the output size.  Some engines record more, e.g. the
+     * decisions of AutoArrangement.
+     */
+    const Metrics& get_metrics() const { return m_metrics; }
 
     /**
      * @brief Set verbosity.
@@ -154,15 +726,68 @@ public:
      */
     bool get_verbose() const { return m_verbose; }
 
+protected:
+    /**
+     * @brief Compute topology stages.  Called by ensure_topology() with the
+     * stages not computed yet, in dependency order.  Engines that compute
+     * everything in run() do not need to override this.
+     *
+     * @param stages Bit mask of TopologyStage values.
+     */
+    virtual void compute_topology(unsigned /*stages*/) const {}
+
+    /**
+     * @brief Mark the given stages as computed and all others as pending.
+     */
+    void reset_topology(unsigned computed_stages = TOPOLOGY_NONE)
+    {
+        m_computed_stages = computed_stages;
+    }
+
+    /**
+     * @brief Callback writing the output vertices to the sink in chunks.
+     */
+    using VertexWriter = std::function<void(OutputSink&)>;
+
+    /**
+     * @brief Stream the output held by this object to the output sink and
+     * release it, together with the input.  Engines holding the exact resolved
+     * mesh pass `write_vertices` to stream vertices from it instead of from
+     * m_vertices.
+     *
+     * @param num_vertices Number of output vertices.
+     * @param write_vertices Vertex writer, or nullptr to stream m_vertices and
+     * m_exact_vertices.
+     */
+    void stream_output(size_t num_vertices, const VertexWriter& write_vertices = nullptr);
+
 protected:
     MatrixFr m_vertices;
     MatrixIr m_faces;
     VectorI m_in_face_labels;
     VectorI m_out_face_labels;
-    MatrixIr m_cells;
-    VectorI m_patches;
-    MatrixIr m_winding_number;
+    mutable MatrixIr m_cells;
+    mutable VectorI m_patches;
+    mutable MatrixIr m_winding_number;
+    std::vector<std::string> m_exact_vertices;
+    bool m_exact_output = false;
+    bool m_input_resolved = false;
+    bool m_snap_rounding = false;
+    Float m_snap_grid_size = 0;
+    bool m_quantization = false;
+    Float m_quantization_grid_size = 0;
+    bool m_merge_coplanar = false;
+    bool m_run_arena = false;
+    RegionOfInterest m_region_of_interest;
+    size_t m_num_threads = 0;
+    OutputSink* m_output_sink = nullptr;
     bool m_verbose = false;
+    unsigned m_eager_stages = TOPOLOGY_ALL;
+    mutable Metrics m_metrics;
+
+private:
+    mutable std::atomic<unsigned> m_computed_stages{TOPOLOGY_ALL};
+    mutable std::mutex m_topology_mutex;
 };
 
 } // namespace arrangement
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Arrangement.h"
+
+#include <string>
+#include <vector>
+
+namespace arrangement {
+
+/**
+ * Arrangement engine that profiles its input, picks the engine expected to be
+ * fastest and falls back to more robust engines on failure.
+ *
+ * The default engine order is fast, mesh, geogram (restricted to the engines
+ * compiled in and able to honor the requested options).  Mesh is moved to the
+ * front for tiny inputs, where the fixed cost of the fast engine dominates, and
+ * for inputs with many coplanar candidate pairs, which are the degenerate
+ * configurations the fast engine handles worst.  Fast is skipped when the
+ * labels do not fit in its label bitset.  Inputs whose faces all lie in a few
+ * parallel planes go to the planar engine first (see PlanarArrangement).
+ *
+ * Every attempt that throws, or that exceeds the timeout, is recorded in the
+ * metrics and the next engine is tried.  The last engine always runs without a
+ * timeout.
+ *
+ * The eager topology stages are restricted to the ones the selected engine
+ * computes eagerly by default.
+ */
+class AutoArrangement final : public Arrangement
+{
+public:
+    using Base = Arrangement;
+
+    /**
+     * Input statistics used to choose the engine order.
+     */
+    struct Profile
+    {
+        size_t num_faces = 0;
+        size_t num_labels = 0; ///< Number of distinct labels.
+        int max_label = -1;
+        size_t num_sampled_faces = 0;
+        Float candidate_pairs = 0; ///< Estimated #face pairs with overlapping boxes.
+        Float coplanarity_ratio = 0; ///< Fraction of sampled candidate pairs that are coplanar.
+        size_t num_planes = 0; ///< Parallel planes holding all faces, 0 if not planar.
+    };
+
+public:
+    AutoArrangement(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+        : Base(std::move(vertices), faces, face_labels)
+    {}
+    ~AutoArrangement() = default;
+
+    void run() override;
+
+    /**
+     * @brief Forward an incremental update to the engine selected by the last
+     * run(), see Arrangement::update().
+     */
+    void update(const VectorI& changed_labels,
+        const MatrixFr& vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels) override;
+
+    /**
+     * @brief Replace the input, see Arrangement::reset().  The engine selected
+     * by the last run() is kept and reset in turn if the next run() selects it
+     * again, so that its buffers are reused.
+     */
+    void reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels) override;
+
+    /**
+     * @brief Compute the input profile.
+     *
+     * Candidate pairs are counted with a bounding volume hierarchy over the
+     * input faces, querying the boxes of at most `max_samples` evenly spaced
+     * faces, and extrapolated to the whole input.  Planarity is checked
+     * exactly on all faces, after a quick inexact rejection.
+     */
+    static Profile compute_profile(const MatrixFr& vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        size_t max_samples = 4096);
+
+    /**
+     * @brief Set the time limit of each attempt, except the last one.
+     *
+     * An attempt that exceeds the limit is abandoned: it cannot be interrupted,
+     * so it keeps running on a detached thread until it finishes and its result
+     * is discarded.  Use with care when CPU time matters.
+     *
+     * @param seconds Time limit in seconds, 0 (default) means no limit.
+     */
+    void set_timeout(const Float seconds) { m_timeout = seconds; }
+
+    /**
+     * @brief Get the time limit of each attempt in seconds (0 means no limit).
+     */
+    Float get_timeout() const { return m_timeout; }
+
+    /**
+     * @brief Override the engine order.
+     *
+     * @param engines Engine names ("planar", "fast", "mesh", "geogram", or any
+     * engine of EngineRegistry) in the order they should be tried.  Empty (default) means the order is chosen from the
+     * input profile.
+     */
+    void set_engines(const std::vector<std::string>& engines) { m_engines = engines; }
+
+    /**
+     * @brief Get the engine order override.
+     */
+    const std::vector<std::string>& get_engines() const { return m_engines; }
+
+    /**
+     * @brief Get the name of the engine that produced the result of the last
+     * run(), or an empty string before that.
+     */
+    const std::string& get_selected_engine() const { return m_selected_engine; }
+
+protected:
+    /**
+     * Pull the requested stages from the selected engine, which computes them
+     * lazily if needed.
+     */
+    void compute_topology(unsigned stages) const override;
+
+private:
+    std::vector<std::string> choose_engines(const Profile& profile) const;
+    Ptr create_engine(const std::string& name);
+    void copy_result();
+
+private:
+    Float m_timeout = 0;
+    std::vector<std::string> m_engines;
+    std::string m_selected_engine;
+    Ptr m_engine;
+    Ptr m_spare_engine; ///< Engine of a previous run, reused if selected again.
+    std::string m_spare_engine_name;
+};
+
+} // namespace arrangement
@@ -3,9 +3,20 @@
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
+#include <cstdint>
+
 namespace arrangement {
 
 typedef double Float;
+
+// Scalar of index matrices (faces, cells, ...).  Builds with
+// ARRANGEMENT_64BIT_INDEX support meshes whose index buffers exceed the range
+// of int.
+#ifdef ARRANGEMENT_64BIT_INDEX
+typedef std::int64_t Index;
+#else
+typedef int Index;
+#endif
 typedef Eigen::VectorXd VectorF;
 typedef Eigen::VectorXi VectorI;
 typedef Eigen::Vector4d Vector4F;
@@ -24,13 +35,17 @@ typedef Eigen::Matrix2i Matrix2I;
 typedef Eigen::Matrix3i Matrix3I;
 typedef Eigen::Matrix4i Matrix4I;
 
-typedef Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixIr;
+typedef Eigen::Matrix<Index, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixIr;
 typedef Eigen::Matrix<Float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixFr;
 
-typedef Eigen::Matrix<int, Eigen::Dynamic, 2, Eigen::RowMajor> Matrix2Ir;
+typedef Eigen::Matrix<Index, Eigen::Dynamic, 2, Eigen::RowMajor> Matrix2Ir;
 typedef Eigen::Matrix<Float, Eigen::Dynamic, 2, Eigen::RowMajor> Matrix2Fr;
-typedef Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> Matrix3Ir;
+typedef Eigen::Matrix<Index, Eigen::Dynamic, 3, Eigen::RowMajor> Matrix3Ir;
 typedef Eigen::Matrix<Float, Eigen::Dynamic, 3, Eigen::RowMajor> Matrix3Fr;
-typedef Eigen::Matrix<int, Eigen::Dynamic, 4, Eigen::RowMajor> Matrix4Ir;
+typedef Eigen::Matrix<Index, Eigen::Dynamic, 4, Eigen::RowMajor> Matrix4Ir;
 typedef Eigen::Matrix<Float, Eigen::Dynamic, 4, Eigen::RowMajor> Matrix4Fr;
+
+// Single precision input vertices and compact output faces.
+typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixF32r;
+typedef Eigen::Matrix<std::uint32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixU32r;
 } // namespace arrangement
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Arrangement.h"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace arrangement {
+
+/**
+ * Options forwarded by the Arrangement factories to the engine factories.
+ */
+struct EngineOptions
+{
+    RegionOfInterest region_of_interest;
+    /// Only used by the mesh engine.
+    MeshKernel kernel = MeshKernel::Epeck;
+};
+
+/**
+ * Engines by name: "mesh", "planar", "fast", "geogram", or any name
+ * registered by the application or a plugin.  The Arrangement factories and
+ * the auto engine create engines through it.
+ *
+ * Engines compiled into the library are registered up front.  With
+ * ARRANGEMENT_ENGINE_PLUGINS, each engine family is instead built as a
+ * separate module (arrangement_mesh for "mesh" and "planar", arrangement_fast,
+ * arrangement_geogram), loaded the first time one of its engines is created,
+ * so that programs only load the dependencies of the engines they use.
+ * Modules are searched in the directories of the ARRANGEMENT_PLUGIN_PATH
+ * environment variable (separated by ':'), then next to the arrangement
+ * library.  Any other name `foo` is looked up as module arrangement_foo.
+ *
+ * A plugin is a shared module that registers its engines from
+ * ARRANGEMENT_PLUGIN, e.g.
+ *
+ *     ARRANGEMENT_PLUGIN()
+ *     {
+ *         arrangement::EngineRegistry::register_engine("foo", [](auto vertices,
+ *             const auto& faces, const auto& face_labels, const auto& options) {
+ *             return std::make_shared<FooArrangement>(std::move(vertices), faces, face_labels);
+ *         });
+ *     }
+ *
+ * Plugins are only supported on POSIX systems.  All functions are thread-safe.
+ */
+namespace EngineRegistry {
+
+using Factory = std::function<Arrangement::Ptr(MatrixFr vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    const EngineOptions& options)>;
+
+/**
+ * Register a factory under `name`, replacing any previous one.
+ */
+void register_engine(const std::string& name, Factory factory);
+
+/**
+ * Create engine `name`, loading its plugin module on first use.
+ *
+ * @return The engine, or nullptr if it is neither registered nor provided by
+ * a plugin that can be loaded.
+ */
+Arrangement::Ptr create(const std::string& name,
+    MatrixFr vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    const EngineOptions& options = EngineOptions());
+
+/**
+ * Whether engine `name` is registered or its plugin module exists.  Does not
+ * load the module.
+ */
+bool is_available(const std::string& name);
+
+/**
+ * Get the names of the registered engines, i.e. the compiled-in ones and
+ * those of the plugins loaded so far.
+ */
+std::vector<std::string> get_engine_names();
+
+/**
+ * Load a plugin module and register its engines.  Loading the same file again
+ * does nothing.
+ *
+ * @param filename Path of the module.
+ *
+ * @throws RuntimeError if the module cannot be loaded or is not a plugin.
+ * @throws NotImplementedError on platforms without plugin support.
+ */
+void load_plugin(const std::string& filename);
+
+/**
+ * Get the time spent loading each plugin module and registering its engines,
+ * in seconds, keyed by module path.  Used to measure startup costs.
+ */
+std::map<std::string, double> get_plugin_load_times();
+
+} // namespace EngineRegistry
+} // namespace arrangement
+
+#if defined(_WIN32)
+#define ARRANGEMENT_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define ARRANGEMENT_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+/// Symbol looked up in plugin modules.  Versioned, so that modules built
+/// against an incompatible registry are rejected.
+#define ARRANGEMENT_PLUGIN_SYMBOL "arrangement_register_plugin_v1"
+
+/**
+ * Define the entry point of a plugin module, called once when it is loaded.
+ */
+#define ARRANGEMENT_PLUGIN() \
+    extern "C" ARRANGEMENT_PLUGIN_EXPORT void arrangement_register_plugin_v1()
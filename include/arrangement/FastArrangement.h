@@ -4,6 +4,8 @@
 
 #include "Arrangement.h"
 
+#include <memory>
+
 namespace arrangement {
 
 class FastArrangement final : public Arrangement
@@ -12,10 +14,24 @@ public:
     using Base = Arrangement;
 
 public:
-    FastArrangement(const MatrixFr& vertices, const MatrixIr& faces, const VectorI& face_labels)
-        : Base(vertices, faces, face_labels)
-    {}
-    ~FastArrangement() = default;
+    /**
+     * Winding numbers are not computed by run() by default, see
+     * set_eager_stages().
+     */
+    FastArrangement(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels);
+    ~FastArrangement();
+
+    /**
+     * @brief Get the maximum number of distinct face labels supported.  Face
+     * labels must lie in [0, get_max_num_labels()).
+     */
+    static size_t get_max_num_labels();
+
+    /**
+     * @brief Replace the input, see Arrangement::reset().  The staging buffers
+     * of the resolve stage and its task arena are kept.
+     */
+    void reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels) override;
 
 #ifdef __clang__
     __attribute__((optnone))
@@ -23,7 +39,13 @@ public:
     void
     run() override;
 
+protected:
+    void compute_topology(unsigned stages) const override;
+
 private:
+    struct State;
+    std::unique_ptr<State> m_state;
+
     using Base::m_cells;
     using Base::m_faces;
     using Base::m_in_face_labels;
@@ -12,8 +12,8 @@ public:
     using Base = Arrangement;
 
 public:
-    GeogramArrangement(const MatrixFr& vertices, const MatrixIr& faces, const VectorI& face_labels)
-        : Base(vertices, faces, face_labels)
+    GeogramArrangement(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+        : Base(std::move(vertices), faces, face_labels)
     {}
     ~GeogramArrangement() = default;
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "EigenTypedef.h"
+
+#include <vector>
+
+namespace arrangement {
+
+/**
+ * Curves along which the faces of a mesh intersect each other.
+ */
+struct IntersectionCurves
+{
+    /// MatrixFr of size #points by 3.  Points are unique.
+    MatrixFr vertices;
+
+    /// MatrixIr of size #segments by 2.  Each row gives the end points of an
+    /// intersection segment.
+    MatrixIr segments;
+
+    /// MatrixIr of size #segments by 2.  Each row gives the pair of input
+    /// faces whose intersection is the corresponding segment.
+    MatrixIr face_pairs;
+
+    /// Segments chained into polylines.  Each polyline lists vertex indices;
+    /// closed polylines repeat their first vertex at the end.  Polylines stop
+    /// at points where more than two segments meet.
+    std::vector<std::vector<Index>> polylines;
+
+    /// Number of face pairs that overlap in a common plane.  Their overlap is
+    /// an area, whose boundary is reported in the segments.
+    size_t num_coplanar_pairs = 0;
+};
+
+} // namespace arrangement
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+
+namespace arrangement {
+namespace MemoryUtils {
+
+/**
+ * Peak resident set size of the process in bytes, 0 if unknown.
+ */
+size_t get_peak_rss();
+
+/**
+ * Current resident set size of the process in bytes, 0 if unknown.
+ */
+size_t get_current_rss();
+
+/**
+ * Reset the peak resident set size to the current one, so that the peak of a
+ * later section can be measured.  Only supported on Linux.
+ *
+ * @return Whether the peak was reset.
+ */
+bool reset_peak_rss();
+
+/**
+ * Allocations made through the global operator new.
+ */
+struct AllocationCounters
+{
+    size_t num_allocations = 0;
+    size_t num_bytes = 0;
+};
+
+/**
+ * Whether allocations are counted, i.e. the library was configured with
+ * ARRANGEMENT_WITH_MEMORY_STATS, which replaces the global operator new and
+ * delete of the program.
+ */
+bool is_allocation_counting_enabled();
+
+/**
+ * Allocations made by all threads so far, zero unless allocation counting is
+ * enabled.
+ */
+AllocationCounters get_allocation_counters();
+
+/**
+ * Memory used by a stage.
+ */
+struct StageMemory
+{
+    /// Peak resident set size during the stage above the resident set size at
+    /// its start, in bytes.  0 where the peak cannot be reset (non-Linux).
+    size_t peak_rss_delta = 0;
+    /// Number of allocations made by all threads during the stage.
+    size_t num_allocations = 0;
+    /// Bytes allocated by all threads during the stage, frees not deducted.
+    size_t allocated_bytes = 0;
+};
+
+/**
+ * Measure the memory used between construction and finish().  Scopes may be
+ * nested: an enclosing scope still sees the peak reached inside the nested
+ * ones, even though each scope resets the process peak when it starts.
+ * Memory is process-wide, so concurrent scopes on other threads are counted
+ * too.
+ */
+class MemoryScope
+{
+public:
+    MemoryScope();
+
+    /**
+     * @brief End the measurement.  Must be called once, in reverse order of
+     * construction for nested scopes.
+     */
+    StageMemory finish();
+
+private:
+    size_t m_rss_begin = 0;
+    size_t m_enclosing_peak = 0;
+    bool m_peak_reset = false;
+    AllocationCounters m_allocations_begin;
+};
+
+} // namespace MemoryUtils
+} // namespace arrangement
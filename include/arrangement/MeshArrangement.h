@@ -4,6 +4,8 @@
 
 #include "Arrangement.h"
 
+#include <memory>
+
 namespace arrangement {
 
 class MeshArrangement final : public Arrangement
@@ -12,13 +14,69 @@ public:
     using Base = Arrangement;
 
 public:
-    MeshArrangement(const MatrixFr& vertices, const MatrixIr& faces, const VectorI& face_labels)
-        : Base(vertices, faces, face_labels)
-    {}
-    ~MeshArrangement() = default;
+    MeshArrangement(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels);
+    ~MeshArrangement();
     void run() override;
 
+    /**
+     * @brief Incrementally update the arrangement, see Arrangement::update().
+     *
+     * The exact output of the previous run is kept and only its faces whose
+     * bounding boxes overlap the new faces are re-resolved.  Faces near the
+     * previous position of a moved or removed part keep the subdivision it
+     * created: the geometry, patches, cells and winding numbers match a full
+     * run, the triangulation may be finer.  These fragments accumulate over
+     * repeated updates; a new run() or set_merge_coplanar() coarsens them
+     * again.  Not supported with snap rounding.
+     */
+    void update(const VectorI& changed_labels,
+        const MatrixFr& vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels) override;
+
+    /**
+     * @brief Replace the input, see Arrangement::reset().  The previous
+     * result is released, so update() requires a new run().
+     */
+    void reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels) override;
+
+    /**
+     * @brief Select the kernel used to resolve self-intersections in run().
+     *
+     * Patches, cells and winding numbers are always computed with CGAL::Epeck,
+     * as are exact input coordinates and incremental updates; the resolved
+     * vertices are converted to it.  Non-default kernels are meant for
+     * comparing number types on the resolve stage, which dominates run().
+     *
+     * @throws NotImplementedError if the kernel is not available in this build.
+     */
+    void set_kernel(MeshKernel kernel);
+
+    /**
+     * @brief Get the kernel used to resolve self-intersections.
+     */
+    MeshKernel get_kernel() const { return m_kernel; }
+
+    /**
+     * @brief Check whether a kernel is compiled in.
+     */
+    static bool is_kernel_available(MeshKernel kernel);
+
+protected:
+    void compute_topology(unsigned stages) const override;
+
 private:
+    /**
+     * Write the output from the resolved state and compute the eager
+     * topology stages.
+     */
+    void extract_arrangement();
+
+private:
+    struct State;
+    std::unique_ptr<State> m_state;
+    MeshKernel m_kernel = MeshKernel::Epeck;
+
     using Base::m_cells;
     using Base::m_faces;
     using Base::m_in_face_labels;
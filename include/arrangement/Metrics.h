@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+
+#include "MemoryUtils.h"
+#include "Trace.h"
+
+namespace arrangement {
+
+/**
+ * Metrics recorded by an arrangement engine during run().
+ */
+struct Metrics
+{
+    /// Wall time in seconds of each stage, keyed by stage name.
+    std::map<std::string, double> timings;
+
+    /// Numeric measurements (counts, sizes, ratios), keyed by name.
+    std::map<std::string, double> values;
+
+    /// Textual annotations (e.g. decisions taken), keyed by name.
+    std::map<std::string, std::string> notes;
+
+    /// Memory used by each stage, keyed like timings.  Only recorded with
+    /// ARRANGEMENT_WITH_MEMORY_STATS.
+    std::map<std::string, MemoryUtils::StageMemory> memory;
+
+    void clear()
+    {
+        timings.clear();
+        values.clear();
+        notes.clear();
+        memory.clear();
+    }
+};
+
+/**
+ * Record the wall time of a scope into Metrics::timings.  Nested or repeated
+ * scopes with the same name accumulate.  With ARRANGEMENT_WITH_TRACE, the
+ * scope is also recorded as a trace span.  With ARRANGEMENT_WITH_MEMORY_STATS,
+ * its memory use is recorded into Metrics::memory: allocations accumulate,
+ * the peak RSS delta is the maximum.
+ */
+class ScopedTimer
+{
+public:
+    ScopedTimer(Metrics& metrics, std::string name)
+        : m_metrics(metrics)
+    {
+        start(std::move(name));
+    }
+
+    ~ScopedTimer() { stop(); }
+
+    /**
+     * @brief Stop the current stage and start the next one.
+     */
+    void restart(std::string name)
+    {
+        stop();
+        start(std::move(name));
+    }
+
+    /**
+     * @brief Stop the current stage before the end of the scope.
+     */
+    void stop()
+    {
+        if (!m_running) return;
+        m_running = false;
+        const auto end = std::chrono::high_resolution_clock::now();
+#ifdef ARRANGEMENT_WITH_MEMORY_STATS
+        const MemoryUtils::StageMemory used = m_memory_scope->finish();
+        m_memory_scope.reset();
+#endif
+        std::chrono::duration<double> elapsed = end - m_start;
+        m_metrics.timings[m_name] += elapsed.count();
+#ifdef ARRANGEMENT_WITH_TRACE
+        Trace::record_span(m_name, "stage", m_start, end);
+#endif
+#ifdef ARRANGEMENT_WITH_MEMORY_STATS
+        MemoryUtils::StageMemory& memory = m_metrics.memory[m_name];
+        memory.peak_rss_delta = std::max(memory.peak_rss_delta, used.peak_rss_delta);
+        memory.num_allocations += used.num_allocations;
+        memory.allocated_bytes += used.allocated_bytes;
+#endif
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    void start(std::string name)
+    {
+        m_name = std::move(name);
+#ifdef ARRANGEMENT_WITH_MEMORY_STATS
+        m_memory_scope.emplace();
+#endif
+        m_running = true;
+        m_start = std::chrono::high_resolution_clock::now();
+    }
+
+private:
+    Metrics& m_metrics;
+    std::string m_name;
+    bool m_running = false;
+    std::chrono::high_resolution_clock::time_point m_start;
+#ifdef ARRANGEMENT_WITH_MEMORY_STATS
+    std::optional<MemoryUtils::MemoryScope> m_memory_scope;
+#endif
+};
+
+} // namespace arrangement
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "EigenTypedef.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace arrangement {
+
+/**
+ * Receiver of the output of an arrangement, in chunks.
+ *
+ * When an output sink is set (see Arrangement::set_output_sink()), run()
+ * hands the output over in chunks as it is finalized instead of keeping it,
+ * and releases each buffer once written.  Calls come in order: begin(), all
+ * vertex chunks, all face chunks, then cells and winding numbers if they are
+ * computed by run() (see Arrangement::set_eager_stages()), then end().
+ */
+class OutputSink
+{
+public:
+    virtual ~OutputSink() = default;
+
+    /**
+     * @brief Maximum number of rows per vertex or face chunk.
+     */
+    virtual size_t get_chunk_size() const { return size_t(1) << 16; }
+
+    /**
+     * @brief Called once before any chunk.
+     *
+     * @param num_vertices Number of output vertices.
+     * @param num_faces Number of output faces.
+     */
+    virtual void begin(size_t /*num_vertices*/, size_t /*num_faces*/) {}
+
+    /**
+     * @brief Receive a chunk of output vertices.
+     *
+     * @param offset Index of the first vertex of the chunk.
+     * @param vertices Vertices of the chunk.
+     * @param exact_vertices Rational coordinates of the chunk in row-major
+     * order if exact output is enabled, empty otherwise.
+     */
+    virtual void write_vertices(size_t offset,
+        const MatrixFr& vertices,
+        const std::vector<std::string>& exact_vertices) = 0;
+
+    /**
+     * @brief Receive a chunk of output faces.
+     *
+     * @param offset Index of the first face of the chunk.
+     * @param faces Faces of the chunk.
+     * @param face_labels Labels of the faces of the chunk.
+     * @param patches Patch index of the faces of the chunk, empty if patches
+     * are not computed.
+     */
+    virtual void write_faces(size_t offset,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        const VectorI& patches) = 0;
+
+    /**
+     * @brief Receive the cells on the positive and negative side of each patch
+     * (#patches x 2).  Only called if cells are computed.
+     */
+    virtual void write_cells(const MatrixIr& /*cells*/) {}
+
+    /**
+     * @brief Receive the winding numbers of the cells.  Only called if
+     * winding numbers are computed.
+     */
+    virtual void write_winding_numbers(const MatrixIr& /*winding_number*/) {}
+
+    /**
+     * @brief Called once after the last chunk.
+     */
+    virtual void end() {}
+};
+
+} // namespace arrangement
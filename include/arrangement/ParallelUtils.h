@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace arrangement {
+namespace ParallelUtils {
+
+/**
+ * Resolve a requested thread count.  A request of 0 means "use all hardware
+ * threads".
+ */
+inline size_t resolve_num_threads(size_t num_threads)
+{
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    return num_threads;
+}
+
+/**
+ * Split [0, n) into contiguous chunks and call fn(chunk_begin, chunk_end) for
+ * each chunk, one chunk per thread.  Ranges smaller than `grain_size` are
+ * processed on the calling thread.
+ *
+ * Exceptions thrown by fn are captured and the first one is rethrown on the
+ * calling thread once all chunks are done.
+ */
+template <typename Fn>
+void parallel_for(size_t n, Fn&& fn, size_t num_threads = 0, size_t grain_size = 1024)
+{
+    if (n == 0) return;
+    num_threads = std::min(resolve_num_threads(num_threads), (n + grain_size - 1) / grain_size);
+    if (num_threads <= 1) {
+        fn(size_t(0), n);
+        return;
+    }
+
+    const size_t chunk_size = (n + num_threads - 1) / num_threads;
+    std::vector<std::exception_ptr> errors(num_threads);
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    auto process_chunk = [&](size_t chunk) {
+        const size_t begin = chunk * chunk_size;
+        const size_t end = std::min(n, begin + chunk_size);
+        if (begin >= end) return;
+        try {
+            fn(begin, end);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+    for (size_t i = 1; i < num_threads; i++) {
+        workers.emplace_back(process_chunk, i);
+    }
+    process_chunk(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& err : errors) {
+        if (err) std::rethrow_exception(err);
+    }
+}
+
+} // namespace ParallelUtils
+} // namespace arrangement
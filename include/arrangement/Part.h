@@ -0,0 +1,56 @@
+#pragma once
+
+#include "EigenTypedef.h"
+
+#include <Eigen/Geometry>
+
+#include <memory>
+#include <vector>
+
+namespace arrangement {
+
+/**
+ * One part of a multi-part input, e.g. an instance in an assembly.
+ *
+ * Buffers are shared, not copied: instances of the same mesh can point to the
+ * same vertices and faces with different transforms.  The engine factories
+ * taking parts write the transformed vertices directly into the engine input,
+ * so no concatenated copy of the assembly is made by the caller.
+ */
+struct Part
+{
+    /// MatrixFr of size #vertices by 3, in the part's own frame.
+    std::shared_ptr<const MatrixFr> vertices;
+
+    /// MatrixIr of size #faces by 3, indexing this part's vertices.
+    std::shared_ptr<const MatrixIr> faces;
+
+    /// Placement of the part.  A transform with a reflection reverses the
+    /// faces, so that their orientation is kept.
+    Eigen::Affine3d transform = Eigen::Affine3d::Identity();
+
+    /// Label of all faces of the part, -1 (default) for the part index.
+    int label = -1;
+
+    /// Optional VectorI of size #faces of per-face labels, overriding `label`.
+    std::shared_ptr<const VectorI> face_labels;
+};
+
+/**
+ * Concatenate parts into a single input, applying their transforms.
+ *
+ * Faces are ordered part by part, so that face indices (e.g. of a region of
+ * interest face mask) follow the order of `parts`.
+ *
+ * @param[in] parts Parts of the input.
+ * @param[out] vertices MatrixFr of size #vertices by 3.
+ * @param[out] faces MatrixIr of size #faces by 3.
+ * @param[out] face_labels VectorI of size #faces.
+ *
+ * @throws RuntimeError if a part lacks vertices or faces, or if its face
+ * labels do not match its faces.
+ */
+void assemble_parts(
+    const std::vector<Part>& parts, MatrixFr& vertices, MatrixIr& faces, VectorI& face_labels);
+
+} // namespace arrangement
@@ -0,0 +1,92 @@
+#pragma once
+
+#ifdef ARRANGEMENT_IGL
+
+#include "Arrangement.h"
+
+#include <memory>
+
+namespace arrangement {
+
+/**
+ * Arrangement engine for inputs whose faces all lie in one plane or in a few
+ * parallel planes (stacked sheets, sketches, layered geometry).
+ *
+ * Each plane is projected to 2D along its dominant axis and the edges of its
+ * faces are inserted as constraints of an exact constrained Delaunay
+ * triangulation.  Every triangle of the triangulation covered by an input face
+ * is output once per covering face, with its orientation and label, as the 3D
+ * engines do for overlapping coplanar faces.  Patches, cells and winding
+ * numbers are then computed from the exact resolved mesh like in the mesh
+ * engine.  The triangulation of the output may differ from the 3D engines,
+ * its geometry and topology do not.
+ *
+ * Region of interest and quantized input are not supported.
+ */
+class PlanarArrangement final : public Arrangement
+{
+public:
+    using Base = Arrangement;
+
+public:
+    PlanarArrangement(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels);
+    ~PlanarArrangement();
+
+    /**
+     * @throws RuntimeError if the faces do not lie in at most
+     * get_max_num_planes() parallel planes.
+     */
+    void run() override;
+
+    /**
+     * @brief Replace the input, see Arrangement::reset().
+     */
+    void reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels) override;
+
+    /**
+     * @brief Find the parallel planes holding all faces, exactly.
+     *
+     * Degenerate faces belong to a plane as long as their vertices do.
+     *
+     * @param vertices MatrixFr of size #vertices by 3.
+     * @param faces MatrixIr of size #faces by 3.
+     * @param max_num_planes Give up beyond this number of planes.
+     *
+     * @return VectorI of size #faces giving the plane index of each face, or
+     * an empty vector if the faces are not planar or need more planes.
+     */
+    static VectorI detect_planes(const MatrixFr& vertices,
+        const MatrixIr& faces,
+        size_t max_num_planes = get_max_num_planes());
+
+    /**
+     * @brief Get the maximum number of parallel planes run() accepts.
+     */
+    static constexpr size_t get_max_num_planes() { return 64; }
+
+protected:
+    void compute_topology(unsigned stages) const override;
+
+private:
+    /**
+     * Write the output from the resolved state and compute the eager
+     * topology stages.
+     */
+    void extract_arrangement();
+
+private:
+    struct State;
+    std::unique_ptr<State> m_state;
+
+    using Base::m_cells;
+    using Base::m_faces;
+    using Base::m_in_face_labels;
+    using Base::m_out_face_labels;
+    using Base::m_patches;
+    using Base::m_vertices;
+    using Base::m_winding_number;
+};
+
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <limits>
+
+#include "AABBTree.h"
+#include "Arrangement.h"
+
+namespace arrangement {
+
+/**
+ * Point location index built from the result of an arrangement.
+ *
+ * A query shoots a ray from the query point through a bounding volume
+ * hierarchy over the output faces.  The first face hit and the side it is hit
+ * from determine the containing cell via the patch/cell topology of the
+ * arrangement.  Rays that hit near an edge, a vertex or a nearly coincident
+ * face are retried along a different direction.  Points on the output surface
+ * itself, within numerical tolerance, belong to no cell.
+ */
+class PointLocator
+{
+public:
+    /// Winding number reported for points that belong to no cell.
+    static constexpr Index UNKNOWN_WINDING_NUMBER = std::numeric_limits<Index>::min();
+
+    /**
+     * @brief Build the index.
+     *
+     * The arrangement must have been run and must provide cell topology.  It
+     * must outlive the locator.
+     *
+     * @param arrangement The arrangement result.
+     * @param label_groups VectorI indexed by input face label giving the group
+     * index used for winding numbers, see
+     * Arrangement::get_cell_winding_numbers().  If empty, all labels form a
+     * single group.
+     */
+    PointLocator(const Arrangement& arrangement, const VectorI& label_groups = VectorI());
+
+    /**
+     * @brief Find the cell containing each query point.
+     *
+     * @param points MatrixFr of size #points by 3.
+     *
+     * @return VectorI of size #points with the cell index of each point, -1
+     * for points on the surface, see locate(const Vector3F&).
+     */
+    VectorI locate(const MatrixFr& points) const;
+
+    /**
+     * @brief Compute the winding numbers of each query point.
+     *
+     * @param points MatrixFr of size #points by 3.
+     *
+     * @return MatrixIr of size #points by #groups.  Rows of points on the
+     * surface are set to UNKNOWN_WINDING_NUMBER.
+     */
+    MatrixIr compute_winding_numbers(const MatrixFr& points) const;
+
+    /**
+     * @brief Find the cell containing a single point.
+     *
+     * @return The cell index, or -1 if every ray shot from the point is
+     * ambiguous.  This is the case of points on the output surface.
+     */
+    int locate(const Vector3F& point) const;
+
+    /**
+     * @brief Get the per-cell winding numbers used by this locator.
+     *
+     * @return MatrixIr of size #cells by #groups.
+     */
+    const MatrixIr& get_cell_winding_numbers() const { return m_cell_winding_numbers; }
+
+    /**
+     * @brief Set the number of threads used by batched queries (0 means all
+     * hardware threads).  Defaults to the thread count of the arrangement.
+     */
+    void set_num_threads(size_t num_threads) { m_num_threads = num_threads; }
+
+    /**
+     * @brief Get the number of threads used by batched queries.
+     */
+    size_t get_num_threads() const { return m_num_threads; }
+
+private:
+    const Arrangement& m_arrangement;
+    AABBTree m_tree;
+    MatrixIr m_cell_winding_numbers;
+    size_t m_num_threads = 0;
+};
+
+} // namespace arrangement
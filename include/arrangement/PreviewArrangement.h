@@ -0,0 +1,173 @@
+#pragma once
+
+#include "Arrangement.h"
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace arrangement {
+
+/**
+ * Arrangement engine that quickly computes an approximate result on a
+ * simplified proxy of its input, for interactive previews.
+ *
+ * The proxy is obtained by vertex clustering: vertices are merged per cell of
+ * a uniform grid and faces that collapse are dropped (see compute_proxy()).
+ * Its faces keep their input labels, so the preview has the same kind of
+ * patches, cells and winding numbers as the full result, only coarser.
+ *
+ * run() arranges proxies of increasing resolution, starting with
+ * get_proxy_resolution() grid cells along the bounding box diagonal and
+ * doubling it, as long as the next level is expected to fit in the time
+ * budget.  The first level always runs.  Once the grid is fine enough for no
+ * vertices to be merged, the full input is arranged instead and the result is
+ * exact.
+ *
+ * With a refine callback, run() then starts arranging the full input with the
+ * same engine on a background thread and passes the result to the callback.
+ * This engine keeps the preview.  Incremental updates are not supported.
+ */
+class PreviewArrangement final : public Arrangement
+{
+public:
+    using Base = Arrangement;
+
+    /**
+     * Called from the background thread with the full arrangement, or with
+     * nullptr and the error message if it failed.  When the preview is
+     * already exact, called from run() with the engine of the preview, after
+     * copying its topology: the preview no longer uses the engine.  It must
+     * not throw.
+     */
+    using RefineCallback = std::function<void(Ptr arrangement, const std::string& error)>;
+
+    /**
+     * Simplified input.
+     */
+    struct Proxy
+    {
+        MatrixFr vertices;
+        MatrixIr faces;
+        VectorI face_labels;
+        std::vector<size_t> source_faces; ///< Input face of each proxy face.
+    };
+
+public:
+    PreviewArrangement(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+        : Base(std::move(vertices), faces, face_labels)
+    {}
+
+    /**
+     * Wait for the refinement started by the last run(), if any.
+     */
+    ~PreviewArrangement();
+
+    void run() override;
+
+    /**
+     * @brief Replace the input, see Arrangement::reset().  Waits for the
+     * refinement started by the last run(), if any.
+     */
+    void reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels) override;
+
+    /**
+     * @brief Compute a proxy of the input by vertex clustering.
+     *
+     * Vertices referenced by the faces are merged per cell of a uniform grid
+     * and replaced by their mean.  Faces with two corners in the same cell are
+     * dropped.
+     *
+     * @param grid_size Size of the grid cells.  0 keeps all vertices and
+     * faces.
+     */
+    static Proxy compute_proxy(const MatrixFr& vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        Float grid_size);
+
+    /**
+     * @brief Set the time after which no further proxy level is started.
+     *
+     * The time of the next level is predicted from the previous one, assuming
+     * it grows linearly with the number of proxy faces.
+     *
+     * @param seconds Time budget in seconds.  0 (default) runs the first level
+     * only.
+     */
+    void set_time_budget(const Float seconds) { m_time_budget = seconds; }
+
+    /**
+     * @brief Get the time budget in seconds.
+     */
+    Float get_time_budget() const { return m_time_budget; }
+
+    /**
+     * @brief Set the number of grid cells along the bounding box diagonal of
+     * the first proxy level (default 32).
+     */
+    void set_proxy_resolution(const size_t resolution) { m_proxy_resolution = resolution; }
+
+    /**
+     * @brief Get the number of grid cells along the bounding box diagonal of
+     * the first proxy level.
+     */
+    size_t get_proxy_resolution() const { return m_proxy_resolution; }
+
+    /**
+     * @brief Set the engine arranging the proxies and the full input.
+     *
+     * @param engine "auto" (default), or any engine of EngineRegistry.
+     */
+    void set_engine(const std::string& engine) { m_engine_name = engine; }
+
+    /**
+     * @brief Get the engine arranging the proxies and the full input.
+     */
+    const std::string& get_engine() const { return m_engine_name; }
+
+    /**
+     * @brief Set the callback receiving the full arrangement, computed in the
+     * background after each run().  Empty (default) means no refinement.
+     */
+    void set_refine_callback(RefineCallback callback) { m_refine_callback = std::move(callback); }
+
+    /**
+     * @brief Whether the result of the last run() was computed on a proxy
+     * rather than the full input.
+     */
+    bool is_approximate() const { return m_approximate; }
+
+    /**
+     * @brief Wait for the refinement started by the last run(), if any.  The
+     * callback has returned when this returns.
+     */
+    void wait_for_refinement();
+
+protected:
+    /**
+     * Pull the requested stages from the engine of the preview, which
+     * computes them lazily if needed.
+     */
+    void compute_topology(unsigned stages) const override;
+
+private:
+    Ptr create_engine(MatrixFr vertices,
+        const MatrixIr& faces,
+        const VectorI& face_labels,
+        bool full_input) const;
+    void copy_result();
+    void start_refinement(MatrixFr vertices, MatrixIr faces, VectorI face_labels);
+
+private:
+    Float m_time_budget = 0;
+    size_t m_proxy_resolution = 32;
+    std::string m_engine_name = "auto";
+    RefineCallback m_refine_callback;
+    bool m_approximate = false;
+    Ptr m_engine;
+    std::thread m_refine_thread;
+};
+
+} // namespace arrangement
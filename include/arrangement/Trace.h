@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace arrangement {
+namespace Trace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+/**
+ * Whether tracing is compiled in, i.e. the library was configured with
+ * ARRANGEMENT_WITH_TRACE.  Without it, spans compile to nothing and start()
+ * throws.
+ */
+bool is_available();
+
+/**
+ * Start recording spans from all threads, discarding previous ones.
+ *
+ * @throws NotImplementedError if tracing is not compiled in.
+ */
+void start();
+
+/**
+ * Stop recording and write the spans as a Chrome trace-event JSON file, which
+ * loads in Perfetto (ui.perfetto.dev) and chrome://tracing.
+ *
+ * @param filename Output JSON file.
+ *
+ * @throws RuntimeError if no recording is in progress or the file cannot be
+ * written.
+ */
+void stop(const std::string& filename);
+
+/**
+ * Whether spans are being recorded.
+ */
+bool is_recording();
+
+/**
+ * Record a span of the calling thread.  Does nothing unless recording.
+ *
+ * @param name Span name.
+ * @param category Span category, e.g. "stage" or "worker".
+ * @param begin Start time.
+ * @param end End time.
+ */
+void record_span(
+    std::string_view name, const char* category, Clock::time_point begin, Clock::time_point end);
+
+/**
+ * Name the calling thread in the trace.  Threads without a name show up by
+ * their trace id.
+ */
+void set_thread_name(std::string_view name);
+
+/**
+ * Record the lifetime of a scope as a span.  Use through
+ * ARRANGEMENT_TRACE_SCOPE(), which compiles to nothing when tracing is
+ * disabled.
+ */
+class ScopedSpan
+{
+public:
+    explicit ScopedSpan(const char* name, const char* category = "stage")
+        : m_name(name)
+        , m_category(category)
+        , m_begin(Clock::now())
+    {}
+
+    ~ScopedSpan() { record_span(m_name, m_category, m_begin, Clock::now()); }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+private:
+    const char* m_name;
+    const char* m_category;
+    Clock::time_point m_begin;
+};
+
+} // namespace Trace
+} // namespace arrangement
+
+#ifdef ARRANGEMENT_WITH_TRACE
+#define ARRANGEMENT_TRACE_CONCAT_IMPL(a, b) a##b
+#define ARRANGEMENT_TRACE_CONCAT(a, b) ARRANGEMENT_TRACE_CONCAT_IMPL(a, b)
+/// Record the enclosing scope as a span named `name` (a string literal).
+#define ARRANGEMENT_TRACE_SCOPE(name) \
+    ::arrangement::Trace::ScopedSpan ARRANGEMENT_TRACE_CONCAT(arrangement_trace_span_, __LINE__)(name)
+#else
+#define ARRANGEMENT_TRACE_SCOPE(name) ((void)0)
+#endif
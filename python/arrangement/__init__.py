@@ -1,3 +1,15 @@
 __version__ = '0.3.0'
 
-from .pyarrangement import Arrangement
+from .pyarrangement import (
+    Arrangement,
+    Part,
+    PreviewArrangement,
+    get_engine_names,
+    get_plugin_load_times,
+    is_allocation_counting_enabled,
+    is_engine_available,
+    is_trace_available,
+    load_engine_plugin,
+    start_trace,
+    stop_trace,
+)
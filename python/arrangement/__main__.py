@@ -24,11 +24,36 @@ def parse_args():
         "--engine",
         help="Arrangement engine",
         default="mesh",
-        choices=["mesh", "fast", "geogram"],
+        choices=["mesh", "fast", "geogram", "planar", "auto"],
     )
     parser.add_argument(
         "-x", "--export-cells", action="store_true", help="Export cells"
     )
+    parser.add_argument(
+        "-j", "--threads", type=int, default=0, help="Maximum number of threads (0 for all)"
+    )
+    parser.add_argument(
+        "-t",
+        "--timeout",
+        type=float,
+        default=0,
+        help="Time limit per attempt of the auto engine in seconds (0 for none)",
+    )
+    parser.add_argument(
+        "-g",
+        "--grid-size",
+        type=float,
+        default=None,
+        help="Quantize the input to a grid of this spacing (0 to pick one, fast engine only)",
+    )
+    parser.add_argument(
+        "-m", "--merge-coplanar", action="store_true", help="Merge coplanar output faces"
+    )
+    parser.add_argument(
+        "--trace",
+        default=None,
+        help="Write a Chrome trace-event JSON file of the run (requires ARRANGEMENT_WITH_TRACE)",
+    )
     parser.add_argument("-o", "--output", help="Output file", required=True)
     parser.add_argument("-v", "--verbose", action="store_true", help="Verbose output")
     parser.add_argument("input_meshes", nargs="+", help="Input mesh files")
@@ -38,30 +63,47 @@ def parse_args():
 def main():
     args = parse_args()
     meshes = [lagrange.io.load_mesh(f) for f in args.input_meshes]
-    for i, mesh in enumerate(meshes):
-        mesh.create_attribute("mesh_id", initial_values=np.ones(mesh.num_facets) * i)
 
-    mesh = lagrange.combine_meshes(meshes)
+    # One part per input mesh, labeled with the global facet index of the
+    # concatenated input.
+    parts = []
+    facet_offset = 0
+    for mesh in meshes:
+        parts.append(
+            arrangement.Part(
+                mesh.vertices,
+                mesh.facets,
+                face_labels=np.arange(facet_offset, facet_offset + mesh.num_facets),
+            )
+        )
+        facet_offset += mesh.num_facets
 
     if args.engine == "mesh":
-        engine = arrangement.Arrangement.create_mesh_arrangement(
-            mesh.vertices, mesh.facets, np.arange(mesh.num_facets)
-        )
+        engine = arrangement.Arrangement.create_mesh_arrangement(parts)
     elif args.engine == "fast":
-        engine = arrangement.Arrangement.create_fast_arrangement(
-            mesh.vertices, mesh.facets, np.arange(mesh.num_facets)
-        )
+        engine = arrangement.Arrangement.create_fast_arrangement(parts)
     elif args.engine == "geogram":
-        engine = arrangement.Arrangement.create_geogram_arrangement(
-            mesh.vertices, mesh.facets, np.arange(mesh.num_facets)
-        )
+        engine = arrangement.Arrangement.create_geogram_arrangement(parts)
+    elif args.engine == "planar":
+        engine = arrangement.Arrangement.create_planar_arrangement(parts)
+    elif args.engine == "auto":
+        engine = arrangement.Arrangement.create_auto_arrangement(parts)
+        engine.timeout = args.timeout
     else:
         raise ValueError(f"Unknown engine: {args.engine}")
 
     if args.verbose:
         engine.verbose = True
+    engine.num_threads = args.threads
+    engine.merge_coplanar = args.merge_coplanar
+    if args.grid_size is not None:
+        engine.set_quantization(True, args.grid_size)
 
+    if args.trace is not None:
+        arrangement.start_trace()
     engine.run()
+    if args.verbose:
+        print(f"Metrics: {engine.metrics.timings} {engine.metrics.notes}")
 
     output_mesh = lagrange.SurfaceMesh()
     output_mesh.add_vertices(engine.vertices)
@@ -70,7 +112,7 @@ def main():
     output_mesh.create_attribute("src_facet_id", initial_values=engine.face_labels)
     output_mesh.create_attribute("patch_id", initial_values=engine.patches)
 
-    if args.engine == "mesh":
+    if engine.metrics.notes.get("engine", args.engine) == "mesh":
         winding_number = engine.winding_number
         assert (
             winding_number.shape[0] == output_mesh.num_facets
@@ -133,6 +175,10 @@ def main():
     cells = lagrange.combine_meshes(cells)
     lagrange.io.save_mesh(output_dir / f"{Path(args.output).stem}_cells.msh", cells)
 
+    if args.trace is not None:
+        # Includes the topology stages computed lazily above.
+        arrangement.stop_trace(args.trace)
+
 
 if __name__ == "__main__":
     main()
@@ -0,0 +1,85 @@
+#!/usr/bin/env python
+"""
+Compare the startup time of arrangement builds, e.g. a static build and a
+plugin build (ARRANGEMENT_ENGINE_PLUGINS=ON).
+
+Each build is a directory holding the installed `arrangement` package, such as
+the target of `pip install --target <dir> .`.  For each build, fresh
+interpreters time the import of the package alone, then the import followed by
+a first run of the engine on a tet, which loads the engine module in plugin
+builds.
+
+Example:
+  python python/benchmarks/startup_time.py -e mesh build_static build_plugins
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import time
+
+IMPORT = "import arrangement"
+
+FIRST_RUN = """
+import json
+import numpy as np
+import arrangement
+V = np.array([[0, 0, 0], [1, 0, 0], [0, 1, 0], [0, 0, 1]], dtype=np.float64)
+F = np.array([[0, 2, 1], [0, 1, 3], [0, 3, 2], [1, 2, 3]], dtype=np.int32)
+create = getattr(arrangement.Arrangement, "create_{engine}_arrangement")
+engine = create(V, F, np.arange(4, dtype=np.int32))
+engine.run()
+print(json.dumps(arrangement.get_plugin_load_times()))
+"""
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawTextHelpFormatter,
+    )
+    parser.add_argument("builds", nargs="+", help="Directories holding the package")
+    parser.add_argument("-e", "--engine", default="mesh", choices=["mesh", "fast", "geogram"])
+    parser.add_argument("-n", "--runs", type=int, default=20, help="Runs per measurement")
+    return parser.parse_args()
+
+
+def time_snippet(build, code, runs):
+    env = dict(os.environ, PYTHONPATH=os.path.abspath(build))
+    times = []
+    output = ""
+    for _ in range(runs):
+        start = time.perf_counter()
+        result = subprocess.run(
+            [sys.executable, "-c", code], env=env, capture_output=True, text=True
+        )
+        times.append(time.perf_counter() - start)
+        if result.returncode != 0:
+            sys.exit(f"{build}: {result.stderr.strip()}")
+        output = result.stdout
+    return times, output
+
+
+def main():
+    args = parse_args()
+    baseline, _ = time_snippet(args.builds[0], "pass", args.runs)
+    interpreter = min(baseline)
+    print(f"Interpreter startup: {interpreter * 1000:.1f} ms (subtracted below)")
+    print(f"{'build':<30} {'import (ms)':>14} {'first ' + args.engine + ' run (ms)':>22}")
+    for build in args.builds:
+        import_times, _ = time_snippet(build, IMPORT, args.runs)
+        run_times, output = time_snippet(
+            build, FIRST_RUN.format(engine=args.engine), args.runs
+        )
+        import_ms = (statistics.median(import_times) - interpreter) * 1000
+        run_ms = (statistics.median(run_times) - interpreter) * 1000
+        print(f"{os.path.basename(os.path.normpath(build)):<30} {import_ms:>14.1f} {run_ms:>22.1f}")
+        for module, seconds in json.loads(output).items():
+            print(f"  loaded {os.path.basename(module)} in {seconds * 1000:.1f} ms")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,23 +1,348 @@
 #include <arrangement/Arrangement.h>
+#include <arrangement/AutoArrangement.h>
+#include <arrangement/EngineRegistry.h>
+#include <arrangement/OutputSink.h>
+#include <arrangement/PointLocator.h>
+#include <arrangement/PreviewArrangement.h>
+#include <arrangement/Trace.h>
 
 #include <nanobind/eigen/dense.h>
 #include <nanobind/nanobind.h>
+#include <nanobind/stl/function.h>
+#include <nanobind/stl/map.h>
+#include <nanobind/stl/optional.h>
 #include <nanobind/stl/shared_ptr.h>
+#include <nanobind/stl/string.h>
+#include <nanobind/stl/vector.h>
+#include <nanobind/trampoline.h>
 
 namespace nb = nanobind;
 
+namespace {
+
+// Lets Python subclasses of OutputSink receive the output chunks.
+class PyOutputSink : public arrangement::OutputSink
+{
+public:
+    NB_TRAMPOLINE(arrangement::OutputSink, 7);
+
+    size_t get_chunk_size() const override { NB_OVERRIDE(get_chunk_size); }
+
+    void begin(size_t num_vertices, size_t num_faces) override
+    {
+        NB_OVERRIDE(begin, num_vertices, num_faces);
+    }
+
+    void write_vertices(size_t offset,
+        const arrangement::MatrixFr& vertices,
+        const std::vector<std::string>& exact_vertices) override
+    {
+        NB_OVERRIDE_PURE(write_vertices, offset, vertices, exact_vertices);
+    }
+
+    void write_faces(size_t offset,
+        const arrangement::MatrixIr& faces,
+        const arrangement::VectorI& face_labels,
+        const arrangement::VectorI& patches) override
+    {
+        NB_OVERRIDE_PURE(write_faces, offset, faces, face_labels, patches);
+    }
+
+    void write_cells(const arrangement::MatrixIr& cells) override
+    {
+        NB_OVERRIDE(write_cells, cells);
+    }
+
+    void write_winding_numbers(const arrangement::MatrixIr& winding_number) override
+    {
+        NB_OVERRIDE(write_winding_numbers, winding_number);
+    }
+
+    void end() override { NB_OVERRIDE(end); }
+};
+
+} // namespace
+
 NB_MODULE(pyarrangement, m)
 {
+    nb::enum_<arrangement::MeshKernel>(m, "MeshKernel")
+        .value("Epeck", arrangement::MeshKernel::Epeck)
+        .value("Rational", arrangement::MeshKernel::Rational)
+        .value("Gmpq", arrangement::MeshKernel::Gmpq)
+        .value("BoostRational", arrangement::MeshKernel::BoostRational)
+        .value("Leda", arrangement::MeshKernel::Leda);
+
+    nb::enum_<arrangement::BooleanOperation>(m, "BooleanOperation")
+        .value("Union", arrangement::BooleanOperation::Union)
+        .value("Intersection", arrangement::BooleanOperation::Intersection)
+        .value("Difference", arrangement::BooleanOperation::Difference)
+        .value("SymmetricDifference", arrangement::BooleanOperation::SymmetricDifference);
+
+    // Topology stages are bit flags, exposed as plain integers.
+    m.attr("TOPOLOGY_NONE") = static_cast<unsigned>(arrangement::TOPOLOGY_NONE);
+    m.attr("TOPOLOGY_PATCHES") = static_cast<unsigned>(arrangement::TOPOLOGY_PATCHES);
+    m.attr("TOPOLOGY_CELLS") = static_cast<unsigned>(arrangement::TOPOLOGY_CELLS);
+    m.attr("TOPOLOGY_WINDING_NUMBERS") =
+        static_cast<unsigned>(arrangement::TOPOLOGY_WINDING_NUMBERS);
+    m.attr("TOPOLOGY_ALL") = static_cast<unsigned>(arrangement::TOPOLOGY_ALL);
+
+    // Chrome trace-event export, see arrangement/Trace.h.
+    m.def("is_trace_available", &arrangement::Trace::is_available);
+    m.def("start_trace", &arrangement::Trace::start);
+    m.def("stop_trace", &arrangement::Trace::stop, nb::arg("filename"));
+    m.def("is_allocation_counting_enabled",
+        &arrangement::MemoryUtils::is_allocation_counting_enabled);
+    m.def("get_engine_names", &arrangement::EngineRegistry::get_engine_names);
+    m.def("is_engine_available", &arrangement::EngineRegistry::is_available, nb::arg("name"));
+    m.def("load_engine_plugin", &arrangement::EngineRegistry::load_plugin, nb::arg("filename"));
+    m.def("get_plugin_load_times", &arrangement::EngineRegistry::get_plugin_load_times);
+
+    nb::class_<arrangement::RegionOfInterest>(m, "RegionOfInterest")
+        .def(nb::init<>())
+        .def_static("from_box",
+            &arrangement::RegionOfInterest::from_box,
+            nb::arg("box_min"),
+            nb::arg("box_max"))
+        .def_static("from_face_mask",
+            &arrangement::RegionOfInterest::from_face_mask,
+            nb::arg("face_mask"))
+        .def_prop_ro("empty", &arrangement::RegionOfInterest::empty);
+
+    nb::class_<arrangement::Part>(m, "Part")
+        .def(
+            "__init__",
+            [](arrangement::Part* part,
+                arrangement::MatrixFr vertices,
+                arrangement::MatrixIr faces,
+                const Eigen::Matrix4d& transform,
+                int label,
+                std::optional<arrangement::VectorI> face_labels) {
+                new (part) arrangement::Part();
+                part->vertices = std::make_shared<const arrangement::MatrixFr>(std::move(vertices));
+                part->faces = std::make_shared<const arrangement::MatrixIr>(std::move(faces));
+                part->transform.matrix() = transform;
+                part->label = label;
+                if (face_labels.has_value()) {
+                    part->face_labels =
+                        std::make_shared<const arrangement::VectorI>(std::move(*face_labels));
+                }
+            },
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            nb::arg("transform") = Eigen::Matrix4d::Identity().eval(),
+            nb::arg("label") = -1,
+            nb::arg("face_labels") = nb::none())
+        .def("instance",
+            [](const arrangement::Part& part, const Eigen::Matrix4d& transform, int label) {
+                // Shares the buffers of `part`.
+                arrangement::Part instance = part;
+                instance.transform.matrix() = transform;
+                instance.label = label;
+                return instance;
+            },
+            nb::arg("transform"),
+            nb::arg("label") = -1)
+        .def_prop_ro("transform",
+            [](const arrangement::Part& part) -> Eigen::Matrix4d {
+                return part.transform.matrix();
+            })
+        .def_ro("label", &arrangement::Part::label);
+
+    nb::class_<arrangement::IntersectionCurves>(m, "IntersectionCurves")
+        .def_ro("vertices", &arrangement::IntersectionCurves::vertices)
+        .def_ro("segments", &arrangement::IntersectionCurves::segments)
+        .def_ro("face_pairs", &arrangement::IntersectionCurves::face_pairs)
+        .def_ro("polylines", &arrangement::IntersectionCurves::polylines)
+        .def_ro("num_coplanar_pairs", &arrangement::IntersectionCurves::num_coplanar_pairs);
+
+    nb::class_<arrangement::MemoryUtils::StageMemory>(m, "StageMemory")
+        .def_ro("peak_rss_delta", &arrangement::MemoryUtils::StageMemory::peak_rss_delta)
+        .def_ro("num_allocations", &arrangement::MemoryUtils::StageMemory::num_allocations)
+        .def_ro("allocated_bytes", &arrangement::MemoryUtils::StageMemory::allocated_bytes);
+
+    nb::class_<arrangement::Metrics>(m, "Metrics")
+        .def_ro("timings", &arrangement::Metrics::timings)
+        .def_ro("values", &arrangement::Metrics::values)
+        .def_ro("notes", &arrangement::Metrics::notes)
+        .def_ro("memory", &arrangement::Metrics::memory);
+
+    nb::class_<arrangement::OutputSink, PyOutputSink>(m, "OutputSink")
+        .def(nb::init<>())
+        .def("get_chunk_size", &arrangement::OutputSink::get_chunk_size)
+        .def("begin",
+            &arrangement::OutputSink::begin,
+            nb::arg("num_vertices"),
+            nb::arg("num_faces"))
+        .def("write_vertices",
+            &arrangement::OutputSink::write_vertices,
+            nb::arg("offset"),
+            nb::arg("vertices"),
+            nb::arg("exact_vertices"))
+        .def("write_faces",
+            &arrangement::OutputSink::write_faces,
+            nb::arg("offset"),
+            nb::arg("faces"),
+            nb::arg("face_labels"),
+            nb::arg("patches"))
+        .def("write_cells", &arrangement::OutputSink::write_cells, nb::arg("cells"))
+        .def("write_winding_numbers",
+            &arrangement::OutputSink::write_winding_numbers,
+            nb::arg("winding_number"))
+        .def("end", &arrangement::OutputSink::end);
+
     nb::class_<arrangement::Arrangement>(m, "Arrangement")
-        .def_static("create_mesh_arrangement", &arrangement::Arrangement::create_mesh_arrangement)
-        .def_static("create_fast_arrangement", &arrangement::Arrangement::create_fast_arrangement)
-        .def_static(
-            "create_geogram_arrangement", &arrangement::Arrangement::create_geogram_arrangement)
+        .def_static("create_mesh_arrangement",
+            [](const arrangement::MatrixF32r& vertices,
+                const arrangement::MatrixIr& faces,
+                const arrangement::VectorI& face_labels,
+                const arrangement::RegionOfInterest& region_of_interest,
+                arrangement::MeshKernel kernel) {
+                return arrangement::Arrangement::create_mesh_arrangement(
+                    vertices, faces, face_labels, region_of_interest, kernel);
+            },
+            nb::arg("vertices").noconvert(),
+            nb::arg("faces"),
+            nb::arg("face_labels"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest(),
+            nb::arg("kernel") = arrangement::MeshKernel::Epeck)
+        .def_static("create_mesh_arrangement",
+            nb::overload_cast<arrangement::MatrixFr,
+                const arrangement::MatrixIr&,
+                const arrangement::VectorI&,
+                const arrangement::RegionOfInterest&,
+                arrangement::MeshKernel>(&arrangement::Arrangement::create_mesh_arrangement),
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            nb::arg("face_labels"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest(),
+            nb::arg("kernel") = arrangement::MeshKernel::Epeck)
+        .def_static("create_mesh_arrangement",
+            nb::overload_cast<const std::vector<arrangement::Part>&,
+                const arrangement::RegionOfInterest&,
+                arrangement::MeshKernel>(&arrangement::Arrangement::create_mesh_arrangement),
+            nb::arg("parts"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest(),
+            nb::arg("kernel") = arrangement::MeshKernel::Epeck)
+        .def_static("create_fast_arrangement",
+            [](const arrangement::MatrixF32r& vertices,
+                const arrangement::MatrixIr& faces,
+                const arrangement::VectorI& face_labels,
+                const arrangement::RegionOfInterest& region_of_interest) {
+                return arrangement::Arrangement::create_fast_arrangement(
+                    vertices, faces, face_labels, region_of_interest);
+            },
+            nb::arg("vertices").noconvert(),
+            nb::arg("faces"),
+            nb::arg("face_labels"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest())
+        .def_static("create_fast_arrangement",
+            nb::overload_cast<arrangement::MatrixFr,
+                const arrangement::MatrixIr&,
+                const arrangement::VectorI&,
+                const arrangement::RegionOfInterest&>(
+                &arrangement::Arrangement::create_fast_arrangement),
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            nb::arg("face_labels"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest())
+        .def_static("create_fast_arrangement",
+            nb::overload_cast<const std::vector<arrangement::Part>&, const arrangement::RegionOfInterest&>(
+                &arrangement::Arrangement::create_fast_arrangement),
+            nb::arg("parts"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest())
+        .def_static("create_geogram_arrangement",
+            [](const arrangement::MatrixF32r& vertices,
+                const arrangement::MatrixIr& faces,
+                const arrangement::VectorI& face_labels,
+                const arrangement::RegionOfInterest& region_of_interest) {
+                return arrangement::Arrangement::create_geogram_arrangement(
+                    vertices, faces, face_labels, region_of_interest);
+            },
+            nb::arg("vertices").noconvert(),
+            nb::arg("faces"),
+            nb::arg("face_labels"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest())
+        .def_static("create_geogram_arrangement",
+            nb::overload_cast<arrangement::MatrixFr,
+                const arrangement::MatrixIr&,
+                const arrangement::VectorI&,
+                const arrangement::RegionOfInterest&>(
+                &arrangement::Arrangement::create_geogram_arrangement),
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            nb::arg("face_labels"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest())
+        .def_static("create_geogram_arrangement",
+            nb::overload_cast<const std::vector<arrangement::Part>&, const arrangement::RegionOfInterest&>(
+                &arrangement::Arrangement::create_geogram_arrangement),
+            nb::arg("parts"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest())
+        .def_static("create_auto_arrangement",
+            [](const arrangement::MatrixF32r& vertices,
+                const arrangement::MatrixIr& faces,
+                const arrangement::VectorI& face_labels,
+                const arrangement::RegionOfInterest& region_of_interest) {
+                return arrangement::Arrangement::create_auto_arrangement(
+                    vertices, faces, face_labels, region_of_interest);
+            },
+            nb::arg("vertices").noconvert(),
+            nb::arg("faces"),
+            nb::arg("face_labels"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest())
+        .def_static("create_auto_arrangement",
+            nb::overload_cast<arrangement::MatrixFr,
+                const arrangement::MatrixIr&,
+                const arrangement::VectorI&,
+                const arrangement::RegionOfInterest&>(
+                &arrangement::Arrangement::create_auto_arrangement),
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            nb::arg("face_labels"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest())
+        .def_static("create_auto_arrangement",
+            nb::overload_cast<const std::vector<arrangement::Part>&, const arrangement::RegionOfInterest&>(
+                &arrangement::Arrangement::create_auto_arrangement),
+            nb::arg("parts"),
+            nb::arg("region_of_interest") = arrangement::RegionOfInterest())
+        .def_static("create_planar_arrangement",
+            [](const arrangement::MatrixF32r& vertices,
+                const arrangement::MatrixIr& faces,
+                const arrangement::VectorI& face_labels) {
+                return arrangement::Arrangement::create_planar_arrangement(
+                    vertices, faces, face_labels);
+            },
+            nb::arg("vertices").noconvert(),
+            nb::arg("faces"),
+            nb::arg("face_labels"))
+        .def_static("create_planar_arrangement",
+            nb::overload_cast<arrangement::MatrixFr,
+                const arrangement::MatrixIr&,
+                const arrangement::VectorI&>(&arrangement::Arrangement::create_planar_arrangement),
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            nb::arg("face_labels"))
+        .def_static("create_planar_arrangement",
+            nb::overload_cast<const std::vector<arrangement::Part>&>(&arrangement::Arrangement::create_planar_arrangement),
+            nb::arg("parts"))
         .def("run", &arrangement::Arrangement::run)
+        .def("compute_intersection_curves",
+            &arrangement::Arrangement::compute_intersection_curves)
+        .def("update",
+            &arrangement::Arrangement::update,
+            nb::arg("changed_labels"),
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            nb::arg("face_labels"))
+        .def("reset",
+            &arrangement::Arrangement::reset,
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            nb::arg("face_labels"))
         .def_prop_ro(
             "vertices", &arrangement::Arrangement::get_vertices, nb::rv_policy::reference_internal)
         .def_prop_ro(
             "faces", &arrangement::Arrangement::get_faces, nb::rv_policy::reference_internal)
+        .def_prop_ro("faces_u32", &arrangement::Arrangement::get_faces_u32)
         .def_prop_ro("face_labels",
             &arrangement::Arrangement::get_out_face_labels,
             nb::rv_policy::reference_internal)
@@ -29,7 +354,114 @@ NB_MODULE(pyarrangement, m)
         .def_prop_ro(
             "cells", &arrangement::Arrangement::get_cells, nb::rv_policy::reference_internal)
         .def_prop_ro("winding_number", &arrangement::Arrangement::get_winding_number)
+        .def("get_cell_winding_numbers",
+            &arrangement::Arrangement::get_cell_winding_numbers,
+            nb::arg("label_groups"))
+        .def("extract_boolean",
+            &arrangement::Arrangement::extract_boolean,
+            nb::arg("op"),
+            nb::arg("label_groups"))
+        .def("extract_region",
+            &arrangement::Arrangement::extract_region,
+            nb::arg("label_groups"),
+            nb::arg("predicate"))
+        .def_prop_rw("exact_vertices",
+            &arrangement::Arrangement::get_exact_vertices,
+            &arrangement::Arrangement::set_exact_vertices)
+        .def_prop_rw("exact_output",
+            &arrangement::Arrangement::get_exact_output,
+            &arrangement::Arrangement::set_exact_output)
+        .def_prop_rw("input_resolved",
+            &arrangement::Arrangement::get_input_resolved,
+            &arrangement::Arrangement::set_input_resolved)
+        .def("set_snap_rounding",
+            &arrangement::Arrangement::set_snap_rounding,
+            nb::arg("snap_rounding"),
+            nb::arg("grid_size") = 0.0)
+        .def_prop_ro("snap_rounding", &arrangement::Arrangement::get_snap_rounding)
+        .def_prop_ro("snap_grid_size", &arrangement::Arrangement::get_snap_grid_size)
+        .def("set_quantization",
+            &arrangement::Arrangement::set_quantization,
+            nb::arg("quantization"),
+            nb::arg("grid_size") = 0.0)
+        .def_prop_ro("quantization", &arrangement::Arrangement::get_quantization)
+        .def_prop_ro(
+            "quantization_grid_size", &arrangement::Arrangement::get_quantization_grid_size)
+        .def_prop_rw("merge_coplanar",
+            &arrangement::Arrangement::get_merge_coplanar,
+            &arrangement::Arrangement::set_merge_coplanar)
+        .def_prop_rw("run_arena",
+            &arrangement::Arrangement::get_run_arena,
+            &arrangement::Arrangement::set_run_arena)
+        .def_prop_rw("region_of_interest",
+            &arrangement::Arrangement::get_region_of_interest,
+            &arrangement::Arrangement::set_region_of_interest)
+        .def_prop_rw("num_threads",
+            &arrangement::Arrangement::get_num_threads,
+            &arrangement::Arrangement::set_num_threads)
+        .def_prop_rw("eager_stages",
+            &arrangement::Arrangement::get_eager_stages,
+            &arrangement::Arrangement::set_eager_stages)
+        .def_prop_ro("computed_stages", &arrangement::Arrangement::get_computed_stages)
+        .def("set_output_sink",
+            &arrangement::Arrangement::set_output_sink,
+            nb::arg("sink").none(),
+            nb::keep_alive<1, 2>())
+        .def("ensure_topology", &arrangement::Arrangement::ensure_topology, nb::arg("stages"))
+        .def_prop_ro("metrics",
+            &arrangement::Arrangement::get_metrics,
+            nb::rv_policy::reference_internal)
         .def_prop_rw("verbose",
             &arrangement::Arrangement::get_verbose,
             &arrangement::Arrangement::set_verbose);
+
+    nb::class_<arrangement::AutoArrangement, arrangement::Arrangement>(m, "AutoArrangement")
+        .def_prop_rw("timeout",
+            &arrangement::AutoArrangement::get_timeout,
+            &arrangement::AutoArrangement::set_timeout)
+        .def_prop_rw("engines",
+            &arrangement::AutoArrangement::get_engines,
+            &arrangement::AutoArrangement::set_engines)
+        .def_prop_ro("selected_engine", &arrangement::AutoArrangement::get_selected_engine);
+
+    // The refine callback is not exposed: it would run Python code on the
+    // refinement thread, while the destructor waits for it holding the GIL.
+    nb::class_<arrangement::PreviewArrangement, arrangement::Arrangement>(m, "PreviewArrangement")
+        .def(nb::init<arrangement::MatrixFr,
+                 const arrangement::MatrixIr&,
+                 const arrangement::VectorI&>(),
+            nb::arg("vertices"),
+            nb::arg("faces"),
+            nb::arg("face_labels"))
+        .def_prop_rw("time_budget",
+            &arrangement::PreviewArrangement::get_time_budget,
+            &arrangement::PreviewArrangement::set_time_budget)
+        .def_prop_rw("proxy_resolution",
+            &arrangement::PreviewArrangement::get_proxy_resolution,
+            &arrangement::PreviewArrangement::set_proxy_resolution)
+        .def_prop_rw("engine",
+            &arrangement::PreviewArrangement::get_engine,
+            &arrangement::PreviewArrangement::set_engine)
+        .def_prop_ro("approximate", &arrangement::PreviewArrangement::is_approximate);
+
+    nb::class_<arrangement::PointLocator>(m, "PointLocator")
+        .def(nb::init<const arrangement::Arrangement&, const arrangement::VectorI&>(),
+            nb::arg("arrangement"),
+            nb::arg("label_groups") = arrangement::VectorI(),
+            nb::keep_alive<1, 2>())
+        .def("locate",
+            nb::overload_cast<const arrangement::MatrixFr&>(
+                &arrangement::PointLocator::locate, nb::const_),
+            nb::arg("points"))
+        .def("compute_winding_numbers",
+            &arrangement::PointLocator::compute_winding_numbers,
+            nb::arg("points"))
+        .def_ro_static(
+            "UNKNOWN_WINDING_NUMBER", &arrangement::PointLocator::UNKNOWN_WINDING_NUMBER)
+        .def_prop_ro("cell_winding_numbers",
+            &arrangement::PointLocator::get_cell_winding_numbers,
+            nb::rv_policy::reference_internal)
+        .def_prop_rw("num_threads",
+            &arrangement::PointLocator::get_num_threads,
+            &arrangement::PointLocator::set_num_threads);
 }
@@ -0,0 +1,207 @@
+#include <arrangement/AABBTree.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using namespace arrangement;
+
+namespace {
+
+constexpr int LEAF_SIZE = 4;
+
+// Relative tolerance used to flag ray hits that are numerically unreliable.
+constexpr Float RAY_EPS = 1e-10;
+
+bool ray_box_overlap(const Vector3F& origin,
+    const Vector3F& inv_direction,
+    const Vector3F& box_min,
+    const Vector3F& box_max,
+    Float t_max)
+{
+    Float t0 = 0;
+    Float t1 = t_max;
+    for (int i = 0; i < 3; i++) {
+        Float t_near = (box_min[i] - origin[i]) * inv_direction[i];
+        Float t_far = (box_max[i] - origin[i]) * inv_direction[i];
+        if (t_near > t_far) std::swap(t_near, t_far);
+        // Pad to be conservative against rounding.
+        t_far += 4 * std::numeric_limits<Float>::epsilon() * std::abs(t_far);
+        t0 = std::max(t0, t_near);
+        t1 = std::min(t1, t_far);
+        if (t0 > t1) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+AABBTree::AABBTree(const MatrixFr& vertices, const MatrixIr& faces)
+    : m_vertices(&vertices)
+    , m_faces(&faces)
+{
+    const Index num_faces = static_cast<Index>(faces.rows());
+    m_face_indices.resize(num_faces);
+    std::iota(m_face_indices.begin(), m_face_indices.end(), Index(0));
+    m_face_box_min.resize(num_faces, 3);
+    m_face_box_max.resize(num_faces, 3);
+    for (Index i = 0; i < num_faces; i++) {
+        const Vector3F v0 = vertices.row(faces(i, 0)).transpose();
+        const Vector3F v1 = vertices.row(faces(i, 1)).transpose();
+        const Vector3F v2 = vertices.row(faces(i, 2)).transpose();
+        m_face_box_min.row(i) = v0.cwiseMin(v1).cwiseMin(v2).transpose();
+        m_face_box_max.row(i) = v0.cwiseMax(v1).cwiseMax(v2).transpose();
+    }
+
+    if (num_faces > 0) {
+        m_nodes.reserve(2 * (num_faces / LEAF_SIZE + 1));
+        build(0, num_faces);
+    }
+}
+
+Index AABBTree::build(Index begin, Index end)
+{
+    const Index node_id = static_cast<Index>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    Vector3F box_min = Vector3F::Constant(std::numeric_limits<Float>::max());
+    Vector3F box_max = Vector3F::Constant(std::numeric_limits<Float>::lowest());
+    for (Index i = begin; i < end; i++) {
+        box_min = box_min.cwiseMin(m_face_box_min.row(m_face_indices[i]).transpose());
+        box_max = box_max.cwiseMax(m_face_box_max.row(m_face_indices[i]).transpose());
+    }
+    m_nodes[node_id].box_min = box_min;
+    m_nodes[node_id].box_max = box_max;
+    m_nodes[node_id].begin = begin;
+    m_nodes[node_id].end = end;
+
+    if (end - begin <= LEAF_SIZE) return node_id;
+
+    // Median split along the longest axis of the box.
+    int axis = 0;
+    (box_max - box_min).maxCoeff(&axis);
+    const Index mid = begin + (end - begin) / 2;
+    std::nth_element(m_face_indices.begin() + begin,
+        m_face_indices.begin() + mid,
+        m_face_indices.begin() + end,
+        [&](Index a, Index b) {
+            return m_face_box_min(a, axis) + m_face_box_max(a, axis) <
+                   m_face_box_min(b, axis) + m_face_box_max(b, axis);
+        });
+
+    const Index left = build(begin, mid);
+    const Index right = build(mid, end);
+    m_nodes[node_id].left = left;
+    m_nodes[node_id].right = right;
+    return node_id;
+}
+
+AABBTree::RayHit AABBTree::intersect_ray(const Vector3F& origin, const Vector3F& direction) const
+{
+    RayHit hit;
+    if (m_nodes.empty()) return hit;
+
+    const Vector3F inv_direction = direction.cwiseInverse();
+    Float best_t = std::numeric_limits<Float>::infinity();
+    Float second_t = std::numeric_limits<Float>::infinity();
+    bool grazed = false;
+
+    std::vector<Index> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (!ray_box_overlap(origin, inv_direction, node.box_min, node.box_max, second_t)) {
+            continue;
+        }
+        if (node.left >= 0) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+
+        for (Index i = node.begin; i < node.end; i++) {
+            const Index fid = m_face_indices[i];
+            const Vector3F v0 = m_vertices->row((*m_faces)(fid, 0)).transpose();
+            const Vector3F v1 = m_vertices->row((*m_faces)(fid, 1)).transpose();
+            const Vector3F v2 = m_vertices->row((*m_faces)(fid, 2)).transpose();
+
+            // Moller-Trumbore.
+            const Vector3F e1 = v1 - v0;
+            const Vector3F e2 = v2 - v0;
+            const Vector3F p = direction.cross(e2);
+            const Float det = e1.dot(p);
+            const Float scale = e1.norm() * e2.norm() * direction.norm();
+            if (std::abs(det) <= RAY_EPS * scale) {
+                // Parallel ray.  It only matters if the ray grazes the face.
+                const Vector3F n = e1.cross(e2);
+                if (std::abs(n.dot(origin - v0)) <= RAY_EPS * n.norm() * (origin - v0).norm() &&
+                    ray_box_overlap(origin,
+                        inv_direction,
+                        m_face_box_min.row(fid).transpose(),
+                        m_face_box_max.row(fid).transpose(),
+                        second_t)) {
+                    grazed = true;
+                }
+                continue;
+            }
+            const Float inv_det = 1 / det;
+            const Vector3F s = origin - v0;
+            const Float u = s.dot(p) * inv_det;
+            const Vector3F q = s.cross(e1);
+            const Float v = direction.dot(q) * inv_det;
+            const Float t = e2.dot(q) * inv_det;
+            const Float w = 1 - u - v;
+            if (u < -RAY_EPS || v < -RAY_EPS || w < -RAY_EPS || t < -RAY_EPS) continue;
+
+            const bool near_boundary = u <= RAY_EPS || v <= RAY_EPS || w <= RAY_EPS;
+            const bool near_origin = t <= RAY_EPS * (1 + s.norm());
+            if (t < best_t) {
+                second_t = best_t;
+                best_t = t;
+                hit.face = fid;
+                hit.t = t;
+                hit.ambiguous = near_boundary || near_origin;
+            } else if (t < second_t) {
+                second_t = t;
+            }
+        }
+    }
+
+    if (grazed || (hit.face >= 0 && second_t - best_t <= RAY_EPS * (1 + std::abs(best_t)))) {
+        hit.ambiguous = true;
+    }
+    return hit;
+}
+
+void AABBTree::query_box(
+    const Vector3F& box_min, const Vector3F& box_max, std::vector<Index>& faces) const
+{
+    if (m_nodes.empty()) return;
+
+    std::vector<Index> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if ((node.box_min.array() > box_max.array()).any() ||
+            (node.box_max.array() < box_min.array()).any()) {
+            continue;
+        }
+        if (node.left >= 0) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+        for (Index i = node.begin; i < node.end; i++) {
+            const Index fid = m_face_indices[i];
+            if ((m_face_box_min.row(fid).array() <= box_max.transpose().array()).all() &&
+                (m_face_box_max.row(fid).array() >= box_min.transpose().array()).all()) {
+                faces.push_back(fid);
+            }
+        }
+    }
+}
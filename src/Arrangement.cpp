@@ -1,36 +1,379 @@
 #include <arrangement/Arrangement.h>
-#include <arrangement/FastArrangement.h>
-#include <arrangement/MeshArrangement.h>
-#include <arrangement/GeogramArrangement.h>
+#include <arrangement/AutoArrangement.h>
+#include <arrangement/EngineRegistry.h>
+#include <arrangement/Exception.h>
+#include <arrangement/ParallelUtils.h>
+#include <arrangement/Trace.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <vector>
 
 using namespace arrangement;
 
+Arrangement::Ptr Arrangement::create_mesh_arrangement(MatrixFr vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    const RegionOfInterest& region_of_interest,
+    MeshKernel kernel)
+{
+    EngineOptions options;
+    options.region_of_interest = region_of_interest;
+    options.kernel = kernel;
+    return EngineRegistry::create("mesh", std::move(vertices), faces, face_labels, options);
+}
+
+Arrangement::Ptr Arrangement::create_fast_arrangement(MatrixFr vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    const RegionOfInterest& region_of_interest)
+{
+    EngineOptions options;
+    options.region_of_interest = region_of_interest;
+    return EngineRegistry::create("fast", std::move(vertices), faces, face_labels, options);
+}
+
+Arrangement::Ptr Arrangement::create_geogram_arrangement(MatrixFr vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    const RegionOfInterest& region_of_interest)
+{
+    EngineOptions options;
+    options.region_of_interest = region_of_interest;
+    return EngineRegistry::create("geogram", std::move(vertices), faces, face_labels, options);
+}
+
+Arrangement::Ptr Arrangement::create_auto_arrangement(MatrixFr vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    const RegionOfInterest& region_of_interest)
+{
+    auto engine = std::make_shared<AutoArrangement>(std::move(vertices), faces, face_labels);
+    engine->set_region_of_interest(region_of_interest);
+    return engine;
+}
+
+Arrangement::Ptr Arrangement::create_planar_arrangement(
+    MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+{
+    return EngineRegistry::create("planar", std::move(vertices), faces, face_labels);
+}
+
 Arrangement::Ptr Arrangement::create_mesh_arrangement(
-    const MatrixFr& vertices, const MatrixIr& faces, const VectorI& face_labels)
+    const std::vector<Part>& parts, const RegionOfInterest& region_of_interest, MeshKernel kernel)
 {
-#ifdef ARRANGEMENT_IGL
-    return std::make_shared<MeshArrangement>(vertices, faces, face_labels);
-#else
-    return nullptr;
-#endif
+    MatrixFr vertices;
+    MatrixIr faces;
+    VectorI face_labels;
+    assemble_parts(parts, vertices, faces, face_labels);
+    return create_mesh_arrangement(
+        std::move(vertices), faces, face_labels, region_of_interest, kernel);
 }
 
 Arrangement::Ptr Arrangement::create_fast_arrangement(
-    const MatrixFr& vertices, const MatrixIr& faces, const VectorI& face_labels)
+    const std::vector<Part>& parts, const RegionOfInterest& region_of_interest)
 {
-#ifdef ARRANGEMENT_FAST
-    return std::make_shared<FastArrangement>(vertices, faces, face_labels);
-#else
-    return nullptr;
-#endif
+    MatrixFr vertices;
+    MatrixIr faces;
+    VectorI face_labels;
+    assemble_parts(parts, vertices, faces, face_labels);
+    return create_fast_arrangement(std::move(vertices), faces, face_labels, region_of_interest);
 }
 
 Arrangement::Ptr Arrangement::create_geogram_arrangement(
-    const MatrixFr& vertices, const MatrixIr& faces, const VectorI& face_labels)
+    const std::vector<Part>& parts, const RegionOfInterest& region_of_interest)
 {
-#ifdef ARRANGEMENT_GEOGRAM
-    return std::make_shared<GeogramArrangement>(vertices, faces, face_labels);
-#else
-    return nullptr;
-#endif
+    MatrixFr vertices;
+    MatrixIr faces;
+    VectorI face_labels;
+    assemble_parts(parts, vertices, faces, face_labels);
+    return create_geogram_arrangement(
+        std::move(vertices), faces, face_labels, region_of_interest);
+}
+
+Arrangement::Ptr Arrangement::create_auto_arrangement(
+    const std::vector<Part>& parts, const RegionOfInterest& region_of_interest)
+{
+    MatrixFr vertices;
+    MatrixIr faces;
+    VectorI face_labels;
+    assemble_parts(parts, vertices, faces, face_labels);
+    return create_auto_arrangement(std::move(vertices), faces, face_labels, region_of_interest);
+}
+
+Arrangement::Ptr Arrangement::create_planar_arrangement(const std::vector<Part>& parts)
+{
+    MatrixFr vertices;
+    MatrixIr faces;
+    VectorI face_labels;
+    assemble_parts(parts, vertices, faces, face_labels);
+    return create_planar_arrangement(std::move(vertices), faces, face_labels);
+}
+
+MatrixU32r Arrangement::get_faces_u32() const
+{
+    if (static_cast<std::uint64_t>(m_vertices.rows()) >
+        std::numeric_limits<std::uint32_t>::max()) {
+        throw RuntimeError("Vertex indices do not fit in 32 bits");
+    }
+    return m_faces.cast<std::uint32_t>();
+}
+
+void Arrangement::ensure_topology(unsigned stages) const
+{
+    if (stages & TOPOLOGY_WINDING_NUMBERS) stages |= TOPOLOGY_CELLS;
+    if (stages & TOPOLOGY_CELLS) stages |= TOPOLOGY_PATCHES;
+    if ((m_computed_stages.load() & stages) == stages) return;
+
+    std::lock_guard<std::mutex> lock(m_topology_mutex);
+    const unsigned missing = stages & ~m_computed_stages.load();
+    if (missing == 0) return;
+    compute_topology(missing);
+    m_computed_stages |= missing;
+}
+
+void Arrangement::stream_output(size_t num_vertices, const VertexWriter& write_vertices)
+{
+    ARRANGEMENT_TRACE_SCOPE("stream_output");
+    OutputSink& sink = *m_output_sink;
+    const size_t chunk_size = std::max<size_t>(1, sink.get_chunk_size());
+    const unsigned stages = get_computed_stages();
+    const size_t num_faces = m_faces.rows();
+
+    // The input is not needed anymore.
+    m_in_face_labels.resize(0);
+
+    sink.begin(num_vertices, num_faces);
+
+    if (write_vertices) {
+        write_vertices(sink);
+    } else {
+        std::vector<std::string> exact_chunk;
+        for (size_t begin = 0; begin < num_vertices; begin += chunk_size) {
+            const size_t n = std::min(chunk_size, num_vertices - begin);
+            if (!m_exact_vertices.empty()) {
+                exact_chunk.assign(m_exact_vertices.begin() + 3 * begin,
+                    m_exact_vertices.begin() + 3 * (begin + n));
+            }
+            sink.write_vertices(begin, m_vertices.middleRows(begin, n), exact_chunk);
+        }
+    }
+    m_vertices.resize(0, 3);
+    m_exact_vertices.clear();
+    m_exact_vertices.shrink_to_fit();
+
+    const bool has_patches = (stages & TOPOLOGY_PATCHES) && m_patches.size() > 0;
+    const VectorI no_patches;
+    for (size_t begin = 0; begin < num_faces; begin += chunk_size) {
+        const size_t n = std::min(chunk_size, num_faces - begin);
+        sink.write_faces(begin,
+            m_faces.middleRows(begin, n),
+            m_out_face_labels.segment(begin, n),
+            has_patches ? VectorI(m_patches.segment(begin, n)) : no_patches);
+    }
+    m_faces.resize(0, 3);
+    m_out_face_labels.resize(0);
+    m_patches.resize(0);
+
+    if (stages & TOPOLOGY_CELLS) sink.write_cells(m_cells);
+    m_cells.resize(0, 2);
+    if (stages & TOPOLOGY_WINDING_NUMBERS) sink.write_winding_numbers(m_winding_number);
+    m_winding_number.resize(0, 2);
+
+    sink.end();
+
+    // Nothing is left to compute the pending stages from.
+    reset_topology(TOPOLOGY_ALL);
+}
+
+void Arrangement::update(const VectorI& /*changed_labels*/,
+    const MatrixFr& /*vertices*/,
+    const MatrixIr& /*faces*/,
+    const VectorI& /*face_labels*/)
+{
+    throw NotImplementedError("This arrangement engine does not support incremental updates");
+}
+
+void Arrangement::reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+{
+    m_vertices = std::move(vertices);
+    m_faces = faces;
+    m_in_face_labels = face_labels;
+    m_out_face_labels.resize(0);
+    m_cells.resize(0, m_cells.cols());
+    m_patches.resize(0);
+    m_winding_number.resize(0, m_winding_number.cols());
+    m_exact_vertices.clear();
+    m_metrics.clear();
+
+    // Like a new engine: nothing to compute until run().
+    reset_topology(TOPOLOGY_ALL);
+}
+
+void Arrangement::set_exact_vertices(const std::vector<std::string>& coordinates)
+{
+    if (!coordinates.empty() && coordinates.size() != static_cast<size_t>(m_vertices.size())) {
+        throw RuntimeError("Exact coordinates must have #vertices * 3 entries");
+    }
+    m_exact_vertices = coordinates;
+}
+
+MatrixIr Arrangement::get_cell_winding_numbers(const VectorI& label_groups) const
+{
+    const size_t num_faces = m_faces.rows();
+    const size_t num_patches = get_num_patches();
+    const size_t num_cells = get_num_cells();
+    if (num_cells == 0 || static_cast<size_t>(m_patches.size()) != num_faces) {
+        throw RuntimeError("Cell topology is not available, please call run() first");
+    }
+    if (m_cells.minCoeff() < 0) {
+        throw NotImplementedError("This arrangement engine does not provide cell topology");
+    }
+    if (m_out_face_labels.size() != m_patches.size()) {
+        throw RuntimeError("Output face labels are not available");
+    }
+
+    const int num_groups = label_groups.size() > 0 ? label_groups.maxCoeff() + 1 : 0;
+
+    // Groups with faces in each patch.
+    std::vector<std::vector<int>> patch_groups(num_patches);
+    for (size_t i = 0; i < num_faces; i++) {
+        const int label = m_out_face_labels[i];
+        if (label < 0 || label >= label_groups.size()) continue;
+        const int group = label_groups[label];
+        if (group < 0) continue;
+        auto& groups = patch_groups[m_patches[i]];
+        if (std::find(groups.begin(), groups.end(), group) == groups.end()) {
+            groups.push_back(group);
+        }
+    }
+
+    // Cell adjacency through patches.
+    std::vector<std::vector<size_t>> cell_patches(num_cells);
+    for (size_t i = 0; i < num_patches; i++) {
+        cell_patches[m_cells(i, 0)].push_back(i);
+        if (m_cells(i, 1) != m_cells(i, 0)) {
+            cell_patches[m_cells(i, 1)].push_back(i);
+        }
+    }
+
+    MatrixIr winding_numbers = MatrixIr::Zero(num_cells, num_groups);
+    std::vector<bool> visited(num_cells, false);
+    std::queue<size_t> Q;
+    Q.push(0);
+    visited[0] = true;
+    while (!Q.empty()) {
+        const size_t cell = Q.front();
+        Q.pop();
+        for (const size_t patch : cell_patches[cell]) {
+            const size_t positive_cell = m_cells(patch, 0);
+            const size_t negative_cell = m_cells(patch, 1);
+            const size_t next_cell = (cell == positive_cell) ? negative_cell : positive_cell;
+            const int sign = (cell == positive_cell) ? 1 : -1;
+
+            VectorI next_winding_numbers = winding_numbers.row(cell).transpose().cast<int>();
+            for (const int group : patch_groups[patch]) {
+                next_winding_numbers[group] += sign;
+            }
+
+            if (!visited[next_cell]) {
+                winding_numbers.row(next_cell) = next_winding_numbers.transpose().cast<Index>();
+                visited[next_cell] = true;
+                Q.push(next_cell);
+            } else if (winding_numbers.row(next_cell).transpose().cast<int>() !=
+                       next_winding_numbers) {
+                throw RuntimeError(
+                    "Inconsistent winding numbers: label groups must form closed surfaces");
+            }
+        }
+    }
+
+    if (std::find(visited.begin(), visited.end(), false) != visited.end()) {
+        throw RuntimeError("Some cells are not reachable from the ambient cell");
+    }
+    return winding_numbers;
+}
+
+MatrixIr Arrangement::extract_boolean(BooleanOperation op, const VectorI& label_groups) const
+{
+    switch (op) {
+    case BooleanOperation::Union:
+        return extract_region(label_groups, [](const VectorI& w) { return (w.array() > 0).any(); });
+    case BooleanOperation::Intersection:
+        return extract_region(label_groups,
+            [](const VectorI& w) { return w.size() > 0 && (w.array() > 0).all(); });
+    case BooleanOperation::Difference:
+        return extract_region(label_groups, [](const VectorI& w) {
+            return w.size() > 0 && w[0] > 0 && (w.tail(w.size() - 1).array() <= 0).all();
+        });
+    case BooleanOperation::SymmetricDifference:
+        return extract_region(
+            label_groups, [](const VectorI& w) { return (w.array() > 0).count() % 2 == 1; });
+    default: throw NotImplementedError("Unsupported boolean operation");
+    }
+}
+
+MatrixIr Arrangement::extract_region(
+    const VectorI& label_groups, const WindingNumberPredicate& predicate) const
+{
+    const MatrixIr cell_winding_numbers = get_cell_winding_numbers(label_groups);
+    const size_t num_cells = cell_winding_numbers.rows();
+    const size_t num_patches = m_cells.rows();
+
+    std::vector<bool> cell_selected(num_cells);
+    for (size_t i = 0; i < num_cells; i++) {
+        cell_selected[i] = predicate(cell_winding_numbers.row(i).transpose().cast<int>());
+    }
+
+    // +1: keep face orientation, -1: flip face orientation, 0: not on the boundary.
+    std::vector<int> patch_orientations(num_patches, 0);
+    for (size_t i = 0; i < num_patches; i++) {
+        const bool positive_selected = cell_selected[m_cells(i, 0)];
+        const bool negative_selected = cell_selected[m_cells(i, 1)];
+        if (negative_selected && !positive_selected) {
+            patch_orientations[i] = 1;
+        } else if (positive_selected && !negative_selected) {
+            patch_orientations[i] = -1;
+        }
+    }
+
+    // Two passes over chunks of faces.  Each chunk counts its boundary faces
+    // first so that it can then write its output rows independently.
+    const size_t num_faces = m_faces.rows();
+    const size_t num_chunks = std::max<size_t>(
+        1, std::min(ParallelUtils::resolve_num_threads(m_num_threads), num_faces / 1024));
+    const size_t chunk_size = (num_faces + num_chunks - 1) / num_chunks;
+    std::vector<size_t> chunk_offsets(num_chunks + 1, 0);
+    ParallelUtils::parallel_for(num_chunks, [&](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; chunk++) {
+            const size_t face_begin = std::min(num_faces, chunk * chunk_size);
+            const size_t face_end = std::min(num_faces, face_begin + chunk_size);
+            size_t count = 0;
+            for (size_t i = face_begin; i < face_end; i++) {
+                if (patch_orientations[m_patches[i]] != 0) count++;
+            }
+            chunk_offsets[chunk + 1] = count;
+        }
+    }, num_chunks, 1);
+    std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
+
+    MatrixIr faces(chunk_offsets.back(), 3);
+    ParallelUtils::parallel_for(num_chunks, [&](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; chunk++) {
+            const size_t face_begin = std::min(num_faces, chunk * chunk_size);
+            const size_t face_end = std::min(num_faces, face_begin + chunk_size);
+            size_t count = chunk_offsets[chunk];
+            for (size_t i = face_begin; i < face_end; i++) {
+                const int orientation = patch_orientations[m_patches[i]];
+                if (orientation > 0) {
+                    faces.row(count++) = m_faces.row(i);
+                } else if (orientation < 0) {
+                    faces.row(count++) = m_faces.row(i).reverse();
+                }
+            }
+        }
+    }, num_chunks, 1);
+    return faces;
 }
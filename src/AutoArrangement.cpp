@@ -0,0 +1,342 @@
+#include <arrangement/AABBTree.h>
+#include <arrangement/AutoArrangement.h>
+#include <arrangement/EngineRegistry.h>
+#include <arrangement/Exception.h>
+#include <arrangement/Trace.h>
+
+#ifdef ARRANGEMENT_FAST
+#include <arrangement/FastArrangement.h>
+#endif
+#ifdef ARRANGEMENT_IGL
+#include <arrangement/PlanarArrangement.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace arrangement;
+
+namespace {
+
+// Below this size the fixed cost of the fast engine outweighs its speed.
+constexpr size_t SMALL_INPUT_NUM_FACES = 256;
+
+// Above this fraction of coplanar candidate pairs the mesh engine is tried
+// first.
+constexpr Float COPLANARITY_THRESHOLD = 0.25;
+
+// Relative tolerance of the (inexact) coplanarity test used for profiling.
+constexpr Float COPLANARITY_EPS = 1e-10;
+
+std::string join(const std::vector<std::string>& names)
+{
+    std::string result;
+    for (const auto& name : names) {
+        if (!result.empty()) result += ",";
+        result += name;
+    }
+    return result;
+}
+
+/**
+ * Run an engine on a worker thread and wait for at most `timeout` seconds.
+ *
+ * @return false on timeout.  The worker is then detached and keeps the engine
+ * alive until it finishes.  Exceptions thrown by run() are rethrown.
+ */
+bool run_with_timeout(Arrangement::Ptr engine, Float timeout)
+{
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done = false;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+
+    std::thread worker([engine, state]() {
+        std::exception_ptr error;
+        try {
+            engine->run();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done = true;
+            state->error = error;
+        }
+        state->cv.notify_all();
+    });
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    const bool done = state->cv.wait_for(
+        lock, std::chrono::duration<Float>(timeout), [&state]() { return state->done; });
+    lock.unlock();
+    if (!done) {
+        worker.detach();
+        return false;
+    }
+    worker.join();
+    if (state->error) std::rethrow_exception(state->error);
+    return true;
+}
+
+} // namespace
+
+AutoArrangement::Profile AutoArrangement::compute_profile(const MatrixFr& vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    size_t max_samples)
+{
+    Profile profile;
+    profile.num_faces = faces.rows();
+    if (profile.num_faces == 0) return profile;
+
+    std::set<int> labels(face_labels.data(), face_labels.data() + face_labels.size());
+    profile.num_labels = labels.size();
+    profile.max_label = labels.empty() ? -1 : *labels.rbegin();
+
+#ifdef ARRANGEMENT_IGL
+    const VectorI face_planes = PlanarArrangement::detect_planes(vertices, faces);
+    if (face_planes.size() > 0) profile.num_planes = face_planes.maxCoeff() + 1;
+#endif
+
+    const Float scale = (vertices.colwise().maxCoeff() - vertices.colwise().minCoeff()).norm();
+    const Float tol = COPLANARITY_EPS * std::max(scale, Float(1));
+
+    AABBTree tree(vertices, faces);
+    const size_t stride = std::max<size_t>(1, (profile.num_faces + max_samples - 1) / max_samples);
+    size_t num_candidates = 0;
+    size_t num_coplanar = 0;
+    std::vector<Index> hits;
+    for (size_t i = 0; i < profile.num_faces; i += stride) {
+        const Vector3F v0 = vertices.row(faces(i, 0)).transpose();
+        const Vector3F v1 = vertices.row(faces(i, 1)).transpose();
+        const Vector3F v2 = vertices.row(faces(i, 2)).transpose();
+        const Vector3F box_min = v0.cwiseMin(v1).cwiseMin(v2).array() - tol;
+        const Vector3F box_max = v0.cwiseMax(v1).cwiseMax(v2).array() + tol;
+        Vector3F normal = (v1 - v0).cross(v2 - v0);
+        const Float normal_length = normal.norm();
+        if (normal_length > 0) normal /= normal_length;
+
+        hits.clear();
+        tree.query_box(box_min, box_max, hits);
+        for (const Index j : hits) {
+            if (j == static_cast<Index>(i)) continue;
+            num_candidates++;
+            if (normal_length == 0) continue;
+            bool coplanar = true;
+            for (int k = 0; k < 3 && coplanar; k++) {
+                const Vector3F p = vertices.row(faces(j, k)).transpose();
+                coplanar = std::abs(normal.dot(p - v0)) <= tol;
+            }
+            if (coplanar) num_coplanar++;
+        }
+        profile.num_sampled_faces++;
+    }
+
+    profile.candidate_pairs = Float(num_candidates) / 2 * Float(profile.num_faces) /
+                              Float(profile.num_sampled_faces);
+    profile.coplanarity_ratio =
+        num_candidates > 0 ? Float(num_coplanar) / Float(num_candidates) : Float(0);
+    return profile;
+}
+
+std::vector<std::string> AutoArrangement::choose_engines(const Profile& profile) const
+{
+    // Engines may be compiled in or provided by plugins, see EngineRegistry.
+    // The fast engine only accepts exact coordinates for resolved input.
+    bool use_fast = EngineRegistry::is_available("fast") &&
+                    (m_exact_vertices.empty() || m_input_resolved);
+#ifdef ARRANGEMENT_FAST
+    // It stores labels in a fixed size bitset.  Without the header (plugin
+    // builds), too many labels make it fail and the next engine is tried.
+    use_fast = use_fast &&
+               profile.max_label < static_cast<int>(FastArrangement::get_max_num_labels());
+#endif
+    // Quantized input is only supported by the fast engine.
+    const bool use_mesh =
+        EngineRegistry::is_available("mesh") && (!m_quantization || m_input_resolved);
+    // Planes are only detected when the planar engine is compiled in.
+    const bool use_planar = profile.num_planes > 0 && EngineRegistry::is_available("planar") &&
+                            !m_input_resolved && !m_quantization && m_region_of_interest.empty();
+    const bool use_geogram = EngineRegistry::is_available("geogram") && !m_exact_output &&
+                             m_exact_vertices.empty() && !m_input_resolved && !m_snap_rounding &&
+                             !m_quantization && m_region_of_interest.empty();
+
+    const bool mesh_first = profile.num_faces < SMALL_INPUT_NUM_FACES ||
+                            profile.coplanarity_ratio > COPLANARITY_THRESHOLD;
+
+    std::vector<std::string> engines;
+    if (use_planar) engines.push_back("planar");
+    if (use_mesh && mesh_first) engines.push_back("mesh");
+    if (use_fast) engines.push_back("fast");
+    if (use_mesh && !mesh_first) engines.push_back("mesh");
+    if (use_geogram) engines.push_back("geogram");
+    return engines;
+}
+
+Arrangement::Ptr AutoArrangement::create_engine(const std::string& name)
+{
+    Ptr engine;
+    if (m_spare_engine != nullptr && name == m_spare_engine_name) {
+        engine = std::move(m_spare_engine);
+        engine->reset(m_vertices, m_faces, m_in_face_labels);
+    } else {
+        engine = EngineRegistry::create(name, m_vertices, m_faces, m_in_face_labels);
+    }
+    if (engine == nullptr) {
+        throw NotImplementedError("Arrangement engine is not available: " + name);
+    }
+
+    if (!m_exact_vertices.empty()) engine->set_exact_vertices(m_exact_vertices);
+    engine->set_exact_output(m_exact_output);
+    engine->set_input_resolved(m_input_resolved);
+    engine->set_snap_rounding(m_snap_rounding, m_snap_grid_size);
+    engine->set_quantization(m_quantization, m_quantization_grid_size);
+    engine->set_merge_coplanar(m_merge_coplanar);
+    engine->set_run_arena(m_run_arena);
+    engine->set_region_of_interest(m_region_of_interest);
+    engine->set_num_threads(m_num_threads);
+    engine->set_verbose(m_verbose);
+    engine->set_eager_stages(engine->get_eager_stages() & m_eager_stages);
+    return engine;
+}
+
+void AutoArrangement::run()
+{
+    ARRANGEMENT_TRACE_SCOPE("AutoArrangement::run");
+    m_metrics.clear();
+    if (m_engine != nullptr) {
+        m_spare_engine = std::move(m_engine);
+        m_spare_engine_name = m_selected_engine;
+    }
+    m_selected_engine.clear();
+
+    Profile profile;
+    {
+        ScopedTimer timer(m_metrics, "profile");
+        profile = compute_profile(m_vertices, m_faces, m_in_face_labels);
+    }
+    m_metrics.values["profile.num_faces"] = static_cast<Float>(profile.num_faces);
+    m_metrics.values["profile.num_labels"] = static_cast<Float>(profile.num_labels);
+    m_metrics.values["profile.num_sampled_faces"] = static_cast<Float>(profile.num_sampled_faces);
+    m_metrics.values["profile.candidate_pairs"] = profile.candidate_pairs;
+    m_metrics.values["profile.coplanarity_ratio"] = profile.coplanarity_ratio;
+    m_metrics.values["profile.num_planes"] = static_cast<Float>(profile.num_planes);
+
+    const std::vector<std::string> engines =
+        m_engines.empty() ? choose_engines(profile) : m_engines;
+    m_metrics.notes["engine_order"] = join(engines);
+    if (engines.empty()) {
+        throw NotImplementedError("No arrangement engine supports this input and options");
+    }
+    if (m_verbose) {
+        std::cout << "Arrangement: auto engine order: " << join(engines) << std::endl;
+    }
+
+    Ptr result;
+    std::string last_error;
+    for (size_t i = 0; i < engines.size() && result == nullptr; i++) {
+        const std::string& name = engines[i];
+        const bool is_last = i + 1 == engines.size();
+        std::string status = "ok";
+        {
+            ScopedTimer timer(m_metrics, "attempt." + name);
+            try {
+                auto engine = create_engine(name);
+                if (m_timeout > 0 && !is_last) {
+                    if (run_with_timeout(engine, m_timeout)) {
+                        result = engine;
+                    } else {
+                        status = "timeout";
+                    }
+                } else {
+                    engine->run();
+                    result = engine;
+                }
+            } catch (const std::exception& e) {
+                status = std::string("failed: ") + e.what();
+            }
+        }
+        m_metrics.notes["attempt." + name] = status;
+        if (result == nullptr) {
+            last_error = name + " " + status;
+            if (m_verbose) {
+                std::cout << "Arrangement: auto engine " << name << " " << status << std::endl;
+            }
+        } else {
+            m_selected_engine = name;
+        }
+    }
+    if (result == nullptr) {
+        throw RuntimeError("All arrangement engines failed, last: " + last_error);
+    }
+
+    m_engine = result;
+    copy_result();
+    if (m_output_sink != nullptr) {
+        // The selected engine ran in memory, release it before streaming.
+        m_engine.reset();
+        stream_output(m_vertices.rows());
+    }
+}
+
+void AutoArrangement::update(const VectorI& changed_labels,
+    const MatrixFr& vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels)
+{
+    if (m_engine == nullptr) {
+        throw RuntimeError("AutoArrangement::update() must be called after run()");
+    }
+    m_engine->update(changed_labels, vertices, faces, face_labels);
+    m_metrics.clear();
+    copy_result();
+}
+
+void AutoArrangement::reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+{
+    Base::reset(std::move(vertices), faces, face_labels);
+    if (m_engine != nullptr) {
+        m_spare_engine = std::move(m_engine);
+        m_spare_engine_name = m_selected_engine;
+    }
+    m_selected_engine.clear();
+}
+
+void AutoArrangement::copy_result()
+{
+    m_vertices = m_engine->get_vertices();
+    m_faces = m_engine->get_faces();
+    m_out_face_labels = m_engine->get_out_face_labels();
+    m_exact_vertices = m_engine->get_exact_vertices();
+    m_cells.resize(0, 2);
+    m_patches.resize(0);
+    m_winding_number.resize(0, 2);
+    reset_topology();
+    ensure_topology(m_engine->get_computed_stages());
+
+    const Metrics& engine_metrics = m_engine->get_metrics();
+    for (const auto& [key, value] : engine_metrics.timings) m_metrics.timings[key] = value;
+    for (const auto& [key, value] : engine_metrics.values) m_metrics.values[key] = value;
+    for (const auto& [key, value] : engine_metrics.notes) m_metrics.notes[key] = value;
+    for (const auto& [key, value] : engine_metrics.memory) m_metrics.memory[key] = value;
+    m_metrics.notes["engine"] = m_selected_engine;
+}
+
+void AutoArrangement::compute_topology(unsigned stages) const
+{
+    if (m_engine == nullptr) return;
+    if (stages & TOPOLOGY_PATCHES) m_patches = m_engine->get_patches();
+    if (stages & TOPOLOGY_CELLS) m_cells = m_engine->get_cells();
+    if (stages & TOPOLOGY_WINDING_NUMBERS) m_winding_number = m_engine->get_winding_number();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <arrangement/EngineRegistry.h>
+
+#include <map>
+#include <string>
+
+namespace arrangement {
+
+/// Factories of an engine family, keyed by engine name.
+using EngineFactories = std::map<std::string, EngineRegistry::Factory>;
+
+/*
+ * Each family is defined next to its engine.  Compiled into the library, the
+ * registry registers them up front; built as a plugin module
+ * (ARRANGEMENT_BUILDING_PLUGIN), the family's ARRANGEMENT_BUILTIN_PLUGIN entry
+ * point does.
+ */
+
+#ifdef ARRANGEMENT_IGL
+/// "mesh" and "planar".
+EngineFactories get_mesh_engine_factories();
+#endif
+
+#ifdef ARRANGEMENT_FAST
+/// "fast".
+EngineFactories get_fast_engine_factories();
+#endif
+
+#ifdef ARRANGEMENT_GEOGRAM
+/// "geogram".
+EngineFactories get_geogram_engine_factories();
+#endif
+
+} // namespace arrangement
+
+#ifdef ARRANGEMENT_BUILDING_PLUGIN
+#define ARRANGEMENT_BUILTIN_PLUGIN(get_factories)                          \
+    ARRANGEMENT_PLUGIN()                                                   \
+    {                                                                      \
+        for (auto& [name, factory] : arrangement::get_factories()) {       \
+            arrangement::EngineRegistry::register_engine(name, factory);   \
+        }                                                                  \
+    }
+#else
+#define ARRANGEMENT_BUILTIN_PLUGIN(get_factories)
+#endif
@@ -0,0 +1,401 @@
+#ifdef ARRANGEMENT_IGL
+
+#include "CoplanarMerge.h"
+
+#include <CGAL/Constrained_Delaunay_triangulation_2.h>
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+#include <CGAL/Projection_traits_xy_3.h>
+#include <CGAL/Projection_traits_xz_3.h>
+#include <CGAL/Projection_traits_yz_3.h>
+#include <CGAL/Triangulation_face_base_with_info_2.h>
+#include <CGAL/Triangulation_vertex_base_with_info_2.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <list>
+#include <memory_resource>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace arrangement {
+namespace CoplanarMerge {
+
+namespace {
+
+typedef CGAL::Epeck Kernel;
+typedef Kernel::Point_3 Point;
+typedef Kernel::Vector_3 Vector;
+typedef std::array<Index, 3> Triangle;
+
+Point get_point(const ExactUtils::MatrixEr& vertices, Index i)
+{
+    return Point(vertices(i, 0), vertices(i, 1), vertices(i, 2));
+}
+
+Vector get_normal(const ExactUtils::MatrixEr& vertices, Index v0, Index v1, Index v2)
+{
+    const Point p0 = get_point(vertices, v0);
+    return CGAL::cross_product(get_point(vertices, v1) - p0, get_point(vertices, v2) - p0);
+}
+
+class UnionFind
+{
+public:
+    explicit UnionFind(size_t n)
+        : m_parent(n)
+    {
+        std::iota(m_parent.begin(), m_parent.end(), Index(0));
+    }
+
+    Index find(Index i)
+    {
+        while (m_parent[i] != i) {
+            m_parent[i] = m_parent[m_parent[i]];
+            i = m_parent[i];
+        }
+        return i;
+    }
+
+    void unite(Index i, Index j) { m_parent[find(i)] = find(j); }
+
+private:
+    std::vector<Index> m_parent;
+};
+
+/**
+ * Boundary of a region of coplanar faces.
+ */
+struct Region
+{
+    std::vector<Index> faces;
+    std::vector<std::vector<Index>> loops;
+    std::vector<Index> isolated_vertices;
+};
+
+/**
+ * Constrained triangulation of a region projected along one axis.  Returns
+ * false if the boundary could not be triangulated.
+ */
+template <typename Traits>
+bool triangulate(
+    const ExactUtils::MatrixEr& vertices, const Region& region, std::vector<Triangle>& triangles)
+{
+    typedef CGAL::Triangulation_vertex_base_with_info_2<Index, Traits> Vb;
+    typedef CGAL::Triangulation_face_base_with_info_2<int, Traits> Fbb;
+    typedef CGAL::Constrained_triangulation_face_base_2<Traits, Fbb> Fb;
+    typedef CGAL::Triangulation_data_structure_2<Vb, Fb> Tds;
+    typedef CGAL::Constrained_Delaunay_triangulation_2<Traits,
+        Tds,
+        CGAL::No_constraint_intersection_tag>
+        CDT;
+    typedef typename CDT::Face_handle Face_handle;
+
+    CDT cdt;
+    try {
+        for (const auto& loop : region.loops) {
+            typename CDT::Vertex_handle first, prev;
+            for (size_t i = 0; i < loop.size(); i++) {
+                auto vh = cdt.insert(get_point(vertices, loop[i]));
+                vh->info() = loop[i];
+                if (i == 0) {
+                    first = vh;
+                } else {
+                    cdt.insert_constraint(prev, vh);
+                }
+                prev = vh;
+            }
+            cdt.insert_constraint(prev, first);
+        }
+        for (const Index v : region.isolated_vertices) {
+            cdt.insert(get_point(vertices, v))->info() = v;
+        }
+    } catch (...) {
+        // Intersecting constraints, the boundary is not a valid polygon.
+        return false;
+    }
+
+    // Faces inside the region have an odd nesting level.
+    for (auto fh : cdt.all_face_handles()) fh->info() = -1;
+    std::list<typename CDT::Edge> border;
+    auto mark = [&](Face_handle start, int level) {
+        if (start->info() != -1) return;
+        std::list<Face_handle> queue{start};
+        while (!queue.empty()) {
+            Face_handle fh = queue.front();
+            queue.pop_front();
+            if (fh->info() != -1) continue;
+            fh->info() = level;
+            for (int i = 0; i < 3; i++) {
+                Face_handle neighbor = fh->neighbor(i);
+                if (neighbor->info() != -1) continue;
+                if (cdt.is_constrained(typename CDT::Edge(fh, i))) {
+                    border.emplace_back(fh, i);
+                } else {
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+    };
+    mark(cdt.infinite_face(), 0);
+    while (!border.empty()) {
+        const auto edge = border.front();
+        border.pop_front();
+        Face_handle neighbor = edge.first->neighbor(edge.second);
+        if (neighbor->info() == -1) mark(neighbor, edge.first->info() + 1);
+    }
+
+    triangles.clear();
+    for (auto fh : cdt.finite_face_handles()) {
+        if (fh->info() % 2 == 1) {
+            triangles.push_back(
+                {fh->vertex(0)->info(), fh->vertex(1)->info(), fh->vertex(2)->info()});
+        }
+    }
+    return !triangles.empty();
+}
+
+/**
+ * Collect the boundary loops and the interior vertices used outside of a
+ * region.  Returns false if the boundary is pinched.
+ */
+bool extract_boundary(const MatrixIr& faces,
+    const std::pmr::vector<Index>& opposite,
+    const std::pmr::vector<Index>& region_of,
+    const std::pmr::vector<Index>& valence,
+    Region& region)
+{
+    const Index region_id = region_of[region.faces.front()];
+    std::unordered_map<Index, Index> next;
+    std::unordered_map<Index, Index> region_valence;
+    for (const Index f : region.faces) {
+        for (Index c = 0; c < 3; c++) {
+            const Index v0 = faces(f, c);
+            const Index v1 = faces(f, (c + 1) % 3);
+            region_valence[v0]++;
+            const Index twin = opposite[3 * f + c];
+            if (twin >= 0 && region_of[twin / 3] == region_id) continue;
+            if (!next.emplace(v0, v1).second) return false;
+        }
+    }
+
+    for (const auto& [v, count] : region_valence) {
+        if (next.count(v) == 0 && valence[v] > count) {
+            region.isolated_vertices.push_back(v);
+        }
+    }
+
+    std::unordered_map<Index, bool> visited;
+    for (const auto& [start, unused] : next) {
+        if (visited[start]) continue;
+        std::vector<Index> loop;
+        Index v = start;
+        do {
+            visited[v] = true;
+            loop.push_back(v);
+            const auto it = next.find(v);
+            if (it == next.end()) return false;
+            v = it->second;
+        } while (v != start && loop.size() <= next.size());
+        if (v != start) return false;
+        region.loops.push_back(std::move(loop));
+    }
+    return true;
+}
+
+} // namespace
+
+void merge(Topology::ResolvedMesh& mesh,
+    VectorI& patches,
+    VectorI& face_labels,
+    Metrics& metrics,
+    std::pmr::memory_resource* resource)
+{
+    ScopedTimer timer(metrics, "merge_coplanar");
+    const ExactUtils::MatrixEr& vertices = mesh.vertices;
+    const MatrixIr& faces = mesh.faces;
+    const Index num_faces = faces.rows();
+    const Index num_vertices = vertices.rows();
+
+    // Opposite corner across each manifold edge, -1 elsewhere.  Corner c of
+    // face f stands for the edge (faces(f, c), faces(f, c + 1)).
+    std::pmr::vector<Index> opposite(3 * num_faces, -1, resource);
+    {
+        std::pmr::vector<std::array<Index, 3>> edges(3 * num_faces, resource);
+        for (Index f = 0; f < num_faces; f++) {
+            for (Index c = 0; c < 3; c++) {
+                const Index v0 = faces(f, c);
+                const Index v1 = faces(f, (c + 1) % 3);
+                edges[3 * f + c] = {std::min(v0, v1), std::max(v0, v1), 3 * f + c};
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size();) {
+            size_t j = i + 1;
+            while (j < edges.size() && edges[j][0] == edges[i][0] && edges[j][1] == edges[i][1])
+                j++;
+            if (j - i == 2) {
+                const Index a = edges[i][2];
+                const Index b = edges[i + 1][2];
+                // Consistently oriented faces traverse the edge in opposite directions.
+                if (faces(a / 3, a % 3) != faces(b / 3, b % 3)) {
+                    opposite[a] = b;
+                    opposite[b] = a;
+                }
+            }
+            i = j;
+        }
+    }
+
+    std::pmr::vector<Index> valence(num_vertices, 0, resource);
+    for (Index f = 0; f < num_faces; f++) {
+        for (Index c = 0; c < 3; c++) valence[faces(f, c)]++;
+    }
+
+    // Faces with the same vertices as another face, from a coincident input
+    // surface.  Retriangulating either copy on its own could pick different
+    // diagonals for cocircular points, so they are never merged.
+    std::pmr::vector<bool> coincident(num_faces, false, resource);
+    {
+        std::pmr::vector<std::array<Index, 4>> keys(num_faces, resource);
+        for (Index f = 0; f < num_faces; f++) {
+            std::array<Index, 3> corners = {faces(f, 0), faces(f, 1), faces(f, 2)};
+            std::sort(corners.begin(), corners.end());
+            keys[f] = {corners[0], corners[1], corners[2], f};
+        }
+        std::sort(keys.begin(), keys.end());
+        for (Index i = 1; i < num_faces; i++) {
+            if (std::equal(keys[i].begin(), keys[i].begin() + 3, keys[i - 1].begin())) {
+                coincident[keys[i][3]] = true;
+                coincident[keys[i - 1][3]] = true;
+            }
+        }
+    }
+
+    UnionFind regions(num_faces);
+    for (Index corner = 0; corner < 3 * num_faces; corner++) {
+        const Index twin = opposite[corner];
+        if (twin < corner) continue;
+        const Index f = corner / 3;
+        const Index g = twin / 3;
+        if (coincident[f] || coincident[g]) continue;
+        if (patches[f] != patches[g] || face_labels[f] != face_labels[g]) continue;
+        const Index apex = faces(g, (twin % 3 + 2) % 3);
+        if (CGAL::orientation(get_point(vertices, faces(f, 0)),
+                get_point(vertices, faces(f, 1)),
+                get_point(vertices, faces(f, 2)),
+                get_point(vertices, apex)) != CGAL::COPLANAR) {
+            continue;
+        }
+        // Coplanar but folded over the shared edge.
+        if (CGAL::is_negative(get_normal(vertices, faces(f, 0), faces(f, 1), faces(f, 2)) *
+                              get_normal(vertices, faces(g, 0), faces(g, 1), faces(g, 2)))) {
+            continue;
+        }
+        regions.unite(f, g);
+    }
+
+    std::pmr::vector<Index> region_of(num_faces, resource);
+    std::unordered_map<Index, Region> region_map;
+    for (Index f = 0; f < num_faces; f++) {
+        region_of[f] = regions.find(f);
+        region_map[region_of[f]].faces.push_back(f);
+    }
+
+    // Retriangulate each region, keeping the original faces if it fails or
+    // does not reduce the face count.
+    std::unordered_map<Index, std::vector<Triangle>> merged;
+    for (auto& [region_id, region] : region_map) {
+        if (region.faces.size() < 2) continue;
+        if (!extract_boundary(faces, opposite, region_of, valence, region)) continue;
+
+        const Index f0 = region.faces.front();
+        const Vector normal = get_normal(vertices, faces(f0, 0), faces(f0, 1), faces(f0, 2));
+        const std::array<double, 3> magnitude = {std::abs(CGAL::to_double(normal.x())),
+            std::abs(CGAL::to_double(normal.y())),
+            std::abs(CGAL::to_double(normal.z()))};
+        const auto axis = std::max_element(magnitude.begin(), magnitude.end()) - magnitude.begin();
+
+        // Project along the dominant axis of the normal.
+        std::vector<Triangle> triangles;
+        bool ok = false;
+        switch (axis) {
+        case 0:
+            ok = triangulate<CGAL::Projection_traits_yz_3<Kernel>>(vertices, region, triangles);
+            break;
+        case 1:
+            ok = triangulate<CGAL::Projection_traits_xz_3<Kernel>>(vertices, region, triangles);
+            break;
+        default:
+            ok = triangulate<CGAL::Projection_traits_xy_3<Kernel>>(vertices, region, triangles);
+            break;
+        }
+        if (!ok || triangles.size() >= region.faces.size()) continue;
+
+        // The projection may flip the orientation.
+        const Triangle& t = triangles.front();
+        if (CGAL::is_negative(get_normal(vertices, t[0], t[1], t[2]) * normal)) {
+            for (auto& triangle : triangles) std::swap(triangle[1], triangle[2]);
+        }
+        merged.emplace(region_id, std::move(triangles));
+    }
+
+    // Assemble, each merged region taking the place of its first face.
+    std::pmr::vector<Triangle> out_faces(resource);
+    std::pmr::vector<int> out_patches(resource), out_labels(resource);
+    out_faces.reserve(num_faces);
+    out_patches.reserve(num_faces);
+    out_labels.reserve(num_faces);
+    for (Index f = 0; f < num_faces; f++) {
+        const auto it = merged.find(region_of[f]);
+        if (it == merged.end()) {
+            out_faces.push_back({faces(f, 0), faces(f, 1), faces(f, 2)});
+            out_patches.push_back(patches[f]);
+            out_labels.push_back(face_labels[f]);
+        } else if (!it->second.empty()) {
+            for (const auto& triangle : it->second) {
+                out_faces.push_back(triangle);
+                out_patches.push_back(patches[f]);
+                out_labels.push_back(face_labels[f]);
+            }
+            it->second.clear();
+        }
+    }
+
+    // Drop the vertices left unreferenced by the retriangulation.
+    std::pmr::vector<Index> vertex_map(num_vertices, -1, resource);
+    for (const auto& triangle : out_faces) {
+        for (const Index v : triangle) vertex_map[v] = 0;
+    }
+    Index num_out_vertices = 0;
+    for (auto& v : vertex_map) {
+        if (v == 0) v = num_out_vertices++;
+    }
+    ExactUtils::MatrixEr out_vertices(num_out_vertices, 3);
+    for (Index v = 0; v < num_vertices; v++) {
+        if (vertex_map[v] >= 0) out_vertices.row(vertex_map[v]) = vertices.row(v);
+    }
+
+    metrics.values["merge_coplanar.num_input_faces"] = static_cast<double>(num_faces);
+    metrics.values["merge_coplanar.num_output_faces"] = static_cast<double>(out_faces.size());
+    metrics.values["merge_coplanar.num_regions"] = static_cast<double>(merged.size());
+    metrics.values["merge_coplanar.num_removed_vertices"] =
+        static_cast<double>(num_vertices - num_out_vertices);
+
+    mesh.clear_edge_map();
+    mesh.vertices = std::move(out_vertices);
+    mesh.faces.resize(out_faces.size(), 3);
+    patches.resize(out_faces.size());
+    face_labels.resize(out_faces.size());
+    for (Index i = 0; i < static_cast<Index>(out_faces.size()); i++) {
+        for (Index c = 0; c < 3; c++) mesh.faces(i, c) = vertex_map[out_faces[i][c]];
+        patches[i] = out_patches[i];
+        face_labels[i] = out_labels[i];
+    }
+}
+
+} // namespace CoplanarMerge
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
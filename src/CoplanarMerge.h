@@ -0,0 +1,46 @@
+#pragma once
+
+#ifdef ARRANGEMENT_IGL
+
+#include <arrangement/EigenTypedef.h>
+#include <arrangement/Metrics.h>
+
+#include <memory_resource>
+
+#include "Topology.h"
+
+namespace arrangement {
+namespace CoplanarMerge {
+
+/**
+ * Merge coplanar faces of a resolved mesh and retriangulate them minimally.
+ *
+ * Faces sharing a manifold edge, a patch, a label and the same oriented
+ * supporting plane (tested exactly) are grouped into regions.  Each region is
+ * retriangulated from its boundary loops with a constrained triangulation,
+ * dropping its interior vertices unless other faces use them.  Boundary
+ * vertices are all kept, so the mesh stays conforming with its neighbors and
+ * the patch and cell structure is unchanged.  Regions with pinched boundaries
+ * are left as is, and so are faces coincident with another face (overlapping
+ * coplanar input), so that both copies keep the same triangulation.
+ *
+ * Records the stage time in `metrics` ("merge_coplanar") along with the face
+ * counts before and after, the number of merged regions and of removed
+ * vertices.
+ *
+ * @param mesh Resolved mesh, merged in place.  Its edge map is released.
+ * @param patches Per-face patch indices, updated to match the merged faces.
+ * @param face_labels Per-face labels, updated to match the merged faces.
+ * @param metrics Metrics to record into.
+ * @param resource Memory resource for the per-face temporaries.
+ */
+void merge(Topology::ResolvedMesh& mesh,
+    VectorI& patches,
+    VectorI& face_labels,
+    Metrics& metrics,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+} // namespace CoplanarMerge
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
@@ -0,0 +1,239 @@
+#include <arrangement/EngineRegistry.h>
+#include <arrangement/Exception.h>
+
+#include "BuiltinEngines.h"
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace arrangement {
+namespace EngineRegistry {
+
+namespace {
+
+struct Registry
+{
+    Registry()
+    {
+        // Engines compiled into the library.  In plugin builds there are
+        // none, their modules are loaded on first use instead.
+#ifdef ARRANGEMENT_IGL
+        factories.merge(get_mesh_engine_factories());
+#endif
+#ifdef ARRANGEMENT_FAST
+        factories.merge(get_fast_engine_factories());
+#endif
+#ifdef ARRANGEMENT_GEOGRAM
+        factories.merge(get_geogram_engine_factories());
+#endif
+    }
+
+    /// Guards the members below.  Not held while loading a module, whose
+    /// entry point registers engines.
+    std::mutex mutex;
+    std::map<std::string, Factory> factories;
+    std::map<std::string, double> load_times;
+    /// Engines whose module was looked up by create(), loaded or not, so that
+    /// a missing module is not searched for on every call.  A module that
+    /// fails to load is removed again, the next call retries and throws.  Only
+    /// inserted while holding load_mutex: a caller finding an engine here
+    /// without its factory waits on load_mutex for the lookup to finish.
+    std::set<std::string> searched_modules;
+
+    /// Serializes module lookups and loading.
+    std::mutex load_mutex;
+};
+
+Registry& get_registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+/// Module providing engine `name`, empty if `name` cannot be a module name.
+std::string get_module_name(const std::string& name)
+{
+    if (name.empty() || !std::all_of(name.begin(), name.end(), [](char c) {
+            return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+        })) {
+        return "";
+    }
+    // The planar engine shares the libigl/CGAL dependencies of the mesh engine.
+    if (name == "planar") return "arrangement_mesh";
+    return "arrangement_" + name;
+}
+
+std::vector<fs::path> get_search_paths()
+{
+    std::vector<fs::path> paths;
+    if (const char* env = std::getenv("ARRANGEMENT_PLUGIN_PATH")) {
+        std::istringstream stream(env);
+        std::string path;
+        while (std::getline(stream, path, ':')) {
+            if (!path.empty()) paths.emplace_back(path);
+        }
+    }
+#ifndef _WIN32
+    // Next to the library holding this code: the shared arrangement library
+    // in plugin builds, else the program or module linking it.
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(&get_search_paths), &info) != 0 &&
+        info.dli_fname != nullptr) {
+        paths.push_back(fs::path(info.dli_fname).parent_path());
+    }
+#endif
+    return paths;
+}
+
+/// Path of the module file providing engine `name`, empty if not found.
+std::string find_module(const std::string& name)
+{
+    const std::string module = get_module_name(name);
+    if (module.empty()) return "";
+    for (const auto& path : get_search_paths()) {
+        const fs::path filename = path / (module + ".so");
+        std::error_code error;
+        if (fs::is_regular_file(filename, error)) return filename.string();
+    }
+    return "";
+}
+
+/// Load a module, with load_mutex held.
+void load_module(Registry& registry, const std::string& filename)
+{
+#ifdef _WIN32
+    throw NotImplementedError("Engine plugins are not supported on this platform");
+#else
+    std::error_code error;
+    fs::path path = fs::weakly_canonical(filename, error);
+    if (error) path = filename;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (registry.load_times.count(path.string()) > 0) return;
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    // Never closed: engines created from the module may outlive any caller.
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) {
+        const char* message = dlerror();
+        throw RuntimeError("Cannot load engine plugin " + path.string() + ": " +
+                           (message != nullptr ? message : "unknown error"));
+    }
+    auto entry = reinterpret_cast<void (*)()>(dlsym(handle, ARRANGEMENT_PLUGIN_SYMBOL));
+    if (entry == nullptr) {
+        dlclose(handle);
+        throw RuntimeError(path.string() + " is not an arrangement engine plugin");
+    }
+    entry();
+    const auto end = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.load_times[path.string()] = std::chrono::duration<double>(end - begin).count();
+#endif
+}
+
+/// Factory of engine `name`, empty if not registered.
+Factory find_factory(Registry& registry, const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto itr = registry.factories.find(name);
+    return itr != registry.factories.end() ? itr->second : Factory();
+}
+
+} // namespace
+
+void register_engine(const std::string& name, Factory factory)
+{
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.factories[name] = std::move(factory);
+}
+
+Arrangement::Ptr create(const std::string& name,
+    MatrixFr vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    const EngineOptions& options)
+{
+    auto& registry = get_registry();
+    Factory factory = find_factory(registry, name);
+    if (!factory) {
+        // Another caller may be loading the module: wait for it, then look
+        // the engine up again.
+        std::lock_guard<std::mutex> load_lock(registry.load_mutex);
+        factory = find_factory(registry, name);
+        bool search = false;
+        if (!factory) {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            search = registry.searched_modules.insert(name).second;
+        }
+        if (search) {
+            const std::string filename = find_module(name);
+            if (!filename.empty()) {
+                try {
+                    load_module(registry, filename);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(registry.mutex);
+                    registry.searched_modules.erase(name);
+                    throw;
+                }
+                factory = find_factory(registry, name);
+            }
+        }
+    }
+    if (!factory) return nullptr;
+    return factory(std::move(vertices), faces, face_labels, options);
+}
+
+bool is_available(const std::string& name)
+{
+    auto& registry = get_registry();
+    bool searched = false;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (registry.factories.count(name) > 0) return true;
+        searched = registry.searched_modules.count(name) > 0;
+    }
+    if (!searched) return !find_module(name).empty();
+    // The module may still be loading.
+    std::lock_guard<std::mutex> load_lock(registry.load_mutex);
+    return static_cast<bool>(find_factory(registry, name));
+}
+
+std::vector<std::string> get_engine_names()
+{
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<std::string> names;
+    for (const auto& [name, factory] : registry.factories) names.push_back(name);
+    return names;
+}
+
+void load_plugin(const std::string& filename)
+{
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> load_lock(registry.load_mutex);
+    load_module(registry, filename);
+}
+
+std::map<std::string, double> get_plugin_load_times()
+{
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.load_times;
+}
+
+} // namespace EngineRegistry
+} // namespace arrangement
@@ -0,0 +1,136 @@
+#pragma once
+
+#ifdef ARRANGEMENT_IGL
+
+#include <arrangement/Exception.h>
+
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+#include <CGAL/Fraction_traits.h>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace arrangement {
+namespace ExactUtils {
+
+typedef CGAL::Epeck::FT ExactScalar;
+typedef Eigen::Matrix<ExactScalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixEr;
+
+/**
+ * Encode an exact number as a rational string "numerator/denominator".  The
+ * denominator is omitted when it is 1.
+ */
+inline std::string to_rational_string(const ExactScalar& value)
+{
+    typedef std::decay_t<decltype(CGAL::exact(value))> Rational;
+    typedef CGAL::Fraction_traits<Rational> FracTraits;
+    typename FracTraits::Numerator_type num;
+    typename FracTraits::Denominator_type den;
+    typename FracTraits::Decompose()(CGAL::exact(value), num, den);
+
+    std::ostringstream out;
+    out << num;
+    if (den != 1) out << "/" << den;
+    return out.str();
+}
+
+/**
+ * Whether `str` is an optionally signed, non-empty decimal integer.
+ */
+inline bool is_integer_string(const std::string& str)
+{
+    const size_t begin = !str.empty() && (str[0] == '-' || str[0] == '+') ? 1 : 0;
+    return str.size() > begin && std::all_of(str.begin() + begin, str.end(), [](char c) {
+        return c >= '0' && c <= '9';
+    });
+}
+
+/**
+ * Decode a rational string produced by to_rational_string().  Plain integers
+ * are accepted as well.
+ *
+ * @throws RuntimeError if the string is not an integer or a fraction of
+ * integers with a non-zero denominator.  It is checked here since the GMP
+ * integers do not report malformed digits, and a zero denominator would
+ * crash when the fraction is normalized.
+ */
+inline ExactScalar from_rational_string(const std::string& str)
+{
+    typedef std::decay_t<decltype(CGAL::exact(std::declval<ExactScalar>()))> Rational;
+    typedef CGAL::Fraction_traits<Rational> FracTraits;
+    typedef typename FracTraits::Numerator_type Integer;
+
+    const auto slash = str.find('/');
+    const std::string num = str.substr(0, slash);
+    const std::string den = slash == std::string::npos ? "1" : str.substr(slash + 1);
+    if (!is_integer_string(num) || !is_integer_string(den) ||
+        std::all_of(den.begin(), den.end(), [](char c) { return c < '1' || c > '9'; })) {
+        throw RuntimeError("Invalid rational coordinate: " + str);
+    }
+    // GMP does not accept a leading '+'.
+    auto strip_plus = [](const std::string& s) { return s[0] == '+' ? s.substr(1) : s; };
+    return ExactScalar(typename FracTraits::Compose()(
+        Integer(strip_plus(num).c_str()), Integer(strip_plus(den).c_str())));
+}
+
+/**
+ * Convert an exact rational number of another number type to ExactScalar.
+ * Number types ExactScalar cannot be built from are converted through their
+ * numerator and denominator.
+ */
+template <typename FT>
+ExactScalar to_exact_scalar(const FT& value)
+{
+    if constexpr (std::is_same_v<FT, ExactScalar>) {
+        return value;
+    } else if constexpr (std::is_constructible_v<ExactScalar, const FT&>) {
+        return ExactScalar(value);
+    } else {
+        typedef CGAL::Fraction_traits<FT> FracTraits;
+        typename FracTraits::Numerator_type num;
+        typename FracTraits::Denominator_type den;
+        typename FracTraits::Decompose()(value, num, den);
+
+        std::ostringstream out;
+        out << num << "/" << den;
+        return from_rational_string(out.str());
+    }
+}
+
+/**
+ * Encode an exact matrix as rational strings in row-major order.
+ */
+inline void to_rational_strings(const MatrixEr& values, std::vector<std::string>& strings)
+{
+    strings.resize(values.size());
+    std::transform(values.data(),
+        values.data() + values.size(),
+        strings.begin(),
+        [](const ExactScalar& value) { return to_rational_string(value); });
+}
+
+/**
+ * Decode rational strings in row-major order into an exact matrix with 3
+ * columns.
+ */
+inline MatrixEr from_rational_strings(const std::vector<std::string>& strings)
+{
+    if (strings.size() % 3 != 0) {
+        throw RuntimeError("Exact coordinates must come in groups of 3");
+    }
+    MatrixEr values(strings.size() / 3, 3);
+    std::transform(strings.begin(), strings.end(), values.data(), [](const std::string& str) {
+        return from_rational_string(str);
+    });
+    return values;
+}
+
+} // namespace ExactUtils
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
@@ -1,86 +1,217 @@
 #ifdef ARRANGEMENT_FAST
 
+#include <arrangement/Exception.h>
 #include <arrangement/FastArrangement.h>
 #include <arrangement/MatrixUtils.h>
+#include <arrangement/Trace.h>
 
 #include <CGAL/Exact_predicates_exact_constructions_kernel.h>
 #include <CGAL/intersections.h>
 
 #include <igl/copyleft/cgal/RemeshSelfIntersectionsParam.h>
 #include <igl/copyleft/cgal/SelfIntersectMesh.h>
-#include <igl/copyleft/cgal/extract_cells.h>
-#include <igl/copyleft/cgal/propagate_winding_numbers.h>
-#include <igl/extract_manifold_patches.h>
 #include <igl/remove_unreferenced.h>
-#include <igl/unique_edge_map.h>
 #include <igl/write_triangle_mesh.h>
 
 #include <solve_intersections.h>
 
-#include <chrono>
+#include <tbb/task_arena.h>
+#ifdef ARRANGEMENT_WITH_TRACE
+#include <tbb/task_scheduler_observer.h>
+#endif
+
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "BuiltinEngines.h"
+#include "CoplanarMerge.h"
+#include "ExactUtils.h"
+#include "Quantization.h"
+#include "RegionResolver.h"
+#include "RunArena.h"
+#include "SnapRounding.h"
+#include "Topology.h"
 
 using namespace arrangement;
-#ifdef __clang__
-__attribute__((optnone))
-#endif
-void FastArrangement::run()
-{
-    auto t_begin = std::chrono::high_resolution_clock::now();
 
-    std::vector<double> in_coords, out_coords;
+namespace {
+
+typedef CGAL::Epeck Kernel;
+typedef Kernel::FT ExactScalar;
+typedef Eigen::Matrix<ExactScalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixEr;
+
+/// Buffers of resolve_self_intersections(), kept across runs.
+struct Workspace
+{
+    std::vector<double> in_coords;
     std::vector<uint> in_tris, out_tris, in_labels;
     std::vector<genericPoint*> gen_points;
     std::vector<std::bitset<NBIT>> out_labels;
+    std::unique_ptr<tbb::task_arena> job_arena;
+    size_t job_arena_num_threads = 0;
+
+    /// Get the task arena, recreated only when the thread count changes.
+    tbb::task_arena& get_job_arena(size_t num_threads)
+    {
+        if (job_arena == nullptr || job_arena_num_threads != num_threads) {
+            job_arena = std::make_unique<tbb::task_arena>(
+                num_threads > 0 ? static_cast<int>(num_threads) : tbb::task_arena::automatic);
+            job_arena_num_threads = num_threads;
+        }
+        return *job_arena;
+    }
+
+    /// Empty the buffers, keeping their capacity.
+    void clear()
+    {
+        in_coords.clear();
+        in_tris.clear();
+        out_tris.clear();
+        in_labels.clear();
+        gen_points.clear();
+        out_labels.clear();
+    }
+};
+
+#ifdef ARRANGEMENT_WITH_TRACE
+/// Record the time each thread spends in a task arena as a "worker" span.
+class WorkerObserver : public tbb::task_scheduler_observer
+{
+public:
+    explicit WorkerObserver(tbb::task_arena& arena)
+        : tbb::task_scheduler_observer(arena)
+    {
+        observe(true);
+    }
+
+    ~WorkerObserver() { observe(false); }
+
+    void on_scheduler_entry(bool is_worker) override
+    {
+        if (is_worker) Trace::set_thread_name("tbb worker");
+        get_entry_time() = Trace::Clock::now();
+    }
+
+    void on_scheduler_exit(bool /*is_worker*/) override
+    {
+        Trace::record_span("task_arena", "worker", get_entry_time(), Trace::Clock::now());
+    }
+
+private:
+    static Trace::Clock::time_point& get_entry_time()
+    {
+        thread_local Trace::Clock::time_point entry_time;
+        return entry_time;
+    }
+};
+#endif
+
+/// Number of intersection points reconstructed with each arithmetic.
+struct ReconstructionStats
+{
+    size_t num_integer_points = 0;
+    size_t num_fallback_points = 0;
+    /// Among the integer points, the 3-plane intersections.
+    size_t num_integer_tpi_points = 0;
+};
 
-    in_coords.reserve(m_vertices.size());
+#ifdef __clang__
+__attribute__((optnone))
+#endif
+void resolve_self_intersections(const MatrixFr& in_vertices,
+    const MatrixIr& in_faces,
+    const VectorI& in_face_labels,
+    size_t num_threads,
+    Workspace& workspace,
+    MatrixEr& resolved_vertices,
+    MatrixIr& resolved_faces,
+    VectorI& out_face_labels,
+    int grid_bits = -1,
+    ReconstructionStats* stats = nullptr)
+{
+    workspace.clear();
+    auto& in_coords = workspace.in_coords;
+    auto& in_tris = workspace.in_tris;
+    auto& out_tris = workspace.out_tris;
+    auto& in_labels = workspace.in_labels;
+    auto& gen_points = workspace.gen_points;
+    auto& out_labels = workspace.out_labels;
+
+    in_coords.reserve(in_vertices.size());
     std::copy(
-        m_vertices.data(), m_vertices.data() + m_vertices.size(), std::back_inserter(in_coords));
-    in_tris.reserve(m_faces.size());
-    std::copy(m_faces.data(), m_faces.data() + m_faces.size(), std::back_inserter(in_tris));
-    in_labels.reserve(m_vertices.size());
-    const auto max_label = m_in_face_labels.maxCoeff();
-    assert(max_label < NBIT);
-    std::copy(m_in_face_labels.data(),
-        m_in_face_labels.data() + m_in_face_labels.size(),
+        in_vertices.data(), in_vertices.data() + in_vertices.size(), std::back_inserter(in_coords));
+    if (static_cast<std::uint64_t>(in_vertices.rows()) > std::numeric_limits<uint>::max()) {
+        throw RuntimeError("FastArrangement requires vertex indices that fit in 32 bits");
+    }
+    in_tris.reserve(in_faces.size());
+    std::copy(in_faces.data(), in_faces.data() + in_faces.size(), std::back_inserter(in_tris));
+    in_labels.reserve(in_vertices.size());
+    const auto max_label = in_face_labels.maxCoeff();
+    if (in_face_labels.minCoeff() < 0 || max_label >= static_cast<int>(NBIT)) {
+        throw RuntimeError("FastArrangement requires face labels in [0, " +
+                           std::to_string(NBIT) + ")");
+    }
+    std::copy(in_face_labels.data(),
+        in_face_labels.data() + in_face_labels.size(),
         std::back_inserter(in_labels));
 
     /*-------------------------------------------------------------------
      * There are 4 versions of the solveIntersections function. Please
      * refer to the solve_intersections.h file to see how to use them. */
 
-    // igl::write_triangle_mesh("arrangement_debug.ply", m_vertices, m_faces,
+    // igl::write_triangle_mesh("arrangement_debug.ply", in_vertices, in_faces,
     // igl::FileEncoding::Binary);
+    // Run all TBB work of this job inside its own arena so that the thread
+    // count is capped per job.  The points live in `arena`, which is released
+    // on return.
     point_arena arena;
-    solveIntersections(in_coords, in_tris, in_labels, arena, gen_points, out_tris, out_labels);
-
-    auto t_mid = std::chrono::high_resolution_clock::now();
+    tbb::task_arena& job_arena = workspace.get_job_arena(num_threads);
+#ifdef ARRANGEMENT_WITH_TRACE
+    std::optional<WorkerObserver> observer;
+    if (Trace::is_recording()) observer.emplace(job_arena);
+#endif
+    job_arena.execute([&]() {
+        ARRANGEMENT_TRACE_SCOPE("solve_intersections");
+        solveIntersections(
+            in_coords, in_tris, in_labels, arena, gen_points, out_tris, out_labels);
+    });
 
     // Copy source face labels over.
     assert(out_labels.size() == out_tris.size() / 3);
-    m_out_face_labels.resize(out_labels.size());
-    for (size_t i = 0; i < m_out_face_labels.size(); i++) {
+    out_face_labels.resize(out_labels.size());
+    for (size_t i = 0; i < out_face_labels.size(); i++) {
         const auto& bits = out_labels[i];
-        m_out_face_labels[i] = max_label + 1;
+        out_face_labels[i] = max_label + 1;
         for (size_t j = 0; j < NBIT; j++) {
             if (bits[j]) {
-                m_out_face_labels[i] = static_cast<int>(j);
+                out_face_labels[i] = static_cast<int>(j);
                 break;
             }
         }
-        assert(m_out_face_labels[i] <= max_label);
+        assert(out_face_labels[i] <= max_label);
     }
 
-    typedef CGAL::Epeck Kernel;
-    typedef Kernel::FT ExactScalar;
-    typedef Eigen::Matrix<ExactScalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixEr;
-    MatrixEr resolved_vertices;
-    MatrixIr resolved_faces;
+    // Exact reconstruction of the implicit points, mostly CGAL evaluation.
+    ARRANGEMENT_TRACE_SCOPE("reconstruct_points");
 
     // See https://github.com/gcherchi/FastAndRobustMeshArrangements/issues/11
     // for explanation of the magic number 5 and the multipler `s`.
     resolved_vertices.resize(gen_points.size() - 5, 3);
     const ExactScalar s = gen_points.back()->toExplicit3D().X();
+
+    // Quantized input (grid_bits >= 0): the explicit points are integers
+    // times the multiplier, so intersections are reconstructed with integer
+    // arithmetic and Epeck is only used when the bounds are exceeded.
+    const double scale = gen_points.back()->toExplicit3D().X();
+    const auto to_int_point = [scale](const auto& p, Quantization::IntPoint& q) {
+        return Quantization::to_int_point(p.X(), p.Y(), p.Z(), scale, q);
+    };
+    Quantization::ExactPoint exact_point;
     for (size_t i = 0; i < gen_points.size() - 5; i++) {
         auto p = gen_points[i];
         assert(p != nullptr);
@@ -92,6 +223,19 @@ void FastArrangement::run()
         case LPI: {
             // Line plane intersection.
             const auto& q = p->toLPI();
+            if (grid_bits >= 0) {
+                Quantization::IntPoint P, Q, R, S, T;
+                if (to_int_point(q.P(), P) && to_int_point(q.Q(), Q) &&
+                    to_int_point(q.R(), R) && to_int_point(q.S(), S) &&
+                    to_int_point(q.T(), T) &&
+                    Quantization::intersect_line_plane(
+                        P, Q, R, S, T, grid_bits, exact_point)) {
+                    resolved_vertices.row(i) << exact_point[0], exact_point[1], exact_point[2];
+                    stats->num_integer_points++;
+                    break;
+                }
+                stats->num_fallback_points++;
+            }
             Kernel::Point_3 P(q.P().X() / s, q.P().Y() / s, q.P().Z() / s);
             Kernel::Point_3 Q(q.Q().X() / s, q.Q().Y() / s, q.Q().Z() / s);
             Kernel::Point_3 R(q.R().X() / s, q.R().Y() / s, q.R().Z() / s);
@@ -114,6 +258,21 @@ void FastArrangement::run()
         case TPI: {
             // 3 plane intersection.
             const auto& q = p->toTPI();
+            if (grid_bits >= 0) {
+                std::array<Quantization::IntPoint, 3> V, W, U;
+                if (to_int_point(q.V1(), V[0]) && to_int_point(q.V2(), V[1]) &&
+                    to_int_point(q.V3(), V[2]) && to_int_point(q.W1(), W[0]) &&
+                    to_int_point(q.W2(), W[1]) && to_int_point(q.W3(), W[2]) &&
+                    to_int_point(q.U1(), U[0]) && to_int_point(q.U2(), U[1]) &&
+                    to_int_point(q.U3(), U[2]) &&
+                    Quantization::intersect_three_planes(V, W, U, grid_bits, exact_point)) {
+                    resolved_vertices.row(i) << exact_point[0], exact_point[1], exact_point[2];
+                    stats->num_integer_points++;
+                    stats->num_integer_tpi_points++;
+                    break;
+                }
+                stats->num_fallback_points++;
+            }
             Kernel::Point_3 V1(q.V1().X() / s, q.V1().Y() / s, q.V1().Z() / s);
             Kernel::Point_3 V2(q.V2().X() / s, q.V2().Y() / s, q.V2().Z() / s);
             Kernel::Point_3 V3(q.V3().X() / s, q.V3().Y() / s, q.V3().Z() / s);
@@ -152,50 +311,252 @@ void FastArrangement::run()
 
     assert(resolved_faces.maxCoeff() < resolved_vertices.rows());
 
-    // Build edge map
-    Eigen::MatrixXi E, uE, uEC, uEE;
-    Eigen::VectorXi EMAP;
-    igl::unique_edge_map(resolved_faces, E, uE, EMAP, uEC, uEE);
-
-    // patches
-    const size_t num_patches =
-        igl::extract_manifold_patches(resolved_faces, EMAP, uEC, uEE, m_patches);
-
-    // cells
-    const size_t num_cells = igl::copyleft::cgal::extract_cells(
-        resolved_vertices, resolved_faces, m_patches, uE, EMAP, uEC, uEE, m_cells);
-    assert(m_cells.rows() == num_patches);
-    assert(m_cells.cols() == 2);
-
-    VectorI labels = VectorI::Zero(resolved_faces.rows());
-    //// winding numbers
-    // igl::copyleft::cgal::propagate_winding_numbers(
-    //        resolved_vertices, resolved_faces,
-    //        uE, uE2E, num_patches, m_patches, num_cells, m_cells,
-    //        labels, m_winding_number);
-
-    // Cast resolved mesh back to Float
-    m_vertices = MatrixFr(resolved_vertices.rows(), resolved_vertices.cols());
-    std::transform(resolved_vertices.data(),
-        resolved_vertices.data() + resolved_vertices.size(),
-        m_vertices.data(),
-        [](const ExactScalar& val) { return CGAL::to_double(val); });
-    m_faces = resolved_faces;
-
-    auto t_end = std::chrono::high_resolution_clock::now();
-    if (m_verbose) {
-        std::chrono::duration<double> resolve_time = t_mid - t_begin;
-        std::chrono::duration<double> extract_time = t_end - t_mid;
-        std::cout << "Arrangement: resolving self-intersection: " << resolve_time.count() <<
-        std::endl; std::cout << "Arrangement: extracting arrangement: " << extract_time.count() <<
-        std::endl;
-    }
-
     // computeApproximateCoordinates(gen_points, out_coords);
 
     // Clean up
     // Note: free points are no longer necessary as the memory is owned by the `arena` object.
     // freePointsMemory(gen_points);
+    gen_points.clear();
+}
+
+} // namespace
+
+struct FastArrangement::State : public Topology::ResolvedMesh
+{
+    Workspace workspace;
+    RunArena run_arena;
+
+    std::pmr::memory_resource* get_resource(bool use_run_arena)
+    {
+        return use_run_arena ? run_arena.get() : std::pmr::get_default_resource();
+    }
+};
+
+FastArrangement::FastArrangement(
+    MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+    : Base(std::move(vertices), faces, face_labels)
+    , m_state(std::make_unique<State>())
+{
+    m_eager_stages = TOPOLOGY_PATCHES | TOPOLOGY_CELLS;
+}
+
+FastArrangement::~FastArrangement() = default;
+
+size_t FastArrangement::get_max_num_labels()
+{
+    return NBIT;
+}
+
+void FastArrangement::reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+{
+    Base::reset(std::move(vertices), faces, face_labels);
+    // Drop the previous result, the workspace is kept.
+    m_state->clear_edge_map();
+    m_state->vertices.resize(0, 3);
+    m_state->faces.resize(0, 3);
+}
+
+#ifdef __clang__
+__attribute__((optnone))
+#endif
+void FastArrangement::run()
+{
+    ARRANGEMENT_TRACE_SCOPE("FastArrangement::run");
+    m_metrics.clear();
+    ScopedTimer stage_timer(m_metrics, "resolve");
+
+    MatrixEr& resolved_vertices = m_state->vertices;
+    MatrixIr& resolved_faces = m_state->faces;
+    Workspace& workspace = m_state->workspace;
+    std::pmr::memory_resource* resource = m_state->get_resource(m_run_arena);
+    m_state->clear_edge_map();
+    if (m_input_resolved) {
+        // Input is already arranged, keep it as is.
+        if (!m_exact_vertices.empty()) {
+            resolved_vertices = ExactUtils::from_rational_strings(m_exact_vertices);
+        } else {
+            resolved_vertices = m_vertices.cast<ExactScalar>();
+        }
+        resolved_faces = m_faces;
+        m_out_face_labels = m_in_face_labels;
+    } else if (m_quantization) {
+        if (!m_exact_vertices.empty()) {
+            throw NotImplementedError("Quantization does not support exact input coordinates");
+        }
+        if (!m_region_of_interest.empty()) {
+            throw NotImplementedError("Quantization does not support regions of interest");
+        }
+        if (m_snap_rounding) {
+            throw NotImplementedError("Quantization does not support snap rounding");
+        }
+        const Float grid_size = m_quantization_grid_size > 0
+                                    ? m_quantization_grid_size
+                                    : Quantization::choose_grid_size(m_vertices);
+        MatrixFr grid_vertices;
+        MatrixIr grid_faces;
+        VectorI grid_face_labels;
+        const int grid_bits = Quantization::quantize(m_vertices,
+            m_faces,
+            m_in_face_labels,
+            grid_size,
+            grid_vertices,
+            grid_faces,
+            grid_face_labels);
+
+        ReconstructionStats stats;
+        resolve_self_intersections(grid_vertices,
+            grid_faces,
+            grid_face_labels,
+            m_num_threads,
+            workspace,
+            resolved_vertices,
+            resolved_faces,
+            m_out_face_labels,
+            Quantization::has_integer_arithmetic() ? grid_bits : -1,
+            &stats);
+
+        // Back from grid units.
+        if (grid_size != 1) {
+            const ExactScalar exact_grid_size(grid_size);
+            std::for_each(resolved_vertices.data(),
+                resolved_vertices.data() + resolved_vertices.size(),
+                [&](ExactScalar& value) { value *= exact_grid_size; });
+        }
+
+        m_metrics.values["quantization_grid_size"] = grid_size;
+        m_metrics.values["quantization_bits"] = static_cast<double>(grid_bits);
+        m_metrics.values["num_collapsed_faces"] =
+            static_cast<double>(m_faces.rows() - grid_faces.rows());
+        m_metrics.values["num_integer_points"] = static_cast<double>(stats.num_integer_points);
+        m_metrics.values["num_fallback_points"] =
+            static_cast<double>(stats.num_fallback_points);
+        m_metrics.values["num_integer_tpi_points"] =
+            static_cast<double>(stats.num_integer_tpi_points);
+    } else if (!m_region_of_interest.empty()) {
+        if (m_snap_rounding) {
+            throw NotImplementedError("Region of interest is not supported with snap rounding");
+        }
+        if (!m_exact_vertices.empty()) {
+            throw NotImplementedError(
+                "FastArrangement only accepts exact input coordinates for resolved input");
+        }
+        // Resolve self intersection within the region only
+        const size_t num_threads = m_num_threads;
+        const size_t num_region_faces = RegionResolver::resolve(m_vertices,
+            m_faces,
+            m_in_face_labels,
+            m_region_of_interest,
+            [num_threads, &workspace](const MatrixFr& V,
+                const MatrixIr& F,
+                const VectorI& L,
+                MatrixEr& RV,
+                MatrixIr& RF,
+                VectorI& RL) {
+                resolve_self_intersections(V, F, L, num_threads, workspace, RV, RF, RL);
+            },
+            resolved_vertices,
+            resolved_faces,
+            m_out_face_labels,
+            resource);
+        m_metrics.values["num_region_faces"] = static_cast<double>(num_region_faces);
+    } else {
+        if (!m_exact_vertices.empty()) {
+            throw NotImplementedError(
+                "FastArrangement only accepts exact input coordinates for resolved input");
+        }
+        resolve_self_intersections(m_vertices,
+            m_faces,
+            m_in_face_labels,
+            m_num_threads,
+            workspace,
+            resolved_vertices,
+            resolved_faces,
+            m_out_face_labels);
+    }
+
+    if (m_snap_rounding) {
+        SnapRounding::snap_round(
+            resolved_vertices, resolved_faces, m_out_face_labels, m_snap_grid_size);
+    }
+    stage_timer.restart("extract");
+
+    reset_topology();
+    if (m_merge_coplanar) {
+        // Patches delimit the regions to merge.
+        ensure_topology(TOPOLOGY_PATCHES);
+        CoplanarMerge::merge(*m_state, m_patches, m_out_face_labels, m_metrics, resource);
+    }
+    if (m_run_arena) {
+        m_state->run_arena.release();
+        m_metrics.values["run_arena_bytes"] =
+            static_cast<double>(m_state->run_arena.get_block_size());
+    }
+    m_metrics.values["num_output_vertices"] = static_cast<double>(resolved_vertices.rows());
+    m_metrics.values["num_output_faces"] = static_cast<double>(resolved_faces.rows());
+
+    if (m_output_sink != nullptr) {
+        // Streamed output: only the eager stages are computed, from the
+        // resolved mesh, which is then released.  The input is not needed
+        // anymore either.
+        m_vertices.resize(0, 3);
+        ensure_topology(m_eager_stages);
+        const size_t num_vertices = resolved_vertices.rows();
+        m_faces.swap(resolved_faces);
+        resolved_faces.resize(0, 3);
+        stream_output(num_vertices, [this](OutputSink& sink) {
+            Topology::stream_vertices(*m_state, m_exact_output, sink);
+        });
+    } else {
+        // Cast resolved mesh back to Float
+        Topology::to_float_vertices(*m_state, m_vertices);
+        m_faces = resolved_faces;
+        if (m_exact_output) {
+            ExactUtils::to_rational_strings(resolved_vertices, m_exact_vertices);
+        } else {
+            m_exact_vertices.clear();
+        }
+
+        // Remaining stages are computed on first access.
+        ensure_topology(m_eager_stages);
+    }
+
+    stage_timer.stop();
+    if (m_verbose) {
+        std::cout << "Arrangement: resolving self-intersection: " << m_metrics.timings["resolve"]
+                  << std::endl;
+        std::cout << "Arrangement: extracting arrangement: " << m_metrics.timings["extract"]
+                  << std::endl;
+    }
+}
+
+void FastArrangement::compute_topology(unsigned stages) const
+{
+    // Only partially arranged with a region of interest, cells are undefined.
+    const bool partial = !m_input_resolved && !m_region_of_interest.empty();
+    Topology::compute_stages(*m_state,
+        stages,
+        get_computed_stages(),
+        partial,
+        m_patches,
+        m_cells,
+        m_winding_number,
+        m_metrics);
+}
+
+EngineFactories arrangement::get_fast_engine_factories()
+{
+    EngineFactories factories;
+    factories["fast"] = [](MatrixFr vertices,
+                            const MatrixIr& faces,
+                            const VectorI& face_labels,
+                            const EngineOptions& options) -> Arrangement::Ptr {
+        auto engine = std::make_shared<FastArrangement>(std::move(vertices), faces, face_labels);
+        engine->set_region_of_interest(options.region_of_interest);
+        return engine;
+    };
+    return factories;
 }
 
+ARRANGEMENT_BUILTIN_PLUGIN(get_fast_engine_factories)
+
 #endif // ARRANGEMENT_FAST
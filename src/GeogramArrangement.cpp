@@ -1,15 +1,26 @@
 #ifdef ARRANGEMENT_GEOGRAM
 
+#include <arrangement/Exception.h>
 #include <arrangement/GeogramArrangement.h>
+#include <arrangement/Trace.h>
 
 #include <Eigen/Core>
 
 #include <geogram/basic/attributes.h>
+#include <geogram/basic/process.h>
 #include <geogram/mesh/mesh.h>
 #include <geogram/mesh/mesh_surface_intersection.h>
 
-#include <chrono>
 #include <iostream>
+#include <mutex>
+
+#include "BuiltinEngines.h"
+
+#ifdef ARRANGEMENT_IGL
+#include "CoplanarMerge.h"
+#include "ExactUtils.h"
+#include "Topology.h"
+#endif
 
 namespace arrangement {
 
@@ -42,10 +53,34 @@ void to_geogram_mesh(Eigen::PlainObjectBase<DerivedV>& V,
 
 void GeogramArrangement::run()
 {
-    // Needs to be called once.
-    GEO::initialize(GEO::GEOGRAM_INSTALL_ALL);
+    ARRANGEMENT_TRACE_SCOPE("GeogramArrangement::run");
+    if (m_exact_output || !m_exact_vertices.empty()) {
+        throw NotImplementedError("GeogramArrangement does not support exact coordinates");
+    }
+    if (m_input_resolved) {
+        throw NotImplementedError("GeogramArrangement does not support resolved input");
+    }
+    if (m_snap_rounding) {
+        throw NotImplementedError("GeogramArrangement does not support snap rounding");
+    }
+    if (m_quantization) {
+        throw NotImplementedError("GeogramArrangement does not support quantized input");
+    }
+#ifndef ARRANGEMENT_IGL
+    if (m_merge_coplanar) {
+        throw NotImplementedError("Merging coplanar faces requires ARRANGEMENT_IGL");
+    }
+#endif
+    if (!m_region_of_interest.empty()) {
+        throw NotImplementedError("GeogramArrangement does not support regions of interest");
+    }
+
+    // Needs to be called once, and is not thread-safe.
+    static std::once_flag geogram_initialized;
+    std::call_once(geogram_initialized, [] { GEO::initialize(GEO::GEOGRAM_INSTALL_ALL); });
 
-    auto t_begin = std::chrono::high_resolution_clock::now();
+    m_metrics.clear();
+    ScopedTimer stage_timer(m_metrics, "resolve");
 
     GEO::Mesh mesh;
     to_geogram_mesh(m_vertices, m_faces, m_in_face_labels, mesh);
@@ -53,9 +88,26 @@ void GeogramArrangement::run()
     engine.set_verbose(false);
     engine.set_delaunay(true);
     engine.set_radial_sort(true);
-    engine.intersect();
+    if (m_num_threads > 0) {
+        // Geogram's thread cap is process-wide: runs that set it are
+        // serialized, so that each one intersects under its own cap and
+        // restores the value it found.
+        static std::mutex thread_cap_mutex;
+        std::lock_guard<std::mutex> lock(thread_cap_mutex);
+        const GEO::index_t max_threads = GEO::Process::max_threads();
+        GEO::Process::set_max_threads(static_cast<GEO::index_t>(m_num_threads));
+        try {
+            engine.intersect();
+        } catch (...) {
+            GEO::Process::set_max_threads(max_threads);
+            throw;
+        }
+        GEO::Process::set_max_threads(max_threads);
+    } else {
+        engine.intersect();
+    }
     // engine.remove_external_shell();
-    auto t_mid = std::chrono::high_resolution_clock::now();
+    stage_timer.restart("extract");
 
     m_vertices.resize(mesh.vertices.nb(), 3);
     for (size_t i = 0; i < mesh.vertices.nb(); i++) {
@@ -89,16 +141,48 @@ void GeogramArrangement::run()
     for (size_t i = 0; i < num_patches; i++) {
         m_cells(i, 1) = i;
     }
-    auto t_end = std::chrono::high_resolution_clock::now();
+
+#ifdef ARRANGEMENT_IGL
+    if (m_merge_coplanar) {
+        // Output coordinates are doubles, merge them as exact numbers.
+        Topology::ResolvedMesh merged;
+        merged.vertices = m_vertices.cast<ExactUtils::ExactScalar>();
+        merged.faces = m_faces;
+        CoplanarMerge::merge(merged, m_patches, m_out_face_labels, m_metrics);
+        Topology::to_float_vertices(merged, m_vertices);
+        m_faces = std::move(merged.faces);
+    }
+#endif
+    stage_timer.stop();
+    m_metrics.values["num_output_vertices"] = static_cast<double>(m_vertices.rows());
+    m_metrics.values["num_output_faces"] = static_cast<double>(m_faces.rows());
+    if (m_output_sink != nullptr) {
+        stream_output(m_vertices.rows());
+    }
     if (m_verbose) {
-        std::chrono::duration<double> resolve_time = t_mid - t_begin;
-        std::chrono::duration<double> extract_time = t_end - t_mid;
-        std::cout << "Arrangement: resolving self-intersection: " << resolve_time.count()
+        std::cout << "Arrangement: resolving self-intersection: " << m_metrics.timings["resolve"]
+                  << std::endl;
+        std::cout << "Arrangement: extracting arrangement: " << m_metrics.timings["extract"]
                   << std::endl;
-        std::cout << "Arrangement: extracting arrangement: " << extract_time.count() << std::endl;
     }
 }
 
+EngineFactories get_geogram_engine_factories()
+{
+    EngineFactories factories;
+    factories["geogram"] = [](MatrixFr vertices,
+                               const MatrixIr& faces,
+                               const VectorI& face_labels,
+                               const EngineOptions& options) -> Arrangement::Ptr {
+        auto engine = std::make_shared<GeogramArrangement>(std::move(vertices), faces, face_labels);
+        engine->set_region_of_interest(options.region_of_interest);
+        return engine;
+    };
+    return factories;
+}
+
 } // namespace arrangement
 
+ARRANGEMENT_BUILTIN_PLUGIN(get_geogram_engine_factories)
+
 #endif // ARRANGEMENT_GEOGRAM
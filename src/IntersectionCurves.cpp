@@ -0,0 +1,200 @@
+#include <arrangement/AABBTree.h>
+#include <arrangement/Arrangement.h>
+#include <arrangement/Exception.h>
+
+#ifdef ARRANGEMENT_IGL
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+#include <CGAL/intersections.h>
+
+#include "ExactUtils.h"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace arrangement;
+
+#ifdef ARRANGEMENT_IGL
+
+namespace {
+
+typedef CGAL::Epeck Kernel;
+typedef Kernel::FT ExactScalar;
+
+/**
+ * Chain unique segments into polylines.  Open chains start and end at points
+ * of degree other than 2, the remaining segments form closed loops.
+ */
+std::vector<std::vector<Index>> chain_segments(
+    size_t num_vertices, const std::vector<std::pair<Index, Index>>& edges)
+{
+    std::vector<std::vector<std::pair<Index, size_t>>> adjacency(num_vertices);
+    for (size_t i = 0; i < edges.size(); i++) {
+        adjacency[edges[i].first].emplace_back(edges[i].second, i);
+        adjacency[edges[i].second].emplace_back(edges[i].first, i);
+    }
+
+    std::vector<bool> visited(edges.size(), false);
+    std::vector<std::vector<Index>> polylines;
+    auto walk = [&](Index start, size_t first_edge) {
+        std::vector<Index> polyline{start};
+        Index current = start;
+        size_t edge = first_edge;
+        while (true) {
+            visited[edge] = true;
+            const Index next =
+                edges[edge].first == current ? edges[edge].second : edges[edge].first;
+            polyline.push_back(next);
+            current = next;
+            if (current == start || adjacency[current].size() != 2) break;
+            const size_t e0 = adjacency[current][0].second;
+            const size_t e1 = adjacency[current][1].second;
+            edge = visited[e0] ? e1 : e0;
+            if (visited[edge]) break;
+        }
+        polylines.push_back(std::move(polyline));
+    };
+
+    for (size_t v = 0; v < num_vertices; v++) {
+        if (adjacency[v].size() == 2) continue;
+        for (const auto& [w, e] : adjacency[v]) {
+            if (!visited[e]) walk(static_cast<Index>(v), e);
+        }
+    }
+    for (size_t e = 0; e < edges.size(); e++) {
+        if (!visited[e]) walk(edges[e].first, e);
+    }
+    return polylines;
+}
+
+} // namespace
+
+IntersectionCurves Arrangement::compute_intersection_curves() const
+{
+    const Eigen::Index num_faces = m_faces.rows();
+    IntersectionCurves curves;
+
+    // Exact input coordinates take precedence over their rounded values.  After
+    // run(), the exact coordinates may be those of the output instead.
+    std::vector<Kernel::Point_3> corners;
+    corners.reserve(m_vertices.rows());
+    if (m_exact_vertices.size() == static_cast<size_t>(m_vertices.size())) {
+        const auto exact = ExactUtils::from_rational_strings(m_exact_vertices);
+        for (Eigen::Index v = 0; v < exact.rows(); v++) {
+            corners.emplace_back(exact(v, 0), exact(v, 1), exact(v, 2));
+        }
+    } else {
+        for (Eigen::Index v = 0; v < m_vertices.rows(); v++) {
+            corners.emplace_back(m_vertices(v, 0), m_vertices(v, 1), m_vertices(v, 2));
+        }
+    }
+    std::vector<Kernel::Triangle_3> triangles;
+    triangles.reserve(num_faces);
+    for (Eigen::Index i = 0; i < num_faces; i++) {
+        triangles.emplace_back(
+            corners[m_faces(i, 0)], corners[m_faces(i, 1)], corners[m_faces(i, 2)]);
+    }
+
+    std::map<std::array<ExactScalar, 3>, Index> point_map;
+    std::vector<Kernel::Point_3> points;
+    auto add_point = [&](const Kernel::Point_3& p) {
+        auto itr = point_map.emplace(
+            std::array<ExactScalar, 3>{p.x(), p.y(), p.z()}, static_cast<Index>(points.size()));
+        if (itr.second) points.push_back(p);
+        return itr.first->second;
+    };
+
+    std::vector<std::array<Index, 4>> segments;
+    std::vector<Index> hits;
+    const AABBTree tree(m_vertices, m_faces);
+    for (Eigen::Index i = 0; i < num_faces; i++) {
+        const Vector3F v0 = m_vertices.row(m_faces(i, 0)).transpose();
+        const Vector3F v1 = m_vertices.row(m_faces(i, 1)).transpose();
+        const Vector3F v2 = m_vertices.row(m_faces(i, 2)).transpose();
+        hits.clear();
+        tree.query_box(v0.cwiseMin(v1).cwiseMin(v2), v0.cwiseMax(v1).cwiseMax(v2), hits);
+
+        for (const Index j : hits) {
+            if (j <= i) continue;
+            if (triangles[i].is_degenerate() || triangles[j].is_degenerate()) continue;
+            int num_shared = 0;
+            for (int a = 0; a < 3; a++) {
+                for (int b = 0; b < 3; b++) {
+                    if (m_faces(i, a) == m_faces(j, b)) num_shared++;
+                }
+            }
+            const auto& ti = triangles[i];
+            const auto& tj = triangles[j];
+            const bool coplanar = CGAL::coplanar(ti[0], ti[1], ti[2], tj[0]) &&
+                                  CGAL::coplanar(ti[0], ti[1], ti[2], tj[1]) &&
+                                  CGAL::coplanar(ti[0], ti[1], ti[2], tj[2]);
+            // Faces sharing an edge meet along that edge, unless they are
+            // folded onto each other.  Faces sharing a vertex only are
+            // intersected like the others, their intersection starts at the
+            // shared vertex (the narrow phase of igl's SelfIntersectMesh).
+            if (num_shared >= 2 && !coplanar) continue;
+
+            auto r = CGAL::intersection(ti, tj);
+            if (!r) continue;
+            auto add_segment = [&](const Kernel::Point_3& p, const Kernel::Point_3& q) {
+                segments.push_back({add_point(p), add_point(q), static_cast<Index>(i), j});
+            };
+            if (!coplanar) {
+                // A segment, or a point contact.
+                if (const auto* s = std::get_if<Kernel::Segment_3>(&*r)) {
+                    add_segment(s->source(), s->target());
+                }
+                continue;
+            }
+
+            // Coplanar faces: report the boundary of their overlap.  Faces
+            // only touching along a segment or at a point do not overlap.
+            std::vector<Kernel::Point_3> polygon;
+            if (const auto* t = std::get_if<Kernel::Triangle_3>(&*r)) {
+                polygon = {t->vertex(0), t->vertex(1), t->vertex(2)};
+            } else if (const auto* p = std::get_if<std::vector<Kernel::Point_3>>(&*r)) {
+                polygon = *p;
+            }
+            if (polygon.size() < 3) continue;
+            curves.num_coplanar_pairs++;
+            for (size_t k = 0; k < polygon.size(); k++) {
+                add_segment(polygon[k], polygon[(k + 1) % polygon.size()]);
+            }
+        }
+    }
+
+    curves.vertices.resize(points.size(), 3);
+    for (size_t i = 0; i < points.size(); i++) {
+        curves.vertices.row(i) << CGAL::to_double(points[i].x()), CGAL::to_double(points[i].y()),
+            CGAL::to_double(points[i].z());
+    }
+    curves.segments.resize(segments.size(), 2);
+    curves.face_pairs.resize(segments.size(), 2);
+    std::set<std::pair<Index, Index>> unique_edges;
+    for (size_t i = 0; i < segments.size(); i++) {
+        const auto& [a, b, f0, f1] = segments[i];
+        curves.segments.row(i) << a, b;
+        curves.face_pairs.row(i) << f0, f1;
+        unique_edges.emplace(std::min(a, b), std::max(a, b));
+    }
+
+    // A curve running along a mesh edge is reported by several face pairs,
+    // chain each segment once.
+    curves.polylines = chain_segments(
+        points.size(),
+        std::vector<std::pair<Index, Index>>(unique_edges.begin(), unique_edges.end()));
+    return curves;
+}
+
+#else
+
+IntersectionCurves Arrangement::compute_intersection_curves() const
+{
+    throw NotImplementedError("Intersection curves require exact predicates (ARRANGEMENT_IGL)");
+}
+
+#endif // ARRANGEMENT_IGL
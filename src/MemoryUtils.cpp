@@ -0,0 +1,250 @@
+#include <arrangement/MemoryUtils.h>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <fstream>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef ARRANGEMENT_WITH_MEMORY_STATS
+
+namespace {
+
+std::atomic<size_t> g_num_allocations{0};
+std::atomic<size_t> g_num_allocated_bytes{0};
+
+void* counted_malloc(size_t size)
+{
+    g_num_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_num_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* counted_aligned_malloc(size_t size, size_t alignment)
+{
+    g_num_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_num_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+#if defined(_WIN32)
+    return _aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+    // aligned_alloc() requires a multiple of the alignment.
+    const size_t rounded = std::max(alignment, (size + alignment - 1) / alignment * alignment);
+    return std::aligned_alloc(alignment, rounded);
+#endif
+}
+
+void aligned_free(void* p)
+{
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+// Replacements of the global allocation functions counting allocations.  The
+// array and nothrow forms of the standard library forward to these.
+
+void* operator new(size_t size)
+{
+    void* p = counted_malloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    void* p = counted_aligned_malloc(size, static_cast<size_t>(alignment));
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+#endif // ARRANGEMENT_WITH_MEMORY_STATS
+
+namespace arrangement {
+namespace MemoryUtils {
+
+namespace {
+
+/// Highest peak RSS seen by the scopes nested in the innermost open scope,
+/// before they reset it.
+std::atomic<size_t> g_nested_peak_rss{0};
+
+} // namespace
+
+size_t get_peak_rss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    // Bytes on macOS.
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // Kilobytes on Linux.
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+size_t get_current_rss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.WorkingSetSize;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(),
+            MACH_TASK_BASIC_INFO,
+            reinterpret_cast<task_info_t>(&info),
+            &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return static_cast<size_t>(info.resident_size);
+#else
+    std::ifstream statm("/proc/self/statm");
+    size_t num_pages = 0, num_resident_pages = 0;
+    if (!(statm >> num_pages >> num_resident_pages)) return 0;
+    return num_resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+bool reset_peak_rss()
+{
+#if defined(__linux__)
+    // Writing 5 to clear_refs resets the peak RSS (Linux 4.0+).
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (!clear_refs) return false;
+    clear_refs << "5";
+    clear_refs.flush();
+    return static_cast<bool>(clear_refs);
+#else
+    return false;
+#endif
+}
+
+bool is_allocation_counting_enabled()
+{
+#ifdef ARRANGEMENT_WITH_MEMORY_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocationCounters get_allocation_counters()
+{
+    AllocationCounters counters;
+#ifdef ARRANGEMENT_WITH_MEMORY_STATS
+    counters.num_allocations = g_num_allocations.load(std::memory_order_relaxed);
+    counters.num_bytes = g_num_allocated_bytes.load(std::memory_order_relaxed);
+#endif
+    return counters;
+}
+
+MemoryScope::MemoryScope()
+{
+    // Save the peak reached so far for the enclosing scope before resetting it.
+    m_enclosing_peak = std::max(g_nested_peak_rss.exchange(0), get_peak_rss());
+    m_peak_reset = reset_peak_rss();
+    m_rss_begin = get_current_rss();
+    m_allocations_begin = get_allocation_counters();
+}
+
+StageMemory MemoryScope::finish()
+{
+    const AllocationCounters allocations = get_allocation_counters();
+    const size_t peak = std::max(get_peak_rss(), g_nested_peak_rss.load());
+    // Hand the peak over to the enclosing scope.
+    g_nested_peak_rss = std::max(m_enclosing_peak, peak);
+
+    StageMemory memory;
+    if (m_peak_reset) memory.peak_rss_delta = peak - std::min(peak, m_rss_begin);
+    memory.num_allocations = allocations.num_allocations - m_allocations_begin.num_allocations;
+    memory.allocated_bytes = allocations.num_bytes - m_allocations_begin.num_bytes;
+    return memory;
+}
+
+} // namespace MemoryUtils
+} // namespace arrangement
@@ -1,116 +1,538 @@
 #ifdef ARRANGEMENT_IGL
 
 /* This file is part of Arrangement. Copyright (c) 2016 by Qingnan Zhou */
+#include <arrangement/AABBTree.h>
+#include <arrangement/Exception.h>
 #include <arrangement/MatrixUtils.h>
 #include <arrangement/MeshArrangement.h>
+#include <arrangement/PlanarArrangement.h>
+#include <arrangement/Trace.h>
 
 #include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+#include <CGAL/Exact_rational.h>
+#include <CGAL/Simple_cartesian.h>
+#ifdef CGAL_USE_GMP
+#include <CGAL/Gmpq.h>
+#endif
+#ifdef CGAL_USE_BOOST_MP
+#include <CGAL/boost_mp.h>
+#endif
+#ifdef CGAL_USE_LEDA
+#include <CGAL/leda_rational.h>
+#endif
 
 #include <igl/copyleft/cgal/RemeshSelfIntersectionsParam.h>
 #include <igl/copyleft/cgal/SelfIntersectMesh.h>
-#include <igl/copyleft/cgal/extract_cells.h>
-#include <igl/copyleft/cgal/propagate_winding_numbers.h>
-#include <igl/extract_manifold_patches.h>
 #include <igl/remove_unreferenced.h>
-#include <igl/unique_edge_map.h>
 
-#include <chrono>
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <set>
+
+#include "BuiltinEngines.h"
+#include "CoplanarMerge.h"
+#include "ExactUtils.h"
+#include "RegionResolver.h"
+#include "RunArena.h"
+#include "SnapRounding.h"
+#include "Topology.h"
 
 using namespace arrangement;
 
-void MeshArrangement::run()
-{
-    typedef CGAL::Epeck Kernel;
-    typedef Kernel::FT ExactScalar;
-    typedef Eigen::Matrix<ExactScalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixEr;
+namespace {
 
-    auto t_begin = std::chrono::high_resolution_clock::now();
+typedef CGAL::Epeck Kernel;
+typedef Kernel::FT ExactScalar;
+typedef Eigen::Matrix<ExactScalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> MatrixEr;
 
-    // Resolve self intersection
+/**
+ * Resolve self-intersections with the given kernel and convert the resolved
+ * vertices to ExactScalar.
+ */
+template <typename ResolveKernel, typename DerivedV>
+void resolve_self_intersections(const DerivedV& in_vertices,
+    const MatrixIr& in_faces,
+    const VectorI& in_face_labels,
+    MatrixEr& resolved_vertices,
+    MatrixIr& resolved_faces,
+    VectorI& out_face_labels)
+{
+    typedef typename ResolveKernel::FT ResolveScalar;
+    typedef Eigen::Matrix<ResolveScalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        MatrixKr;
     igl::copyleft::cgal::RemeshSelfIntersectionsParam params;
 
-    MatrixEr resolved_vertices;
-    MatrixIr resolved_faces;
+    MatrixKr V;
+    MatrixIr F;
+    MatrixIr intersecting_faces;
+    VectorI source_vertices;
+    VectorI source_faces;
+    igl::copyleft::cgal::SelfIntersectMesh<ResolveKernel,
+        DerivedV,
+        MatrixIr,
+        MatrixKr,
+        MatrixIr,
+        MatrixIr,
+        VectorI,
+        VectorI>
+        resolver(in_vertices,
+            in_faces,
+            params,
+            V,
+            F,
+            intersecting_faces,
+            source_faces,
+            source_vertices);
+
+    // Merge coinciding vertices into non-manifold vertices.
+    std::for_each(F.data(),
+        F.data() + F.size(),
+        [&source_vertices](typename MatrixIr::Scalar& a) { a = source_vertices[a]; });
+
+    // Remove unreferenced vertices.
+    Eigen::VectorXi UIM;
+    if constexpr (std::is_same_v<ResolveScalar, ExactScalar>) {
+        igl::remove_unreferenced(V, F, resolved_vertices, resolved_faces, UIM);
+    } else {
+        MatrixKr RV;
+        igl::remove_unreferenced(V, F, RV, resolved_faces, UIM);
+        resolved_vertices.resize(RV.rows(), RV.cols());
+        std::transform(RV.data(),
+            RV.data() + RV.size(),
+            resolved_vertices.data(),
+            [](const ResolveScalar& value) { return ExactUtils::to_exact_scalar(value); });
+    }
+
+    // Map face labels
+    out_face_labels.resize(resolved_faces.rows());
+    for (Eigen::Index i = 0; i < resolved_faces.rows(); i++) {
+        out_face_labels[i] = in_face_labels[source_faces[i]];
+    }
+}
+
+typedef void (*ResolveFunction)(const MatrixFr&,
+    const MatrixIr&,
+    const VectorI&,
+    MatrixEr&,
+    MatrixIr&,
+    VectorI&);
+
+/**
+ * Instantiation of the resolve stage for a kernel, nullptr if the kernel is
+ * not available.
+ */
+ResolveFunction get_resolver(MeshKernel kernel)
+{
+    switch (kernel) {
+    case MeshKernel::Epeck: return &resolve_self_intersections<Kernel, MatrixFr>;
+    case MeshKernel::Rational:
+        return &resolve_self_intersections<CGAL::Simple_cartesian<CGAL::Exact_rational>,
+            MatrixFr>;
+#ifdef CGAL_USE_GMP
+    case MeshKernel::Gmpq:
+        return &resolve_self_intersections<CGAL::Simple_cartesian<CGAL::Gmpq>, MatrixFr>;
+#endif
+#ifdef CGAL_USE_BOOST_MP
+    case MeshKernel::BoostRational:
+        return &resolve_self_intersections<
+            CGAL::Simple_cartesian<boost::multiprecision::cpp_rational>,
+            MatrixFr>;
+#endif
+#ifdef CGAL_USE_LEDA
+    case MeshKernel::Leda:
+        return &resolve_self_intersections<CGAL::Simple_cartesian<leda_rational>, MatrixFr>;
+#endif
+    default: return nullptr;
+    }
+}
+
+} // namespace
+
+struct MeshArrangement::State : public Topology::ResolvedMesh
+{
+    bool valid = false;
+    RunArena run_arena;
+
+    std::pmr::memory_resource* get_resource(bool use_run_arena)
     {
-        MatrixEr V;
-        MatrixIr F;
-        MatrixIr intersecting_faces;
-        VectorI source_vertices;
-        VectorI source_faces;
+        return use_run_arena ? run_arena.get() : std::pmr::get_default_resource();
+    }
+};
+
+MeshArrangement::MeshArrangement(
+    MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+    : Base(std::move(vertices), faces, face_labels)
+    , m_state(std::make_unique<State>())
+{}
+
+MeshArrangement::~MeshArrangement() = default;
+
+void MeshArrangement::reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+{
+    Base::reset(std::move(vertices), faces, face_labels);
+    m_state->valid = false;
+    m_state->clear_edge_map();
+    m_state->vertices.resize(0, 3);
+    m_state->faces.resize(0, 3);
+}
+
+bool MeshArrangement::is_kernel_available(MeshKernel kernel)
+{
+    return get_resolver(kernel) != nullptr;
+}
+
+void MeshArrangement::set_kernel(MeshKernel kernel)
+{
+    if (!is_kernel_available(kernel)) {
+        throw NotImplementedError(
+            std::string("Mesh kernel is not available: ") + get_mesh_kernel_name(kernel));
+    }
+    m_kernel = kernel;
+}
+
+void MeshArrangement::run()
+{
+    ARRANGEMENT_TRACE_SCOPE("MeshArrangement::run");
+    if (m_quantization && !m_input_resolved) {
+        throw NotImplementedError("MeshArrangement does not support quantized input");
+    }
+    m_metrics.clear();
+    m_state->valid = false;
+    ScopedTimer stage_timer(m_metrics, "resolve");
+
+    MatrixEr& resolved_vertices = m_state->vertices;
+    MatrixIr& resolved_faces = m_state->faces;
+    const ResolveFunction resolver = get_resolver(m_kernel);
+    m_metrics.notes["kernel"] = get_mesh_kernel_name(m_kernel);
+    if (m_input_resolved) {
+        // Input is already arranged, keep it as is.
+        if (!m_exact_vertices.empty()) {
+            resolved_vertices = ExactUtils::from_rational_strings(m_exact_vertices);
+        } else {
+            resolved_vertices = m_vertices.cast<ExactScalar>();
+        }
+        resolved_faces = m_faces;
+        m_out_face_labels = m_in_face_labels;
+    } else if (!m_region_of_interest.empty()) {
+        if (m_snap_rounding) {
+            throw NotImplementedError("Region of interest is not supported with snap rounding");
+        }
+        if (!m_exact_vertices.empty()) {
+            throw NotImplementedError(
+                "Region of interest is not supported with exact input coordinates");
+        }
+        // Resolve self intersection within the region only
+        const size_t num_region_faces = RegionResolver::resolve(m_vertices,
+            m_faces,
+            m_in_face_labels,
+            m_region_of_interest,
+            resolver,
+            resolved_vertices,
+            resolved_faces,
+            m_out_face_labels,
+            m_state->get_resource(m_run_arena));
+        m_metrics.values["num_region_faces"] = static_cast<double>(num_region_faces);
+    } else if (!m_exact_vertices.empty()) {
+        if (m_kernel != MeshKernel::Epeck) {
+            throw NotImplementedError("Exact input coordinates require the Epeck kernel");
+        }
+        // Resolve self intersection
+        const MatrixEr exact_vertices = ExactUtils::from_rational_strings(m_exact_vertices);
+        resolve_self_intersections<Kernel>(exact_vertices,
+            m_faces,
+            m_in_face_labels,
+            resolved_vertices,
+            resolved_faces,
+            m_out_face_labels);
+    } else {
+        // Resolve self intersection
+        resolver(m_vertices,
+            m_faces,
+            m_in_face_labels,
+            resolved_vertices,
+            resolved_faces,
+            m_out_face_labels);
+    }
+    if (m_snap_rounding) {
+        SnapRounding::snap_round(
+            resolved_vertices, resolved_faces, m_out_face_labels, m_snap_grid_size);
+    }
+    stage_timer.restart("extract");
+
+    extract_arrangement();
+
+    stage_timer.stop();
+    if (m_verbose) {
+        std::cout << "Arrangement: resolving self-intersection: " << m_metrics.timings["resolve"]
+                  << std::endl;
+        std::cout << "Arrangement: extracting arrangement: " << m_metrics.timings["extract"]
+                  << std::endl;
+    }
+}
+
+void MeshArrangement::update(const VectorI& changed_labels,
+    const MatrixFr& vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels)
+{
+    ARRANGEMENT_TRACE_SCOPE("MeshArrangement::update");
+    if (m_snap_rounding) {
+        throw NotImplementedError("Incremental update does not support snap rounding");
+    }
+    if (!m_state->valid) {
+        throw RuntimeError("MeshArrangement::update() must be called after run()");
+    }
+    if (faces.rows() != face_labels.size()) {
+        throw RuntimeError("Face labels must have #faces entries");
+    }
+    const std::set<int> changed(
+        changed_labels.data(), changed_labels.data() + changed_labels.size());
+    for (Eigen::Index i = 0; i < face_labels.size(); i++) {
+        if (changed.count(face_labels[i]) == 0) {
+            throw RuntimeError("Face label " + std::to_string(face_labels[i]) +
+                               " is not listed as changed");
+        }
+    }
+
+    m_metrics.clear();
+    ScopedTimer stage_timer(m_metrics, "resolve");
+
+    const MatrixEr& prev_vertices = m_state->vertices;
+    const MatrixIr& prev_faces = m_state->faces;
+    const Eigen::Index num_prev_vertices = prev_vertices.rows();
+
+    // Previous output faces of unchanged labels either pass through or get
+    // re-resolved with the new faces if their boxes overlap.
+    const AABBTree tree(vertices, faces);
+    std::vector<Index> hits;
+    std::vector<Eigen::Index> kept_faces;
+    std::vector<Eigen::Index> local_faces;
+    for (Eigen::Index i = 0; i < prev_faces.rows(); i++) {
+        if (changed.count(m_out_face_labels[i]) > 0) continue;
+        const Vector3F v0 = m_vertices.row(prev_faces(i, 0)).transpose();
+        const Vector3F v1 = m_vertices.row(prev_faces(i, 1)).transpose();
+        const Vector3F v2 = m_vertices.row(prev_faces(i, 2)).transpose();
+        // Pad the box to account for the rounding of the exact coordinates.
+        const Float pad = 4 * std::numeric_limits<Float>::epsilon() *
+                          std::max({v0.cwiseAbs().maxCoeff(),
+                              v1.cwiseAbs().maxCoeff(),
+                              v2.cwiseAbs().maxCoeff(),
+                              Float(1)});
+        const Vector3F box_min = v0.cwiseMin(v1).cwiseMin(v2).array() - pad;
+        const Vector3F box_max = v0.cwiseMax(v1).cwiseMax(v2).array() + pad;
+        hits.clear();
+        tree.query_box(box_min, box_max, hits);
+        if (hits.empty()) {
+            kept_faces.push_back(i);
+        } else {
+            local_faces.push_back(i);
+        }
+    }
+
+    // Only the vertices of the faces to resolve are passed to the resolver,
+    // so that its cost follows the size of the change.  Indices below
+    // num_prev_vertices refer to the previous output, the others to the new
+    // vertices, appended after it.
+    const Eigen::Index num_local_faces = static_cast<Eigen::Index>(local_faces.size());
+    const Eigen::Index num_in_faces = num_local_faces + faces.rows();
+    std::vector<Index> local_vertex_map(num_prev_vertices + vertices.rows(), -1);
+    std::vector<Index> local_vertices;
+    MatrixIr in_faces(num_in_faces, 3);
+    VectorI in_face_labels(num_in_faces);
+    for (Eigen::Index i = 0; i < num_in_faces; i++) {
+        const bool is_new = i >= num_local_faces;
+        for (Eigen::Index k = 0; k < 3; k++) {
+            const Index v =
+                is_new ? static_cast<Index>(faces(i - num_local_faces, k) + num_prev_vertices)
+                       : prev_faces(local_faces[i], k);
+            if (local_vertex_map[v] < 0) {
+                local_vertex_map[v] = static_cast<Index>(local_vertices.size());
+                local_vertices.push_back(v);
+            }
+            in_faces(i, k) = local_vertex_map[v];
+        }
+        in_face_labels[i] =
+            is_new ? face_labels[i - num_local_faces] : m_out_face_labels[local_faces[i]];
+    }
+    const Eigen::Index num_local_vertices = static_cast<Eigen::Index>(local_vertices.size());
+    MatrixEr in_vertices(num_local_vertices, 3);
+    for (Eigen::Index i = 0; i < num_local_vertices; i++) {
+        const Index v = local_vertices[i];
+        if (v < num_prev_vertices) {
+            in_vertices.row(i) = prev_vertices.row(v);
+        } else {
+            in_vertices.row(i) = vertices.row(v - num_prev_vertices).cast<ExactScalar>();
+        }
+    }
+
+    // The resolver keeps its input vertices in front of the newly created ones.
+    igl::copyleft::cgal::RemeshSelfIntersectionsParam params;
+    MatrixEr V;
+    MatrixIr F;
+    MatrixIr intersecting_faces;
+    VectorI source_vertices;
+    VectorI source_faces;
+    if (in_faces.rows() > 0) {
         igl::copyleft::cgal::SelfIntersectMesh<Kernel,
-            MatrixFr,
+            MatrixEr,
             MatrixIr,
             MatrixEr,
             MatrixIr,
             MatrixIr,
             VectorI,
             VectorI>
-            resolver(m_vertices,
-                m_faces,
+            resolver(in_vertices,
+                in_faces,
                 params,
                 V,
                 F,
                 intersecting_faces,
                 source_faces,
                 source_vertices);
+    } else {
+        // Only removals, nothing to resolve.
+        V.resize(0, 3);
+        F.resize(0, 3);
+    }
 
-        // Merge coinciding vertices into non-manifold vertices.
-        std::for_each(F.data(),
-            F.data() + F.size(),
-            [&source_vertices](typename MatrixIr::Scalar& a) { a = source_vertices[a]; });
-
-        // Remove unreferenced vertices.
-        Eigen::VectorXi UIM;
-        igl::remove_unreferenced(V, F, resolved_vertices, resolved_faces, UIM);
+    // Previous vertices, then new input vertices, then the vertices created
+    // by the resolver.
+    const Eigen::Index num_created_vertices = V.rows() - num_local_vertices;
+    const Index first_created = static_cast<Index>(num_prev_vertices + vertices.rows());
+    MatrixEr all_vertices(first_created + num_created_vertices, 3);
+    all_vertices.topRows(num_prev_vertices) = prev_vertices;
+    all_vertices.middleRows(num_prev_vertices, vertices.rows()) = vertices.cast<ExactScalar>();
+    all_vertices.bottomRows(num_created_vertices) = V.bottomRows(num_created_vertices);
+    auto to_global = [&](Index v) -> Index {
+        v = source_vertices[v];
+        if (v < num_local_vertices) return local_vertices[v];
+        return first_created + v - static_cast<Index>(num_local_vertices);
+    };
 
-        // Map face labels
-        m_out_face_labels.resize(resolved_faces.rows());
-        for (Eigen::Index i = 0; i < resolved_faces.rows(); i++) {
-            m_out_face_labels[i] = m_in_face_labels[source_faces[i]];
+    const Eigen::Index num_kept_faces = static_cast<Eigen::Index>(kept_faces.size());
+    MatrixIr merged_faces(num_kept_faces + F.rows(), 3);
+    VectorI merged_labels(merged_faces.rows());
+    for (Eigen::Index i = 0; i < num_kept_faces; i++) {
+        merged_faces.row(i) = prev_faces.row(kept_faces[i]);
+        merged_labels[i] = m_out_face_labels[kept_faces[i]];
+    }
+    for (Eigen::Index i = 0; i < F.rows(); i++) {
+        for (Eigen::Index k = 0; k < 3; k++) {
+            merged_faces(num_kept_faces + i, k) = to_global(F(i, k));
         }
+        merged_labels[num_kept_faces + i] = in_face_labels[source_faces[i]];
     }
-    auto t_mid = std::chrono::high_resolution_clock::now();
 
-    // Build edge map
-    Eigen::MatrixXi E, uE, uEC, uEE;
-    Eigen::VectorXi EMAP;
-    std::vector<std::vector<size_t>> uE2E;
-    igl::unique_edge_map(resolved_faces, E, uE, EMAP, uEC, uEE);
+    m_state->valid = false;
+    Eigen::VectorXi UIM;
+    igl::remove_unreferenced(all_vertices, merged_faces, m_state->vertices, m_state->faces, UIM);
+    m_out_face_labels = merged_labels;
+    stage_timer.restart("extract");
 
-    // patches
-    const size_t num_patches =
-        igl::extract_manifold_patches(resolved_faces, EMAP, uEC, uEE, m_patches);
+    extract_arrangement();
 
-    // cells
-    const size_t num_cells = igl::copyleft::cgal::extract_cells(
-        resolved_vertices, resolved_faces, m_patches, uE, EMAP, uEC, uEE, m_cells);
-    assert(m_cells.rows() == num_patches);
-    assert(m_cells.cols() == 2);
+    stage_timer.stop();
+    m_metrics.values["update.num_kept_faces"] = static_cast<double>(num_kept_faces);
+    m_metrics.values["update.num_resolved_faces"] = static_cast<double>(in_faces.rows());
+    m_metrics.values["update.num_resolved_vertices"] = static_cast<double>(num_local_vertices);
+    if (m_verbose) {
+        std::cout << "Arrangement: re-resolved " << in_faces.rows() << " faces, kept "
+                  << num_kept_faces << std::endl;
+        std::cout << "Arrangement: resolving self-intersection: " << m_metrics.timings["resolve"]
+                  << std::endl;
+        std::cout << "Arrangement: extracting arrangement: " << m_metrics.timings["extract"]
+                  << std::endl;
+    }
+}
+
+void MeshArrangement::extract_arrangement()
+{
+    const MatrixEr& resolved_vertices = m_state->vertices;
+    m_state->clear_edge_map();
+    reset_topology();
+    if (m_merge_coplanar) {
+        // Patches delimit the regions to merge.
+        ensure_topology(TOPOLOGY_PATCHES);
+        CoplanarMerge::merge(*m_state,
+            m_patches,
+            m_out_face_labels,
+            m_metrics,
+            m_state->get_resource(m_run_arena));
+    }
+    if (m_run_arena) {
+        m_state->run_arena.release();
+        m_metrics.values["run_arena_bytes"] =
+            static_cast<double>(m_state->run_arena.get_block_size());
+    }
+    m_metrics.values["num_output_vertices"] = static_cast<double>(resolved_vertices.rows());
+    m_metrics.values["num_output_faces"] = static_cast<double>(m_state->faces.rows());
 
-    VectorI labels = VectorI::Zero(resolved_faces.rows());
-    //// winding numbers
-    igl::copyleft::cgal::propagate_winding_numbers(
-           resolved_vertices, resolved_faces,
-           uE, uEC, uEE, num_patches, m_patches, num_cells, m_cells,
-           labels, m_winding_number);
+    if (m_output_sink != nullptr) {
+        // Streamed output: only the eager stages are computed, from the
+        // resolved mesh, which is then released.  The input is not needed
+        // anymore either.
+        m_vertices.resize(0, 3);
+        m_state->valid = false;
+        ensure_topology(m_eager_stages);
+        const size_t num_vertices = resolved_vertices.rows();
+        m_faces.swap(m_state->faces);
+        m_state->faces.resize(0, 3);
+        stream_output(num_vertices, [this](OutputSink& sink) {
+            Topology::stream_vertices(*m_state, m_exact_output, sink);
+        });
+        return;
+    }
 
     // Cast resolved mesh back to Float
-    m_vertices = MatrixFr(resolved_vertices.rows(), resolved_vertices.cols());
-    std::transform(resolved_vertices.data(),
-        resolved_vertices.data() + resolved_vertices.size(),
-        m_vertices.data(),
-        [](const ExactScalar& val) { return CGAL::to_double(val); });
-    m_faces = resolved_faces;
-
-    auto t_end = std::chrono::high_resolution_clock::now();
-    if (m_verbose) {
-        std::chrono::duration<double> resolve_time = t_mid - t_begin;
-        std::chrono::duration<double> extract_time = t_end - t_mid;
-        std::cout << "Arrangement: resolving self-intersection: " << resolve_time.count() <<
-        std::endl; std::cout << "Arrangement: extracting arrangement: " << extract_time.count() <<
-        std::endl;
+    Topology::to_float_vertices(*m_state, m_vertices);
+    m_faces = m_state->faces;
+    if (m_exact_output) {
+        ExactUtils::to_rational_strings(resolved_vertices, m_exact_vertices);
+    } else {
+        m_exact_vertices.clear();
     }
+    m_state->valid = true;
+
+    // Remaining stages are computed on first access.
+    ensure_topology(m_eager_stages);
 }
 
-#endif
+void MeshArrangement::compute_topology(unsigned stages) const
+{
+    // Only partially arranged with a region of interest, cells are undefined.
+    const bool partial = !m_input_resolved && !m_region_of_interest.empty();
+    Topology::compute_stages(*m_state,
+        stages,
+        get_computed_stages(),
+        partial,
+        m_patches,
+        m_cells,
+        m_winding_number,
+        m_metrics);
+}
+
+EngineFactories arrangement::get_mesh_engine_factories()
+{
+    EngineFactories factories;
+    factories["mesh"] = [](MatrixFr vertices,
+                            const MatrixIr& faces,
+                            const VectorI& face_labels,
+                            const EngineOptions& options) -> Arrangement::Ptr {
+        auto engine = std::make_shared<MeshArrangement>(std::move(vertices), faces, face_labels);
+        engine->set_region_of_interest(options.region_of_interest);
+        engine->set_kernel(options.kernel);
+        return engine;
+    };
+    factories["planar"] = [](MatrixFr vertices,
+                              const MatrixIr& faces,
+                              const VectorI& face_labels,
+                              const EngineOptions&) -> Arrangement::Ptr {
+        return std::make_shared<PlanarArrangement>(std::move(vertices), faces, face_labels);
+    };
+    return factories;
+}
+
+ARRANGEMENT_BUILTIN_PLUGIN(get_mesh_engine_factories)
+
+#endif // ARRANGEMENT_IGL
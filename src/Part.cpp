@@ -0,0 +1,59 @@
+#include <arrangement/Exception.h>
+#include <arrangement/Part.h>
+
+#include <string>
+
+namespace arrangement {
+
+void assemble_parts(
+    const std::vector<Part>& parts, MatrixFr& vertices, MatrixIr& faces, VectorI& face_labels)
+{
+    Index num_vertices = 0;
+    Index num_faces = 0;
+    for (size_t i = 0; i < parts.size(); i++) {
+        const Part& part = parts[i];
+        if (part.vertices == nullptr || part.faces == nullptr) {
+            throw RuntimeError("Part " + std::to_string(i) + " has no vertices or faces");
+        }
+        if (part.face_labels != nullptr && part.face_labels->size() != part.faces->rows()) {
+            throw RuntimeError("Face labels of part " + std::to_string(i) +
+                               " must have #faces entries");
+        }
+        num_vertices += part.vertices->rows();
+        num_faces += part.faces->rows();
+    }
+
+    vertices.resize(num_vertices, 3);
+    faces.resize(num_faces, 3);
+    face_labels.resize(num_faces);
+    Index vertex_offset = 0;
+    Index face_offset = 0;
+    for (size_t i = 0; i < parts.size(); i++) {
+        const Part& part = parts[i];
+        const MatrixFr& part_vertices = *part.vertices;
+        const MatrixIr& part_faces = *part.faces;
+        const Index n = part_vertices.rows();
+        const Index m = part_faces.rows();
+
+        vertices.middleRows(vertex_offset, n).noalias() =
+            (part_vertices * part.transform.linear().transpose()).rowwise() +
+            part.transform.translation().transpose();
+
+        if (part.transform.linear().determinant() < 0) {
+            faces.middleRows(face_offset, m) = part_faces.rowwise().reverse().array() + vertex_offset;
+        } else {
+            faces.middleRows(face_offset, m) = part_faces.array() + vertex_offset;
+        }
+
+        if (part.face_labels != nullptr) {
+            face_labels.segment(face_offset, m) = *part.face_labels;
+        } else {
+            face_labels.segment(face_offset, m)
+                .setConstant(part.label >= 0 ? part.label : static_cast<int>(i));
+        }
+        vertex_offset += n;
+        face_offset += m;
+    }
+}
+
+} // namespace arrangement
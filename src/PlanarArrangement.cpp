@@ -0,0 +1,442 @@
+#ifdef ARRANGEMENT_IGL
+
+#include <arrangement/Exception.h>
+#include <arrangement/PlanarArrangement.h>
+#include <arrangement/Trace.h>
+
+#include <CGAL/Constrained_Delaunay_triangulation_2.h>
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+#include <CGAL/Triangulation_vertex_base_with_info_2.h>
+#include <CGAL/box_intersection_d.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CoplanarMerge.h"
+#include "ExactUtils.h"
+#include "RunArena.h"
+#include "SnapRounding.h"
+#include "Topology.h"
+
+using namespace arrangement;
+
+namespace {
+
+typedef CGAL::Epeck Kernel;
+typedef Kernel::FT ExactScalar;
+typedef Kernel::Point_2 Point2;
+typedef Kernel::Vector_3 Vector3;
+typedef ExactUtils::MatrixEr MatrixEr;
+
+typedef CGAL::Triangulation_vertex_base_with_info_2<Index, Kernel> VertexBase;
+typedef CGAL::Constrained_triangulation_face_base_2<Kernel> FaceBase;
+typedef CGAL::Triangulation_data_structure_2<VertexBase, FaceBase> Tds;
+typedef CGAL::Constrained_Delaunay_triangulation_2<Kernel, Tds, CGAL::Exact_intersections_tag>
+    CDT;
+typedef CGAL::Box_intersection_d::Box_with_info_d<double, 2, size_t> Box;
+
+/// Faces grouped by the parallel plane they lie in.
+struct PlaneGroups
+{
+    Vector3 normal; ///< Common normal, not normalized.
+    std::vector<ExactScalar> offsets; ///< normal.dot(p) of the points of each plane.
+    VectorI face_planes; ///< Plane index of each face.
+};
+
+Vector3 get_point_vector(const MatrixEr& vertices, Index i)
+{
+    return Vector3(vertices(i, 0), vertices(i, 1), vertices(i, 2));
+}
+
+/**
+ * Cheap inexact rejection of clearly non-planar input: the vertices of some
+ * face are far from the plane of the largest face, or from a common plane.
+ */
+bool may_be_planar(const MatrixFr& vertices, const MatrixIr& faces)
+{
+    const Index num_faces = faces.rows();
+    Vector3F normal = Vector3F::Zero();
+    for (Index i = 0; i < num_faces; i++) {
+        const Vector3F v0 = vertices.row(faces(i, 0)).transpose();
+        const Vector3F n = (vertices.row(faces(i, 1)).transpose() - v0)
+                               .cross(vertices.row(faces(i, 2)).transpose() - v0);
+        if (n.squaredNorm() > normal.squaredNorm()) normal = n;
+    }
+    if (normal.squaredNorm() == 0) return false;
+    normal.normalize();
+
+    const Float scale = (vertices.colwise().maxCoeff() - vertices.colwise().minCoeff()).norm();
+    const Float tol = 1e-8 * std::max(scale, Float(1));
+    for (Index i = 0; i < num_faces; i++) {
+        const Float d0 = normal.dot(vertices.row(faces(i, 0)).transpose());
+        for (Index k = 1; k < 3; k++) {
+            if (std::abs(normal.dot(vertices.row(faces(i, k)).transpose()) - d0) > tol) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Group the faces by plane, exactly.  Returns nothing if the faces are not in
+ * at most `max_num_planes` parallel planes.
+ */
+std::optional<PlaneGroups> group_faces_by_plane(
+    const MatrixEr& vertices, const MatrixIr& faces, size_t max_num_planes)
+{
+    const Index num_faces = faces.rows();
+    PlaneGroups groups;
+
+    // The normal of any non-degenerate face is the common normal.
+    bool found = false;
+    for (Index i = 0; i < num_faces && !found; i++) {
+        const Vector3 v0 = get_point_vector(vertices, faces(i, 0));
+        groups.normal = CGAL::cross_product(
+            get_point_vector(vertices, faces(i, 1)) - v0, get_point_vector(vertices, faces(i, 2)) - v0);
+        found = groups.normal != CGAL::NULL_VECTOR;
+    }
+    if (!found) return std::nullopt;
+
+    // A face lies in a plane of this normal iff its vertices have the same
+    // offset along it.
+    std::vector<std::optional<ExactScalar>> vertex_offsets(vertices.rows());
+    auto get_offset = [&](Index v) -> const ExactScalar& {
+        if (!vertex_offsets[v]) {
+            vertex_offsets[v] = groups.normal * get_point_vector(vertices, v);
+        }
+        return *vertex_offsets[v];
+    };
+
+    std::map<ExactScalar, int> plane_indices;
+    groups.face_planes.resize(num_faces);
+    for (Index i = 0; i < num_faces; i++) {
+        const ExactScalar& offset = get_offset(faces(i, 0));
+        if (get_offset(faces(i, 1)) != offset || get_offset(faces(i, 2)) != offset) {
+            return std::nullopt;
+        }
+        auto [itr, inserted] =
+            plane_indices.try_emplace(offset, static_cast<int>(plane_indices.size()));
+        if (inserted) {
+            if (plane_indices.size() > max_num_planes) return std::nullopt;
+            groups.offsets.push_back(offset);
+        }
+        groups.face_planes[i] = itr->second;
+    }
+    return groups;
+}
+
+/**
+ * Arrange the faces of one plane in 2D and append the result to the resolved
+ * mesh.
+ *
+ * @param axis Coordinate dropped by the projection, along which the normal is
+ * non-zero.
+ */
+void resolve_plane(const MatrixEr& in_vertices,
+    const MatrixIr& in_faces,
+    const VectorI& in_face_labels,
+    const std::vector<Index>& plane_faces,
+    const Vector3& normal,
+    const ExactScalar& offset,
+    int axis,
+    std::vector<ExactScalar>& out_coords,
+    std::vector<Index>& out_faces,
+    std::vector<int>& out_labels)
+{
+    const int axis_u = (axis + 1) % 3;
+    const int axis_v = (axis + 2) % 3;
+    auto project = [&](Index v) { return Point2(in_vertices(v, axis_u), in_vertices(v, axis_v)); };
+
+    // Insert the edges of the non-degenerate faces as constraints.  With
+    // (u, v) cyclic after the dropped axis, the 2D orientation of a face is the
+    // sign of its normal along that axis.
+    CDT cdt;
+    std::map<Index, CDT::Vertex_handle> vertex_handles;
+    std::vector<std::pair<Index, bool>> faces_2d; // Input face, counterclockwise
+    std::vector<Box> face_boxes;
+    for (const Index f : plane_faces) {
+        const std::array<Point2, 3> corners = {
+            project(in_faces(f, 0)), project(in_faces(f, 1)), project(in_faces(f, 2))};
+        const CGAL::Orientation orientation = CGAL::orientation(corners[0], corners[1], corners[2]);
+        if (orientation == CGAL::COLLINEAR) continue;
+        std::array<CDT::Vertex_handle, 3> handles;
+        for (int k = 0; k < 3; k++) {
+            const Index v = in_faces(f, k);
+            auto itr = vertex_handles.find(v);
+            if (itr == vertex_handles.end()) {
+                itr = vertex_handles.emplace(v, cdt.insert(corners[k])).first;
+            }
+            handles[k] = itr->second;
+        }
+        for (int k = 0; k < 3; k++) {
+            if (handles[k] != handles[(k + 1) % 3]) {
+                cdt.insert_constraint(handles[k], handles[(k + 1) % 3]);
+            }
+        }
+        face_boxes.emplace_back(
+            corners[0].bbox() + corners[1].bbox() + corners[2].bbox(), faces_2d.size());
+        faces_2d.emplace_back(f, orientation == CGAL::COUNTERCLOCKWISE);
+    }
+    if (faces_2d.empty()) return;
+
+    // Triangles of the triangulation never cross a constraint, so each one is
+    // either inside or outside of each input face.  Test their centroids
+    // against the faces with overlapping boxes.
+    std::vector<CDT::Face_handle> triangles;
+    std::vector<Box> triangle_boxes;
+    for (auto fh : cdt.finite_face_handles()) {
+        triangle_boxes.emplace_back(fh->vertex(0)->point().bbox() +
+                                        fh->vertex(1)->point().bbox() +
+                                        fh->vertex(2)->point().bbox(),
+            triangles.size());
+        triangles.push_back(fh);
+    }
+    std::vector<std::pair<size_t, size_t>> covers; // (input face, triangle)
+    CGAL::box_intersection_d(face_boxes.begin(),
+        face_boxes.end(),
+        triangle_boxes.begin(),
+        triangle_boxes.end(),
+        [&](const Box& face_box, const Box& triangle_box) {
+            const Index f = faces_2d[face_box.info()].first;
+            const auto fh = triangles[triangle_box.info()];
+            const Point2 centroid = CGAL::centroid(
+                fh->vertex(0)->point(), fh->vertex(1)->point(), fh->vertex(2)->point());
+            const Kernel::Triangle_2 triangle(
+                project(in_faces(f, 0)), project(in_faces(f, 1)), project(in_faces(f, 2)));
+            if (triangle.has_on_bounded_side(centroid)) {
+                covers.emplace_back(face_box.info(), triangle_box.info());
+            }
+        });
+    // Group the output faces by input face, in input order.
+    std::sort(covers.begin(), covers.end());
+
+    // Lift the used vertices back onto the plane.
+    for (auto vh : cdt.finite_vertex_handles()) vh->info() = -1;
+    auto get_vertex = [&](CDT::Vertex_handle vh) {
+        if (vh->info() < 0) {
+            vh->info() = static_cast<Index>(out_coords.size() / 3);
+            std::array<ExactScalar, 3> p;
+            p[axis_u] = vh->point().x();
+            p[axis_v] = vh->point().y();
+            p[axis] = (offset - normal[axis_u] * p[axis_u] - normal[axis_v] * p[axis_v]) /
+                      normal[axis];
+            out_coords.insert(out_coords.end(), p.begin(), p.end());
+        }
+        return vh->info();
+    };
+
+    for (const auto& [face_index, triangle_index] : covers) {
+        const auto [f, ccw] = faces_2d[face_index];
+        const auto fh = triangles[triangle_index];
+        const Index v0 = get_vertex(fh->vertex(0));
+        const Index v1 = get_vertex(fh->vertex(1));
+        const Index v2 = get_vertex(fh->vertex(2));
+        out_faces.insert(out_faces.end(), {v0, ccw ? v1 : v2, ccw ? v2 : v1});
+        out_labels.push_back(in_face_labels[f]);
+    }
+}
+
+/**
+ * Resolve planar input: arrange each plane independently, parallel planes do
+ * not intersect.
+ */
+void resolve_planes(const MatrixEr& in_vertices,
+    const MatrixIr& in_faces,
+    const VectorI& in_face_labels,
+    const PlaneGroups& groups,
+    MatrixEr& resolved_vertices,
+    MatrixIr& resolved_faces,
+    VectorI& out_face_labels)
+{
+    int axis = 0;
+    for (int k = 1; k < 3; k++) {
+        if (CGAL::abs(groups.normal[k]) > CGAL::abs(groups.normal[axis])) axis = k;
+    }
+
+    std::vector<std::vector<Index>> plane_faces(groups.offsets.size());
+    for (Index i = 0; i < in_faces.rows(); i++) {
+        plane_faces[groups.face_planes[i]].push_back(i);
+    }
+
+    std::vector<ExactScalar> out_coords;
+    std::vector<Index> out_faces;
+    std::vector<int> out_labels;
+    for (size_t i = 0; i < plane_faces.size(); i++) {
+        resolve_plane(in_vertices,
+            in_faces,
+            in_face_labels,
+            plane_faces[i],
+            groups.normal,
+            groups.offsets[i],
+            axis,
+            out_coords,
+            out_faces,
+            out_labels);
+    }
+
+    resolved_vertices.resize(out_coords.size() / 3, 3);
+    std::move(out_coords.begin(), out_coords.end(), resolved_vertices.data());
+    resolved_faces = Eigen::Map<MatrixIr>(out_faces.data(), out_faces.size() / 3, 3);
+    out_face_labels = Eigen::Map<VectorI>(out_labels.data(), out_labels.size());
+}
+
+} // namespace
+
+struct PlanarArrangement::State : public Topology::ResolvedMesh
+{
+    RunArena run_arena;
+
+    std::pmr::memory_resource* get_resource(bool use_run_arena)
+    {
+        return use_run_arena ? run_arena.get() : std::pmr::get_default_resource();
+    }
+};
+
+PlanarArrangement::PlanarArrangement(
+    MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+    : Base(std::move(vertices), faces, face_labels)
+    , m_state(std::make_unique<State>())
+{}
+
+PlanarArrangement::~PlanarArrangement() = default;
+
+void PlanarArrangement::reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+{
+    Base::reset(std::move(vertices), faces, face_labels);
+    m_state->clear_edge_map();
+    m_state->vertices.resize(0, 3);
+    m_state->faces.resize(0, 3);
+}
+
+VectorI PlanarArrangement::detect_planes(
+    const MatrixFr& vertices, const MatrixIr& faces, size_t max_num_planes)
+{
+    if (faces.rows() == 0 || !may_be_planar(vertices, faces)) return VectorI();
+    auto groups = group_faces_by_plane(MatrixEr(vertices.cast<ExactScalar>()), faces, max_num_planes);
+    return groups ? std::move(groups->face_planes) : VectorI();
+}
+
+void PlanarArrangement::run()
+{
+    ARRANGEMENT_TRACE_SCOPE("PlanarArrangement::run");
+    if (m_quantization && !m_input_resolved) {
+        throw NotImplementedError("PlanarArrangement does not support quantized input");
+    }
+    if (!m_region_of_interest.empty() && !m_input_resolved) {
+        throw NotImplementedError("PlanarArrangement does not support a region of interest");
+    }
+    m_metrics.clear();
+    ScopedTimer stage_timer(m_metrics, "resolve");
+
+    MatrixEr& resolved_vertices = m_state->vertices;
+    MatrixIr& resolved_faces = m_state->faces;
+    const MatrixEr in_vertices = m_exact_vertices.empty()
+                                     ? MatrixEr(m_vertices.cast<ExactScalar>())
+                                     : ExactUtils::from_rational_strings(m_exact_vertices);
+    if (m_input_resolved) {
+        // Input is already arranged, keep it as is.
+        resolved_vertices = in_vertices;
+        resolved_faces = m_faces;
+        m_out_face_labels = m_in_face_labels;
+    } else {
+        const auto groups =
+            group_faces_by_plane(in_vertices, m_faces, get_max_num_planes());
+        if (!groups) {
+            throw RuntimeError("PlanarArrangement requires faces in at most " +
+                               std::to_string(get_max_num_planes()) + " parallel planes");
+        }
+        m_metrics.values["num_planes"] = static_cast<double>(groups->offsets.size());
+        resolve_planes(in_vertices,
+            m_faces,
+            m_in_face_labels,
+            *groups,
+            resolved_vertices,
+            resolved_faces,
+            m_out_face_labels);
+    }
+    if (m_snap_rounding) {
+        SnapRounding::snap_round(
+            resolved_vertices, resolved_faces, m_out_face_labels, m_snap_grid_size);
+    }
+    stage_timer.restart("extract");
+
+    extract_arrangement();
+
+    stage_timer.stop();
+    if (m_verbose) {
+        std::cout << "Arrangement: resolving planar arrangement: " << m_metrics.timings["resolve"]
+                  << std::endl;
+        std::cout << "Arrangement: extracting arrangement: " << m_metrics.timings["extract"]
+                  << std::endl;
+    }
+}
+
+void PlanarArrangement::extract_arrangement()
+{
+    const MatrixEr& resolved_vertices = m_state->vertices;
+    m_state->clear_edge_map();
+    reset_topology();
+    if (m_merge_coplanar) {
+        // Patches delimit the regions to merge.
+        ensure_topology(TOPOLOGY_PATCHES);
+        CoplanarMerge::merge(*m_state,
+            m_patches,
+            m_out_face_labels,
+            m_metrics,
+            m_state->get_resource(m_run_arena));
+    }
+    if (m_run_arena) {
+        m_state->run_arena.release();
+        m_metrics.values["run_arena_bytes"] =
+            static_cast<double>(m_state->run_arena.get_block_size());
+    }
+    m_metrics.values["num_output_vertices"] = static_cast<double>(resolved_vertices.rows());
+    m_metrics.values["num_output_faces"] = static_cast<double>(m_state->faces.rows());
+
+    if (m_output_sink != nullptr) {
+        // Streamed output: only the eager stages are computed, from the
+        // resolved mesh, which is then released.
+        m_vertices.resize(0, 3);
+        ensure_topology(m_eager_stages);
+        const size_t num_vertices = resolved_vertices.rows();
+        m_faces.swap(m_state->faces);
+        m_state->faces.resize(0, 3);
+        stream_output(num_vertices, [this](OutputSink& sink) {
+            Topology::stream_vertices(*m_state, m_exact_output, sink);
+        });
+        return;
+    }
+
+    Topology::to_float_vertices(*m_state, m_vertices);
+    m_faces = m_state->faces;
+    if (m_exact_output) {
+        ExactUtils::to_rational_strings(resolved_vertices, m_exact_vertices);
+    } else {
+        m_exact_vertices.clear();
+    }
+
+    // Remaining stages are computed on first access.
+    ensure_topology(m_eager_stages);
+}
+
+void PlanarArrangement::compute_topology(unsigned stages) const
+{
+    Topology::compute_stages(*m_state,
+        stages,
+        get_computed_stages(),
+        false,
+        m_patches,
+        m_cells,
+        m_winding_number,
+        m_metrics);
+}
+
+#endif
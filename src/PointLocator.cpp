@@ -0,0 +1,134 @@
+#include <arrangement/Exception.h>
+#include <arrangement/ParallelUtils.h>
+#include <arrangement/PointLocator.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace arrangement;
+
+namespace {
+
+// Generic ray directions.  None of them is axis aligned, so the ray/box slab
+// test never divides by zero, and they are unlikely to align with features of
+// typical CAD inputs.
+const std::array<Vector3F, 6> RAY_DIRECTIONS = {Vector3F(0.8173, 0.4432, 0.3681),
+    Vector3F(-0.3127, 0.8911, 0.3290),
+    Vector3F(0.2741, -0.3384, 0.9002),
+    Vector3F(-0.6522, -0.5210, 0.5506),
+    Vector3F(0.5917, -0.7306, -0.3407),
+    Vector3F(-0.4486, 0.3132, -0.8372)};
+
+constexpr size_t NUM_FALLBACK_DIRECTIONS = 32;
+
+// Random directions tried once the generic ones are all ambiguous.  The seed
+// is fixed so that queries are reproducible.
+const std::vector<Vector3F>& get_fallback_directions()
+{
+    static const std::vector<Vector3F> directions = [] {
+        std::mt19937 generator(7);
+        std::normal_distribution<Float> distribution;
+        std::vector<Vector3F> result;
+        result.reserve(NUM_FALLBACK_DIRECTIONS);
+        while (result.size() < NUM_FALLBACK_DIRECTIONS) {
+            Vector3F d(distribution(generator), distribution(generator), distribution(generator));
+            if (d.cwiseAbs().minCoeff() < 1e-3) continue;
+            result.push_back(d.normalized());
+        }
+        return result;
+    }();
+    return directions;
+}
+
+} // namespace
+
+PointLocator::PointLocator(const Arrangement& arrangement, const VectorI& label_groups)
+    : m_arrangement(arrangement)
+    , m_tree(arrangement.get_vertices(), arrangement.get_faces())
+    , m_num_threads(arrangement.get_num_threads())
+{
+    if (label_groups.size() > 0) {
+        m_cell_winding_numbers = arrangement.get_cell_winding_numbers(label_groups);
+    } else {
+        const auto& labels = arrangement.get_out_face_labels();
+        const int num_labels = labels.size() > 0 ? labels.maxCoeff() + 1 : 0;
+        m_cell_winding_numbers =
+            arrangement.get_cell_winding_numbers(VectorI::Zero(num_labels));
+    }
+}
+
+int PointLocator::locate(const Vector3F& point) const
+{
+    const auto& vertices = m_arrangement.get_vertices();
+    const auto& faces = m_arrangement.get_faces();
+    const auto& patches = m_arrangement.get_patches();
+    const auto& cells = m_arrangement.get_cells();
+
+    AABBTree::RayHit hit;
+    Vector3F direction;
+    for (const auto& d : RAY_DIRECTIONS) {
+        direction = d;
+        hit = m_tree.intersect_ray(point, direction);
+        if (!hit.ambiguous) break;
+    }
+    if (hit.ambiguous) {
+        for (const auto& d : get_fallback_directions()) {
+            direction = d;
+            hit = m_tree.intersect_ray(point, direction);
+            if (!hit.ambiguous) break;
+        }
+    }
+
+    // The point is on the surface, or no ray gives a reliable answer.
+    if (hit.ambiguous) return -1;
+
+    // Nothing in the way: the point is in the ambient cell.
+    if (hit.face < 0) return 0;
+
+    const Vector3F v0 = vertices.row(faces(hit.face, 0)).transpose();
+    const Vector3F v1 = vertices.row(faces(hit.face, 1)).transpose();
+    const Vector3F v2 = vertices.row(faces(hit.face, 2)).transpose();
+    const Vector3F normal = (v1 - v0).cross(v2 - v0);
+    const int patch_id = patches[hit.face];
+
+    // The ray leaves the cell of the query point through the hit face.  If it
+    // travels along the face normal, the point is on the negative side.
+    return normal.dot(direction) > 0 ? cells(patch_id, 1) : cells(patch_id, 0);
+}
+
+VectorI PointLocator::locate(const MatrixFr& points) const
+{
+    if (points.cols() != 3) {
+        throw RuntimeError("Query points must be a #points by 3 matrix");
+    }
+    const size_t num_points = points.rows();
+    VectorI cell_ids(num_points);
+    ParallelUtils::parallel_for(
+        num_points,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                cell_ids[i] = locate(Vector3F(points.row(i).transpose()));
+            }
+        },
+        m_num_threads,
+        256);
+    return cell_ids;
+}
+
+MatrixIr PointLocator::compute_winding_numbers(const MatrixFr& points) const
+{
+    const VectorI cell_ids = locate(points);
+    const size_t num_points = cell_ids.size();
+    MatrixIr winding_numbers(num_points, m_cell_winding_numbers.cols());
+    for (size_t i = 0; i < num_points; i++) {
+        if (cell_ids[i] < 0) {
+            winding_numbers.row(i).setConstant(UNKNOWN_WINDING_NUMBER);
+        } else {
+            winding_numbers.row(i) = m_cell_winding_numbers.row(cell_ids[i]);
+        }
+    }
+    return winding_numbers;
+}
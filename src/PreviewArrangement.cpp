@@ -0,0 +1,312 @@
+#include <arrangement/EngineRegistry.h>
+#include <arrangement/Exception.h>
+#include <arrangement/PreviewArrangement.h>
+#include <arrangement/Trace.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <unordered_map>
+
+using namespace arrangement;
+
+namespace {
+
+// Grid coordinates are packed in 21 bits each.
+constexpr size_t MAX_GRID_COORDINATE = (size_t(1) << 21) - 1;
+
+std::uint64_t get_cell_key(const std::array<std::uint64_t, 3>& cell)
+{
+    return (cell[0] << 42) | (cell[1] << 21) | cell[2];
+}
+
+} // namespace
+
+PreviewArrangement::~PreviewArrangement()
+{
+    wait_for_refinement();
+}
+
+PreviewArrangement::Proxy PreviewArrangement::compute_proxy(const MatrixFr& vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    Float grid_size)
+{
+    const size_t num_vertices = vertices.rows();
+    const size_t num_faces = faces.rows();
+    Proxy proxy;
+
+    // Cluster of each referenced vertex, -1 for the others.  Clusters are
+    // numbered in vertex order, so that a grid merging nothing keeps the input.
+    std::vector<Index> clusters(num_vertices, -1);
+    for (size_t i = 0; i < num_faces; i++) {
+        for (size_t k = 0; k < 3; k++) clusters[faces(i, k)] = 0;
+    }
+    std::vector<Vector3F> sums;
+    std::vector<size_t> counts;
+    auto add_cluster = [&]() {
+        sums.push_back(Vector3F::Zero());
+        counts.push_back(0);
+        return static_cast<Index>(sums.size() - 1);
+    };
+
+    if (grid_size > 0 && num_faces > 0) {
+        const Vector3F box_min = vertices.colwise().minCoeff().transpose();
+        const Vector3F box_max = vertices.colwise().maxCoeff().transpose();
+        if (((box_max - box_min) / grid_size).maxCoeff() >= Float(MAX_GRID_COORDINATE)) {
+            throw RuntimeError("Proxy grid is too fine for the input bounding box");
+        }
+        std::unordered_map<std::uint64_t, Index> cells;
+        for (size_t v = 0; v < num_vertices; v++) {
+            if (clusters[v] < 0) continue;
+            std::array<std::uint64_t, 3> cell;
+            for (int d = 0; d < 3; d++) {
+                cell[d] = static_cast<std::uint64_t>(
+                    std::floor((vertices(v, d) - box_min[d]) / grid_size));
+            }
+            auto [itr, inserted] = cells.try_emplace(get_cell_key(cell), 0);
+            if (inserted) itr->second = add_cluster();
+            clusters[v] = itr->second;
+        }
+    } else {
+        for (size_t v = 0; v < num_vertices; v++) {
+            if (clusters[v] >= 0) clusters[v] = add_cluster();
+        }
+    }
+
+    for (size_t v = 0; v < num_vertices; v++) {
+        if (clusters[v] < 0) continue;
+        sums[clusters[v]] += vertices.row(v).transpose();
+        counts[clusters[v]]++;
+    }
+    proxy.vertices.resize(sums.size(), 3);
+    for (size_t c = 0; c < sums.size(); c++) {
+        proxy.vertices.row(c) = (sums[c] / static_cast<Float>(counts[c])).transpose();
+    }
+
+    for (size_t i = 0; i < num_faces; i++) {
+        const Index c0 = clusters[faces(i, 0)];
+        const Index c1 = clusters[faces(i, 1)];
+        const Index c2 = clusters[faces(i, 2)];
+        if (c0 == c1 || c1 == c2 || c2 == c0) continue;
+        proxy.source_faces.push_back(i);
+    }
+    const size_t num_proxy_faces = proxy.source_faces.size();
+    proxy.faces.resize(num_proxy_faces, 3);
+    proxy.face_labels.resize(num_proxy_faces);
+    for (size_t i = 0; i < num_proxy_faces; i++) {
+        const size_t f = proxy.source_faces[i];
+        for (size_t k = 0; k < 3; k++) proxy.faces(i, k) = clusters[faces(f, k)];
+        proxy.face_labels[i] = face_labels[f];
+    }
+    return proxy;
+}
+
+Arrangement::Ptr PreviewArrangement::create_engine(MatrixFr vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    bool full_input) const
+{
+    Ptr engine =
+        m_engine_name == "auto"
+            ? create_auto_arrangement(std::move(vertices), faces, face_labels)
+            : EngineRegistry::create(m_engine_name, std::move(vertices), faces, face_labels);
+    if (engine == nullptr) {
+        throw NotImplementedError("Arrangement engine is not available: " + m_engine_name);
+    }
+
+    // Exact coordinates and resolved input only describe the full input.
+    if (full_input) {
+        if (!m_exact_vertices.empty()) engine->set_exact_vertices(m_exact_vertices);
+        engine->set_input_resolved(m_input_resolved);
+    }
+    engine->set_exact_output(m_exact_output);
+    engine->set_snap_rounding(m_snap_rounding, m_snap_grid_size);
+    engine->set_quantization(m_quantization, m_quantization_grid_size);
+    engine->set_merge_coplanar(m_merge_coplanar);
+    engine->set_run_arena(m_run_arena);
+    engine->set_num_threads(m_num_threads);
+    engine->set_verbose(m_verbose);
+    engine->set_eager_stages(engine->get_eager_stages() & m_eager_stages);
+    return engine;
+}
+
+void PreviewArrangement::run()
+{
+    ARRANGEMENT_TRACE_SCOPE("PreviewArrangement::run");
+    wait_for_refinement();
+    m_metrics.clear();
+    m_engine.reset();
+    m_approximate = false;
+
+    const auto begin = std::chrono::steady_clock::now();
+    auto get_elapsed = [&]() {
+        return std::chrono::duration<Float>(std::chrono::steady_clock::now() - begin).count();
+    };
+
+    size_t num_used_vertices = 0;
+    {
+        std::vector<bool> used(m_vertices.rows(), false);
+        for (Index i = 0; i < m_faces.size(); i++) used[m_faces.data()[i]] = true;
+        num_used_vertices = std::count(used.begin(), used.end(), true);
+    }
+    const Float diagonal =
+        m_vertices.rows() > 0
+            ? (m_vertices.colwise().maxCoeff() - m_vertices.colwise().minCoeff()).norm()
+            : Float(0);
+
+    // Proxy of the next level, computed ahead to predict its time.
+    Proxy proxy;
+    bool exact = m_proxy_resolution == 0 || diagonal == 0;
+    size_t resolution = m_proxy_resolution;
+    if (!exact) {
+        ScopedTimer timer(m_metrics, "proxy");
+        proxy = compute_proxy(m_vertices, m_faces, m_in_face_labels, diagonal / resolution);
+        exact = static_cast<size_t>(proxy.vertices.rows()) == num_used_vertices;
+    }
+
+    size_t num_levels = 0;
+    while (!exact) {
+        const size_t num_proxy_faces = proxy.faces.rows();
+        if (m_verbose) {
+            std::cout << "Arrangement: preview level " << num_levels << ", " << num_proxy_faces
+                      << " of " << m_faces.rows() << " faces" << std::endl;
+        }
+        const Float level_begin = get_elapsed();
+        {
+            ScopedTimer timer(m_metrics, "preview.level" + std::to_string(num_levels));
+            VectorI face_mask;
+            if (m_region_of_interest.face_mask.size() > 0) {
+                face_mask.resize(num_proxy_faces);
+                for (size_t i = 0; i < num_proxy_faces; i++) {
+                    face_mask[i] = m_region_of_interest.face_mask[proxy.source_faces[i]];
+                }
+            }
+            auto engine =
+                create_engine(std::move(proxy.vertices), proxy.faces, proxy.face_labels, false);
+            RegionOfInterest region_of_interest = m_region_of_interest;
+            region_of_interest.face_mask = face_mask;
+            engine->set_region_of_interest(region_of_interest);
+            engine->run();
+            m_engine = engine;
+        }
+        const Float level_time = get_elapsed() - level_begin;
+        m_approximate = true;
+        m_metrics.values["preview.grid_size"] = diagonal / resolution;
+        m_metrics.values["preview.num_faces"] = static_cast<Float>(num_proxy_faces);
+        num_levels++;
+
+        if (get_elapsed() >= m_time_budget || resolution > MAX_GRID_COORDINATE / 2) break;
+        resolution *= 2;
+        {
+            ScopedTimer timer(m_metrics, "proxy");
+            proxy = compute_proxy(m_vertices, m_faces, m_in_face_labels, diagonal / resolution);
+        }
+        const bool next_exact = static_cast<size_t>(proxy.vertices.rows()) == num_used_vertices;
+        const size_t num_next_faces = next_exact ? m_faces.rows() : proxy.faces.rows();
+        const Float predicted_time = level_time * static_cast<Float>(num_next_faces) /
+                                     static_cast<Float>(std::max<size_t>(num_proxy_faces, 1));
+        if (get_elapsed() + predicted_time > m_time_budget) break;
+        exact = next_exact;
+    }
+    m_metrics.values["preview.num_levels"] = static_cast<Float>(num_levels);
+
+    if (exact) {
+        // The grid no longer merges anything: arrange the full input.
+        ScopedTimer timer(m_metrics, "preview.full");
+        auto engine = create_engine(m_vertices, m_faces, m_in_face_labels, true);
+        engine->set_region_of_interest(m_region_of_interest);
+        engine->run();
+        m_engine = engine;
+        m_approximate = false;
+    }
+    m_metrics.timings["preview"] = get_elapsed();
+
+    if (m_refine_callback && m_approximate) {
+        start_refinement(std::move(m_vertices), m_faces, m_in_face_labels);
+    }
+    copy_result();
+    if (m_refine_callback && !m_approximate) {
+        // Hand the engine over, with nothing left for compute_topology() to
+        // pull from it: the callback may pass it to another thread.
+        ensure_topology(TOPOLOGY_ALL);
+        m_refine_callback(std::move(m_engine), "");
+    }
+    if (m_output_sink != nullptr) {
+        m_engine.reset();
+        stream_output(m_vertices.rows());
+    }
+}
+
+void PreviewArrangement::start_refinement(MatrixFr vertices, MatrixIr faces, VectorI face_labels)
+{
+    Ptr engine;
+    std::string error;
+    try {
+        engine = create_engine(std::move(vertices), faces, face_labels, true);
+        engine->set_region_of_interest(m_region_of_interest);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    // The thread owns everything it uses, the options were copied above.
+    m_refine_thread = std::thread(
+        [engine = std::move(engine), error = std::move(error), callback = m_refine_callback]() {
+            ARRANGEMENT_TRACE_SCOPE("PreviewArrangement::refine");
+            if (engine == nullptr) {
+                callback(nullptr, error);
+                return;
+            }
+            try {
+                engine->run();
+            } catch (const std::exception& e) {
+                callback(nullptr, e.what());
+                return;
+            }
+            callback(engine, "");
+        });
+}
+
+void PreviewArrangement::wait_for_refinement()
+{
+    if (m_refine_thread.joinable()) m_refine_thread.join();
+}
+
+void PreviewArrangement::reset(MatrixFr vertices, const MatrixIr& faces, const VectorI& face_labels)
+{
+    wait_for_refinement();
+    Base::reset(std::move(vertices), faces, face_labels);
+    m_engine.reset();
+    m_approximate = false;
+}
+
+void PreviewArrangement::copy_result()
+{
+    m_vertices = m_engine->get_vertices();
+    m_faces = m_engine->get_faces();
+    m_out_face_labels = m_engine->get_out_face_labels();
+    m_exact_vertices = m_engine->get_exact_vertices();
+    m_cells.resize(0, 2);
+    m_patches.resize(0);
+    m_winding_number.resize(0, 2);
+    reset_topology();
+    ensure_topology(m_engine->get_computed_stages());
+
+    const Metrics& engine_metrics = m_engine->get_metrics();
+    for (const auto& [key, value] : engine_metrics.timings) m_metrics.timings[key] = value;
+    for (const auto& [key, value] : engine_metrics.values) m_metrics.values[key] = value;
+    for (const auto& [key, value] : engine_metrics.notes) m_metrics.notes[key] = value;
+    for (const auto& [key, value] : engine_metrics.memory) m_metrics.memory[key] = value;
+    m_metrics.notes["preview"] = m_approximate ? "approximate" : "exact";
+}
+
+void PreviewArrangement::compute_topology(unsigned stages) const
+{
+    if (m_engine == nullptr) return;
+    if (stages & TOPOLOGY_PATCHES) m_patches = m_engine->get_patches();
+    if (stages & TOPOLOGY_CELLS) m_cells = m_engine->get_cells();
+    if (stages & TOPOLOGY_WINDING_NUMBERS) m_winding_number = m_engine->get_winding_number();
+}
@@ -0,0 +1,221 @@
+#ifdef ARRANGEMENT_IGL
+
+#include "Quantization.h"
+
+#include <arrangement/Exception.h>
+
+#include <CGAL/Fraction_traits.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace arrangement {
+namespace Quantization {
+
+namespace {
+
+#ifdef __SIZEOF_INT128__
+typedef __int128 Int128;
+typedef unsigned __int128 UInt128;
+typedef std::array<Int128, 3> Vector3;
+
+Vector3 sub(const IntPoint& a, const IntPoint& b)
+{
+    return {Int128(a[0]) - b[0], Int128(a[1]) - b[1], Int128(a[2]) - b[2]};
+}
+
+Vector3 cross(const Vector3& a, const Vector3& b)
+{
+    return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+}
+
+Int128 dot(const Vector3& a, const Vector3& b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+Int128 dot(const Vector3& a, const IntPoint& b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+typedef std::decay_t<decltype(CGAL::exact(std::declval<ExactUtils::ExactScalar>()))> Rational;
+typedef CGAL::Fraction_traits<Rational> FracTraits;
+/// Arbitrary precision integer of the exact kernel.
+typedef FracTraits::Numerator_type Integer;
+
+Integer to_integer(Int128 value)
+{
+    // Built from 30-bit chunks, every integer type is constructible from int.
+    const bool negative = value < 0;
+    const UInt128 magnitude = negative ? -static_cast<UInt128>(value) : static_cast<UInt128>(value);
+    const Integer base(1 << 30);
+    Integer result(0);
+    for (int shift = 120; shift >= 0; shift -= 30) {
+        result = result * base + Integer(static_cast<int>((magnitude >> shift) & 0x3fffffff));
+    }
+    return negative ? Integer(-result) : result;
+}
+
+/// Dot product of 128-bit vectors, whose result may need more than 128 bits.
+Integer wide_dot(const Vector3& a, const Vector3& b)
+{
+    return to_integer(a[0]) * to_integer(b[0]) + to_integer(a[1]) * to_integer(b[1]) +
+           to_integer(a[2]) * to_integer(b[2]);
+}
+
+ExactUtils::ExactScalar to_exact(Integer num, Integer den)
+{
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    return ExactUtils::ExactScalar(FracTraits::Compose()(num, den));
+}
+
+ExactUtils::ExactScalar to_exact(Int128 num, Int128 den)
+{
+    return to_exact(to_integer(num), to_integer(den));
+}
+#endif
+
+} // namespace
+
+bool has_integer_arithmetic()
+{
+#ifdef __SIZEOF_INT128__
+    return true;
+#else
+    return false;
+#endif
+}
+
+Float choose_grid_size(const MatrixFr& vertices, int bits)
+{
+    const Float max_coord = vertices.size() > 0 ? vertices.cwiseAbs().maxCoeff() : 0;
+    if (max_coord == 0) return 1;
+    int exponent = 0;
+    std::frexp(max_coord, &exponent);
+    // max_coord < 2^exponent, so max_coord / grid_size < 2^bits.
+    return std::ldexp(1.0, exponent - bits);
+}
+
+int quantize(const MatrixFr& vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    Float grid_size,
+    MatrixFr& grid_vertices,
+    MatrixIr& grid_faces,
+    VectorI& grid_face_labels)
+{
+    if (!(grid_size > 0)) {
+        throw RuntimeError("Quantization grid size must be positive");
+    }
+    grid_vertices = (vertices / grid_size).array().round().matrix();
+
+    const Float max_coord = grid_vertices.size() > 0 ? grid_vertices.cwiseAbs().maxCoeff() : 0;
+    int bits = 0;
+    if (max_coord > 0) std::frexp(max_coord, &bits);
+    if (bits > 52) {
+        throw RuntimeError("Quantization grid is too fine for the input coordinates");
+    }
+
+    grid_faces.resize(faces.rows(), 3);
+    grid_face_labels.resize(faces.rows());
+    Index num_faces = 0;
+    for (Index i = 0; i < faces.rows(); i++) {
+        const auto v0 = grid_vertices.row(faces(i, 0));
+        const auto v1 = grid_vertices.row(faces(i, 1));
+        const auto v2 = grid_vertices.row(faces(i, 2));
+        if (v0 == v1 || v1 == v2 || v2 == v0) continue;
+        grid_faces.row(num_faces) = faces.row(i);
+        grid_face_labels[num_faces] = face_labels[i];
+        num_faces++;
+    }
+    grid_faces.conservativeResize(num_faces, 3);
+    grid_face_labels.conservativeResize(num_faces);
+    return bits;
+}
+
+bool to_int_point(double x, double y, double z, double scale, IntPoint& point)
+{
+    const double coords[3] = {x, y, z};
+    for (size_t i = 0; i < 3; i++) {
+        const double value = std::nearbyint(coords[i] / scale);
+        // coords[i] / scale is exactly the integer value.
+        if (std::fma(value, scale, -coords[i]) != 0) return false;
+        if (std::abs(value) >= 0x1p52) return false;
+        point[i] = static_cast<std::int64_t>(value);
+    }
+    return true;
+}
+
+bool intersect_line_plane(const IntPoint& P,
+    const IntPoint& Q,
+    const IntPoint& R,
+    const IntPoint& S,
+    const IntPoint& T,
+    int bits,
+    ExactPoint& result)
+{
+#ifdef __SIZEOF_INT128__
+    if (bits > LINE_PLANE_MAX_BITS) return false;
+
+    // With |coordinates| <= 2^bits, the normal is below 2^(2 bits + 3), the
+    // denominator below 2^(3 bits + 6) and the numerators below 2^(4 bits + 8).
+    const Vector3 normal = cross(sub(S, R), sub(T, R));
+    const Vector3 direction = sub(Q, P);
+    const Int128 den = dot(normal, direction);
+    if (den == 0) return false;
+    const Int128 t = dot(normal, sub(R, P));
+    for (size_t i = 0; i < 3; i++) {
+        result[i] = to_exact(Int128(P[i]) * den + t * direction[i], den);
+    }
+    return true;
+#else
+    (void)P, (void)Q, (void)R, (void)S, (void)T, (void)bits, (void)result;
+    return false;
+#endif
+}
+
+bool intersect_three_planes(const std::array<IntPoint, 3>& V,
+    const std::array<IntPoint, 3>& W,
+    const std::array<IntPoint, 3>& U,
+    int bits,
+    ExactPoint& result)
+{
+#ifdef __SIZEOF_INT128__
+    if (bits > THREE_PLANES_MAX_BITS) return false;
+
+    // Planes n_i . x = d_i.  The normals, the d_i and their cross products fit
+    // in 128 bits, below 2^(2 bits + 3), 2^(3 bits + 5) and 2^(4 bits + 7).
+    // The determinant, below 2^(6 bits + 12), and the numerators, below
+    // 2^(7 bits + 14), do not and are computed with the exact integers.
+    const Vector3 n1 = cross(sub(V[1], V[0]), sub(V[2], V[0]));
+    const Vector3 n2 = cross(sub(W[1], W[0]), sub(W[2], W[0]));
+    const Vector3 n3 = cross(sub(U[1], U[0]), sub(U[2], U[0]));
+    const Int128 d1 = dot(n1, V[0]);
+    const Int128 d2 = dot(n2, W[0]);
+    const Int128 d3 = dot(n3, U[0]);
+
+    const Vector3 c23 = cross(n2, n3);
+    const Vector3 c31 = cross(n3, n1);
+    const Vector3 c12 = cross(n1, n2);
+    const Integer den = wide_dot(n1, c23);
+    if (den == 0) return false;
+    const Vector3 d = {d1, d2, d3};
+    for (size_t i = 0; i < 3; i++) {
+        result[i] = to_exact(wide_dot(d, {c23[i], c31[i], c12[i]}), den);
+    }
+    return true;
+#else
+    (void)V, (void)W, (void)U, (void)bits, (void)result;
+    return false;
+#endif
+}
+
+} // namespace Quantization
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
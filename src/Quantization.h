@@ -0,0 +1,103 @@
+#pragma once
+
+#ifdef ARRANGEMENT_IGL
+
+#include <arrangement/EigenTypedef.h>
+
+#include "ExactUtils.h"
+
+#include <array>
+#include <cstdint>
+
+namespace arrangement {
+namespace Quantization {
+
+typedef std::array<std::int64_t, 3> IntPoint;
+typedef std::array<ExactUtils::ExactScalar, 3> ExactPoint;
+
+/// Default number of bits of the grid coordinates when the grid is chosen automatically.
+constexpr int DEFAULT_BITS = 26;
+/// Largest coordinate bit size for which line-plane intersections fit in 128 bits.
+constexpr int LINE_PLANE_MAX_BITS = 29;
+/// Largest coordinate bit size for which the planes of 3-plane intersections
+/// fit in 128 bits.
+constexpr int THREE_PLANES_MAX_BITS = 29;
+
+/**
+ * Whether fixed-width integer reconstruction is available (requires 128-bit
+ * integers).  When not, every intersection falls back to Epeck.
+ */
+bool has_integer_arithmetic();
+
+/**
+ * Choose a power of 2 grid spacing such that all coordinates fit in `bits`
+ * bits once divided by the spacing.
+ */
+Float choose_grid_size(const MatrixFr& vertices, int bits = DEFAULT_BITS);
+
+/**
+ * Snap vertices to integer multiples of grid_size and express them in grid
+ * units.  Faces that collapse because two of their corners snap to the same
+ * point are dropped.
+ *
+ * @param[in] vertices Input vertices.
+ * @param[in] faces Input faces.
+ * @param[in] face_labels Input face labels.
+ * @param[in] grid_size Grid spacing.
+ * @param[out] grid_vertices Vertices in grid units, all integers.
+ * @param[out] grid_faces Faces that did not collapse.
+ * @param[out] grid_face_labels Labels of the faces that did not collapse.
+ *
+ * @return The number of bits needed by the largest grid coordinate.
+ *
+ * @throws RuntimeError if the grid is too fine for the coordinates to be
+ * represented exactly.
+ */
+int quantize(const MatrixFr& vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    Float grid_size,
+    MatrixFr& grid_vertices,
+    MatrixIr& grid_faces,
+    VectorI& grid_face_labels);
+
+/**
+ * Recover the integer coordinates of a point scaled by `scale`.  Fails if the
+ * scaled coordinates are not exactly integers times `scale`.
+ */
+bool to_int_point(double x, double y, double z, double scale, IntPoint& point);
+
+/**
+ * Exact intersection of the line (P, Q) with the plane (R, S, T), computed
+ * with 128-bit integer determinants and a single rational division.
+ *
+ * @return false if the coordinates need more than LINE_PLANE_MAX_BITS bits or
+ * the line is parallel to the plane.  The caller should then fall back to
+ * Epeck.
+ */
+bool intersect_line_plane(const IntPoint& P,
+    const IntPoint& Q,
+    const IntPoint& R,
+    const IntPoint& S,
+    const IntPoint& T,
+    int bits,
+    ExactPoint& result);
+
+/**
+ * Exact intersection of the planes (V1, V2, V3), (W1, W2, W3) and
+ * (U1, U2, U3).  The planes are computed with 128-bit integers, the final
+ * determinants with the exact kernel integers.
+ *
+ * @return false if the coordinates need more than THREE_PLANES_MAX_BITS bits
+ * or the planes do not meet at a single point.
+ */
+bool intersect_three_planes(const std::array<IntPoint, 3>& V,
+    const std::array<IntPoint, 3>& W,
+    const std::array<IntPoint, 3>& U,
+    int bits,
+    ExactPoint& result);
+
+} // namespace Quantization
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
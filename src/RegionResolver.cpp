@@ -0,0 +1,253 @@
+#ifdef ARRANGEMENT_IGL
+
+#include <arrangement/Exception.h>
+
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+
+#include <igl/remove_unreferenced.h>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory_resource>
+#include <vector>
+
+#include "RegionResolver.h"
+#include "Topology.h"
+
+namespace arrangement {
+namespace RegionResolver {
+
+namespace {
+
+typedef ExactUtils::ExactScalar ExactScalar;
+typedef ExactUtils::MatrixEr MatrixEr;
+
+/**
+ * Vertices sorted by approximate x coordinate for range queries.
+ */
+class VertexIndex
+{
+public:
+    VertexIndex(const MatrixEr& vertices, const std::vector<Index>& indices)
+        : m_vertices(vertices)
+    {
+        m_entries.reserve(indices.size());
+        for (const Index i : indices) {
+            m_entries.push_back({CGAL::to_double(vertices(i, 0)), i});
+        }
+        std::sort(m_entries.begin(), m_entries.end());
+    }
+
+    /**
+     * Find vertices strictly inside the segment (a, b).
+     */
+    void query_segment(Index a, Index b, std::vector<Index>& result) const
+    {
+        Float box_min[3], box_max[3];
+        for (int k = 0; k < 3; k++) {
+            const Float xa = CGAL::to_double(m_vertices(a, k));
+            const Float xb = CGAL::to_double(m_vertices(b, k));
+            const Float pad = 1e-9 * std::max({std::abs(xa), std::abs(xb), Float(1)});
+            box_min[k] = std::min(xa, xb) - pad;
+            box_max[k] = std::max(xa, xb) + pad;
+        }
+
+        result.clear();
+        auto itr = std::lower_bound(
+            m_entries.begin(), m_entries.end(), std::make_pair(box_min[0], Index(-1)));
+        for (; itr != m_entries.end() && itr->first <= box_max[0]; ++itr) {
+            const Index i = itr->second;
+            if (i == a || i == b) continue;
+            bool inside = true;
+            for (int k = 1; k < 3 && inside; k++) {
+                const Float x = CGAL::to_double(m_vertices(i, k));
+                inside = x >= box_min[k] && x <= box_max[k];
+            }
+            if (inside) result.push_back(i);
+        }
+        Topology::order_on_segment(m_vertices, a, b, result);
+    }
+
+private:
+    const MatrixEr& m_vertices;
+    std::vector<std::pair<Float, Index>> m_entries;
+};
+
+} // namespace
+
+std::vector<bool> select_faces(
+    const MatrixFr& vertices, const MatrixIr& faces, const RegionOfInterest& region)
+{
+    const Eigen::Index num_faces = faces.rows();
+    std::vector<bool> selected(num_faces, false);
+    if (region.face_mask.size() > 0) {
+        if (region.face_mask.size() != num_faces) {
+            throw RuntimeError("Region of interest face mask must have #faces entries");
+        }
+        for (Eigen::Index i = 0; i < num_faces; i++) {
+            selected[i] = region.face_mask[i] != 0;
+        }
+    } else if (region.use_box) {
+        for (Eigen::Index i = 0; i < num_faces; i++) {
+            const Vector3F v0 = vertices.row(faces(i, 0)).transpose();
+            const Vector3F v1 = vertices.row(faces(i, 1)).transpose();
+            const Vector3F v2 = vertices.row(faces(i, 2)).transpose();
+            selected[i] = (v0.cwiseMin(v1).cwiseMin(v2).array() <= region.box_max.array()).all() &&
+                          (v0.cwiseMax(v1).cwiseMax(v2).array() >= region.box_min.array()).all();
+        }
+    } else {
+        std::fill(selected.begin(), selected.end(), true);
+    }
+    return selected;
+}
+
+size_t resolve(const MatrixFr& vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    const RegionOfInterest& region,
+    const Resolver& resolver,
+    MatrixEr& resolved_vertices,
+    MatrixIr& resolved_faces,
+    VectorI& out_face_labels,
+    std::pmr::memory_resource* resource)
+{
+    const Eigen::Index num_vertices = vertices.rows();
+    const Eigen::Index num_faces = faces.rows();
+    const std::vector<bool> selected = select_faces(vertices, faces, region);
+
+    // Extract the region.
+    std::pmr::vector<Index> vertex_map(num_vertices, -1, resource);
+    std::pmr::vector<Index> region_vertices(resource);
+    std::pmr::vector<Eigen::Index> region_faces(resource);
+    for (Eigen::Index i = 0; i < num_faces; i++) {
+        if (!selected[i]) continue;
+        region_faces.push_back(i);
+        for (int k = 0; k < 3; k++) {
+            const Index v = faces(i, k);
+            if (vertex_map[v] < 0) {
+                vertex_map[v] = static_cast<Index>(region_vertices.size());
+                region_vertices.push_back(v);
+            }
+        }
+    }
+    const Eigen::Index num_region_faces = static_cast<Eigen::Index>(region_faces.size());
+
+    MatrixFr sub_vertices(region_vertices.size(), 3);
+    for (size_t i = 0; i < region_vertices.size(); i++) {
+        sub_vertices.row(i) = vertices.row(region_vertices[i]);
+    }
+    MatrixIr sub_faces(num_region_faces, 3);
+    VectorI sub_labels(num_region_faces);
+    for (Eigen::Index i = 0; i < num_region_faces; i++) {
+        for (int k = 0; k < 3; k++) {
+            sub_faces(i, k) = vertex_map[faces(region_faces[i], k)];
+        }
+        sub_labels[i] = face_labels[region_faces[i]];
+    }
+
+    MatrixEr sub_resolved_vertices;
+    MatrixIr sub_resolved_faces;
+    VectorI sub_resolved_labels;
+    if (num_region_faces > 0) {
+        resolver(sub_vertices,
+            sub_faces,
+            sub_labels,
+            sub_resolved_vertices,
+            sub_resolved_faces,
+            sub_resolved_labels);
+    } else {
+        sub_resolved_vertices.resize(0, 3);
+        sub_resolved_faces.resize(0, 3);
+    }
+
+    // Merge resolved vertices with the input vertices they coincide with,
+    // append the others.
+    std::map<std::array<ExactScalar, 3>, Index> input_vertex_map;
+    for (const Index v : region_vertices) {
+        input_vertex_map.emplace(std::array<ExactScalar, 3>{ExactScalar(vertices(v, 0)),
+                                     ExactScalar(vertices(v, 1)),
+                                     ExactScalar(vertices(v, 2))},
+            v);
+    }
+    std::pmr::vector<Index> resolved_vertex_map(sub_resolved_vertices.rows(), resource);
+    std::pmr::vector<Eigen::Index> new_vertices(resource);
+    for (Eigen::Index i = 0; i < sub_resolved_vertices.rows(); i++) {
+        const std::array<ExactScalar, 3> key{
+            sub_resolved_vertices(i, 0), sub_resolved_vertices(i, 1), sub_resolved_vertices(i, 2)};
+        auto itr = input_vertex_map.find(key);
+        if (itr != input_vertex_map.end()) {
+            resolved_vertex_map[i] = itr->second;
+        } else {
+            resolved_vertex_map[i] = static_cast<Index>(num_vertices + new_vertices.size());
+            new_vertices.push_back(i);
+        }
+    }
+
+    // Vertices added while repairing the seam (face centroids) go last.
+    std::vector<std::array<ExactScalar, 3>> seam_vertices;
+    MatrixEr all_vertices(num_vertices + new_vertices.size(), 3);
+    all_vertices.topRows(num_vertices) = vertices.cast<ExactScalar>();
+    for (size_t i = 0; i < new_vertices.size(); i++) {
+        all_vertices.row(num_vertices + i) = sub_resolved_vertices.row(new_vertices[i]);
+    }
+
+    std::pmr::vector<std::array<Index, 3>> out_faces(resource);
+    std::pmr::vector<int> out_labels(resource);
+    out_faces.reserve(num_faces - num_region_faces + sub_resolved_faces.rows());
+    out_labels.reserve(out_faces.capacity());
+    for (Eigen::Index i = 0; i < sub_resolved_faces.rows(); i++) {
+        out_faces.push_back({resolved_vertex_map[sub_resolved_faces(i, 0)],
+            resolved_vertex_map[sub_resolved_faces(i, 1)],
+            resolved_vertex_map[sub_resolved_faces(i, 2)]});
+        out_labels.push_back(sub_resolved_labels[i]);
+    }
+
+    // Candidate seam vertices: every vertex of the resolved region.
+    std::vector<Index> candidates(resolved_vertex_map.begin(), resolved_vertex_map.end());
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    const VertexIndex candidate_index(all_vertices, candidates);
+
+    // Keep faces outside the region, splitting the edges they share with it.
+    std::array<std::vector<Index>, 3> splits;
+    std::vector<std::array<Index, 3>> triangles;
+    for (Eigen::Index i = 0; i < num_faces; i++) {
+        if (selected[i]) continue;
+        const std::array<Index, 3> corners = {faces(i, 0), faces(i, 1), faces(i, 2)};
+        for (int k = 0; k < 3; k++) {
+            splits[k].clear();
+            const Index a = corners[k];
+            const Index b = corners[(k + 1) % 3];
+            if (vertex_map[a] >= 0 && vertex_map[b] >= 0) {
+                candidate_index.query_segment(a, b, splits[k]);
+            }
+        }
+        Topology::split_face(all_vertices, corners, splits, seam_vertices, triangles);
+        out_faces.insert(out_faces.end(), triangles.begin(), triangles.end());
+        out_labels.insert(out_labels.end(), triangles.size(), face_labels[i]);
+    }
+
+    const Eigen::Index num_all_vertices = all_vertices.rows();
+    all_vertices.conservativeResize(num_all_vertices + seam_vertices.size(), 3);
+    for (size_t i = 0; i < seam_vertices.size(); i++) {
+        for (int d = 0; d < 3; d++) {
+            all_vertices(num_all_vertices + i, d) = seam_vertices[i][d];
+        }
+    }
+
+    MatrixIr all_faces(out_faces.size(), 3);
+    for (size_t i = 0; i < out_faces.size(); i++) {
+        all_faces.row(i) << out_faces[i][0], out_faces[i][1], out_faces[i][2];
+    }
+    Eigen::VectorXi UIM;
+    igl::remove_unreferenced(all_vertices, all_faces, resolved_vertices, resolved_faces, UIM);
+    out_face_labels = Eigen::Map<VectorI>(out_labels.data(), out_labels.size());
+
+    return static_cast<size_t>(num_region_faces);
+}
+
+} // namespace RegionResolver
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
@@ -0,0 +1,61 @@
+#pragma once
+
+#ifdef ARRANGEMENT_IGL
+
+#include <arrangement/Arrangement.h>
+#include <arrangement/EigenTypedef.h>
+
+#include <functional>
+#include <memory_resource>
+#include <vector>
+
+#include "ExactUtils.h"
+
+namespace arrangement {
+namespace RegionResolver {
+
+/**
+ * Resolve the self-intersections of a mesh exactly.  This is the resolve
+ * stage of an engine.
+ */
+using Resolver = std::function<void(const MatrixFr& vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    ExactUtils::MatrixEr& resolved_vertices,
+    MatrixIr& resolved_faces,
+    VectorI& out_face_labels)>;
+
+/**
+ * Select the faces of a region of interest.
+ *
+ * @throws RuntimeError if the face mask does not have #faces entries.
+ */
+std::vector<bool> select_faces(
+    const MatrixFr& vertices, const MatrixIr& faces, const RegionOfInterest& region);
+
+/**
+ * Resolve self-intersections among the faces of a region only.
+ *
+ * The faces of the region are extracted and resolved by `resolver`.  Resolved
+ * vertices coinciding with input vertices are merged with them.  Faces
+ * outside the region are kept, except that faces sharing an edge with the
+ * region are retriangulated to include the vertices inserted on that edge.
+ *
+ * Per-face and per-vertex temporaries are allocated from `resource`.
+ *
+ * @return Number of faces in the region.
+ */
+size_t resolve(const MatrixFr& vertices,
+    const MatrixIr& faces,
+    const VectorI& face_labels,
+    const RegionOfInterest& region,
+    const Resolver& resolver,
+    ExactUtils::MatrixEr& resolved_vertices,
+    MatrixIr& resolved_faces,
+    VectorI& out_face_labels,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+} // namespace RegionResolver
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
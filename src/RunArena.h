@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace arrangement {
+
+/**
+ * Monotonic arena backing the temporaries of one run, released in one shot.
+ *
+ * Allocations are served from a block kept across runs.  Whatever does not
+ * fit is taken from the heap, and the block is grown to the total used on
+ * release(), so that later runs of similar size do not allocate at all.
+ * Not thread safe.
+ */
+class RunArena
+{
+public:
+    /**
+     * @brief Memory resource of the current run.
+     */
+    std::pmr::memory_resource* get()
+    {
+        if (!m_resource) {
+            if (m_block) {
+                m_resource.emplace(m_block.get(), m_block_size, &m_overflow);
+            } else {
+                m_resource.emplace(&m_overflow);
+            }
+        }
+        return &*m_resource;
+    }
+
+    /**
+     * @brief Release all memory allocated since the last release.  The block
+     * is kept for the next run.
+     */
+    void release()
+    {
+        m_resource.reset();
+        const size_t num_bytes = m_block_size + m_overflow.num_bytes;
+        if (num_bytes > m_block_size) {
+            // Default initialized: pages are only touched once used.
+            m_block.reset(new std::byte[num_bytes]);
+            m_block_size = num_bytes;
+        }
+        m_overflow.num_bytes = 0;
+    }
+
+    /**
+     * @brief Size of the retained block in bytes.
+     */
+    size_t get_block_size() const { return m_block_size; }
+
+private:
+    /// Heap resource counting the bytes requested beyond the block.
+    struct Overflow : public std::pmr::memory_resource
+    {
+        size_t num_bytes = 0;
+
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            num_bytes += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    std::unique_ptr<std::byte[]> m_block;
+    size_t m_block_size = 0;
+    Overflow m_overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> m_resource;
+};
+
+} // namespace arrangement
@@ -0,0 +1,388 @@
+#ifdef ARRANGEMENT_IGL
+
+#include <arrangement/Exception.h>
+
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+
+#include <igl/copyleft/cgal/RemeshSelfIntersectionsParam.h>
+#include <igl/copyleft/cgal/SelfIntersectMesh.h>
+#include <igl/remove_unreferenced.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "SnapRounding.h"
+#include "Topology.h"
+
+namespace arrangement {
+namespace SnapRounding {
+
+namespace {
+
+typedef CGAL::Epeck Kernel;
+typedef ExactUtils::ExactScalar ExactScalar;
+typedef ExactUtils::MatrixEr MatrixEr;
+
+Float round_float(Float x, Float grid_size)
+{
+    if (grid_size > 0) {
+        return std::round(x / grid_size) * grid_size;
+    } else {
+        return x;
+    }
+}
+
+Float round_value(const ExactScalar& value, Float grid_size)
+{
+    return round_float(CGAL::to_double(value), grid_size);
+}
+
+void round_rows(const MatrixEr& exact_vertices,
+    Eigen::Index first_row,
+    Float grid_size,
+    MatrixFr& vertices)
+{
+    const Eigen::Index num_rows = exact_vertices.rows() - first_row;
+    vertices.resize(num_rows, 3);
+    for (Eigen::Index i = 0; i < num_rows; i++) {
+        for (Eigen::Index j = 0; j < 3; j++) {
+            vertices(i, j) = round_value(exact_vertices(first_row + i, j), grid_size);
+        }
+    }
+}
+
+/**
+ * Merge vertices with identical coordinates and drop faces that collapse to a
+ * point.  Return the faces that collapse to a segment.
+ */
+std::vector<Eigen::Index> merge_vertices(
+    const MatrixFr& vertices, MatrixIr& faces, VectorI& face_labels)
+{
+    const Eigen::Index num_vertices = vertices.rows();
+    std::map<std::array<Float, 3>, Index> vertex_map;
+    std::vector<Index> vertex_mapping(num_vertices);
+    for (Eigen::Index i = 0; i < num_vertices; i++) {
+        const std::array<Float, 3> key{vertices(i, 0), vertices(i, 1), vertices(i, 2)};
+        auto itr = vertex_map.emplace(key, static_cast<Index>(i)).first;
+        vertex_mapping[i] = itr->second;
+    }
+
+    std::vector<Eigen::Index> collapsed;
+    const Eigen::Index num_faces = faces.rows();
+    Eigen::Index face_count = 0;
+    for (Eigen::Index i = 0; i < num_faces; i++) {
+        const Index v0 = vertex_mapping[faces(i, 0)];
+        const Index v1 = vertex_mapping[faces(i, 1)];
+        const Index v2 = vertex_mapping[faces(i, 2)];
+        if (v0 == v1 || v1 == v2 || v2 == v0) continue;
+
+        const Kernel::Point_3 p0(vertices(v0, 0), vertices(v0, 1), vertices(v0, 2));
+        const Kernel::Point_3 p1(vertices(v1, 0), vertices(v1, 1), vertices(v1, 2));
+        const Kernel::Point_3 p2(vertices(v2, 0), vertices(v2, 1), vertices(v2, 2));
+        if (CGAL::collinear(p0, p1, p2)) collapsed.push_back(face_count);
+
+        faces.row(face_count) << v0, v1, v2;
+        face_labels[face_count] = face_labels[i];
+        face_count++;
+    }
+    faces.conservativeResize(face_count, 3);
+    face_labels.conservativeResize(face_count);
+    return collapsed;
+}
+
+/**
+ * Merge vertices with identical coordinates and drop faces that collapse to a
+ * segment or a point.
+ *
+ * The middle vertex of a face collapsing to a segment lies on its longest
+ * edge.  The faces across that edge are split at it, like the kept faces in
+ * repair(), else they would be left with a T-junction.  Faces collapsing along
+ * a shared edge are split together, at the vertices of all of them.  Face
+ * centroids added by the splits are rounded, which may collapse further faces,
+ * so this repeats a few times.
+ */
+void cleanup(MatrixFr& vertices, MatrixIr& faces, VectorI& face_labels, Float grid_size)
+{
+    constexpr size_t max_passes = 8;
+    for (size_t pass = 0;; pass++) {
+        const std::vector<Eigen::Index> collapsed = merge_vertices(vertices, faces, face_labels);
+        if (collapsed.empty()) return;
+
+        // Group collapsed faces sharing an edge, each group pooling the
+        // vertices its neighbours may need to be split at.
+        const size_t num_collapsed = collapsed.size();
+        std::vector<size_t> group(num_collapsed);
+        std::iota(group.begin(), group.end(), size_t(0));
+        auto find_group = [&group](size_t i) {
+            while (group[i] != i) i = group[i] = group[group[i]];
+            return i;
+        };
+        std::map<std::pair<Index, Index>, size_t> edge_group;
+        for (size_t i = 0; i < num_collapsed; i++) {
+            for (Eigen::Index k = 0; k < 3; k++) {
+                const auto edge = std::minmax(
+                    faces(collapsed[i], k), faces(collapsed[i], (k + 1) % 3));
+                auto [itr, inserted] = edge_group.emplace(edge, i);
+                if (!inserted) group[find_group(i)] = find_group(itr->second);
+            }
+        }
+        std::map<size_t, std::vector<Index>> group_vertices;
+        for (size_t i = 0; i < num_collapsed; i++) {
+            auto& pool = group_vertices[find_group(i)];
+            for (Eigen::Index k = 0; k < 3; k++) pool.push_back(faces(collapsed[i], k));
+        }
+
+        std::vector<bool> is_collapsed(faces.rows(), false);
+        for (const Eigen::Index f : collapsed) is_collapsed[f] = true;
+        const bool split = pass < max_passes;
+        std::vector<std::array<Float, 3>> seam_vertices;
+        std::vector<std::array<Index, 3>> out_faces;
+        std::vector<int> out_labels;
+        std::array<std::vector<Index>, 3> splits;
+        std::vector<std::array<Index, 3>> triangles;
+        for (Eigen::Index i = 0; i < faces.rows(); i++) {
+            if (is_collapsed[i]) continue;
+            const std::array<Index, 3> corners = {faces(i, 0), faces(i, 1), faces(i, 2)};
+            for (int k = 0; k < 3; k++) {
+                splits[k].clear();
+                auto itr = edge_group.find(std::minmax(corners[k], corners[(k + 1) % 3]));
+                if (!split || itr == edge_group.end()) continue;
+                splits[k] = group_vertices[find_group(itr->second)];
+                std::sort(splits[k].begin(), splits[k].end());
+                splits[k].erase(
+                    std::unique(splits[k].begin(), splits[k].end()), splits[k].end());
+                Topology::order_on_segment(vertices, corners[k], corners[(k + 1) % 3], splits[k]);
+            }
+            Topology::split_face(vertices, corners, splits, seam_vertices, triangles);
+            out_faces.insert(out_faces.end(), triangles.begin(), triangles.end());
+            out_labels.insert(out_labels.end(), triangles.size(), face_labels[i]);
+        }
+
+        const Eigen::Index num_vertices = vertices.rows();
+        vertices.conservativeResize(num_vertices + seam_vertices.size(), 3);
+        for (size_t i = 0; i < seam_vertices.size(); i++) {
+            for (int d = 0; d < 3; d++) {
+                vertices(num_vertices + i, d) = round_float(seam_vertices[i][d], grid_size);
+            }
+        }
+        faces.resize(out_faces.size(), 3);
+        face_labels.resize(out_faces.size());
+        for (size_t i = 0; i < out_faces.size(); i++) {
+            faces.row(i) << out_faces[i][0], out_faces[i][1], out_faces[i][2];
+            face_labels[i] = out_labels[i];
+        }
+        if (!split) return;
+    }
+}
+
+/**
+ * Find pairs of intersecting faces.
+ */
+MatrixIr detect_intersections(const MatrixFr& vertices, const MatrixIr& faces)
+{
+    igl::copyleft::cgal::RemeshSelfIntersectionsParam params;
+    params.detect_only = true;
+
+    MatrixEr V;
+    MatrixIr F;
+    MatrixIr intersecting_faces;
+    VectorI source_faces;
+    VectorI source_vertices;
+    igl::copyleft::cgal::SelfIntersectMesh<Kernel,
+        MatrixFr,
+        MatrixIr,
+        MatrixEr,
+        MatrixIr,
+        MatrixIr,
+        VectorI,
+        VectorI>
+        detector(
+            vertices, faces, params, V, F, intersecting_faces, source_faces, source_vertices);
+    return intersecting_faces;
+}
+
+/**
+ * Re-resolve the faces involved in intersections.  Other faces are kept, split
+ * along the edges they share with re-resolved faces so that the mesh stays
+ * conforming.  New vertices are rounded and appended to `vertices`.
+ */
+void repair(MatrixFr& vertices,
+    MatrixIr& faces,
+    VectorI& face_labels,
+    const MatrixIr& intersecting_faces,
+    Float grid_size)
+{
+    const Eigen::Index num_faces = faces.rows();
+    std::vector<bool> involved(num_faces, false);
+    for (Eigen::Index i = 0; i < intersecting_faces.size(); i++) {
+        involved[intersecting_faces.data()[i]] = true;
+    }
+
+    MatrixIr local_faces(std::count(involved.begin(), involved.end(), true), 3);
+    VectorI local_labels(local_faces.rows());
+    MatrixIr kept_faces(num_faces - local_faces.rows(), 3);
+    VectorI kept_labels(kept_faces.rows());
+    {
+        Eigen::Index local_count = 0;
+        Eigen::Index kept_count = 0;
+        for (Eigen::Index i = 0; i < num_faces; i++) {
+            if (involved[i]) {
+                local_faces.row(local_count) = faces.row(i);
+                local_labels[local_count] = face_labels[i];
+                local_count++;
+            } else {
+                kept_faces.row(kept_count) = faces.row(i);
+                kept_labels[kept_count] = face_labels[i];
+                kept_count++;
+            }
+        }
+    }
+
+    // The resolver keeps all input vertices in front of the newly created ones,
+    // so kept faces remain valid.
+    igl::copyleft::cgal::RemeshSelfIntersectionsParam params;
+    MatrixEr V;
+    MatrixIr F;
+    MatrixIr local_intersecting_faces;
+    VectorI source_faces;
+    VectorI source_vertices;
+    igl::copyleft::cgal::SelfIntersectMesh<Kernel,
+        MatrixFr,
+        MatrixIr,
+        MatrixEr,
+        MatrixIr,
+        MatrixIr,
+        VectorI,
+        VectorI>
+        resolver(vertices,
+            local_faces,
+            params,
+            V,
+            F,
+            local_intersecting_faces,
+            source_faces,
+            source_vertices);
+    std::for_each(F.data(), F.data() + F.size(), [&source_vertices](Index& a) {
+        a = source_vertices[a];
+    });
+
+    // Kept faces sharing an edge with a re-resolved face are split at the new
+    // vertices the resolver put on that edge.  Left as is, they would form a
+    // T-junction, which turns into a crack or an overlap once the new vertices
+    // are rounded off the edge.
+    const Index num_old_vertices = static_cast<Index>(vertices.rows());
+    std::vector<std::vector<Index>> local_new_vertices(local_faces.rows());
+    for (Eigen::Index i = 0; i < F.rows(); i++) {
+        for (Eigen::Index k = 0; k < 3; k++) {
+            if (F(i, k) >= num_old_vertices) {
+                local_new_vertices[source_faces[i]].push_back(F(i, k));
+            }
+        }
+    }
+    // New vertices around each undirected edge of the re-resolved faces.
+    std::map<std::pair<Index, Index>, std::vector<Index>> edge_candidates;
+    for (Eigen::Index i = 0; i < local_faces.rows(); i++) {
+        if (local_new_vertices[i].empty()) continue;
+        for (Eigen::Index k = 0; k < 3; k++) {
+            const Index a = local_faces(i, k);
+            const Index b = local_faces(i, (k + 1) % 3);
+            auto& candidates = edge_candidates[std::minmax(a, b)];
+            candidates.insert(
+                candidates.end(), local_new_vertices[i].begin(), local_new_vertices[i].end());
+        }
+    }
+    for (auto& [edge, candidates] : edge_candidates) {
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    }
+
+    // New vertices strictly inside edge (a, b), ordered from a to b.
+    auto get_splits = [&](Index a, Index b, std::vector<Index>& splits) {
+        splits.clear();
+        auto itr = edge_candidates.find(std::minmax(a, b));
+        if (itr == edge_candidates.end()) return;
+        splits = itr->second;
+        Topology::order_on_segment(V, a, b, splits);
+    };
+
+    // Face centroids added while splitting, rounded with the new vertices.
+    std::vector<std::array<ExactScalar, 3>> seam_vertices;
+    std::vector<std::array<Index, 3>> out_faces;
+    std::vector<int> out_labels;
+    std::array<std::vector<Index>, 3> splits;
+    std::vector<std::array<Index, 3>> triangles;
+    for (Eigen::Index i = 0; i < kept_faces.rows(); i++) {
+        const std::array<Index, 3> corners = {kept_faces(i, 0), kept_faces(i, 1), kept_faces(i, 2)};
+        for (int k = 0; k < 3; k++) get_splits(corners[k], corners[(k + 1) % 3], splits[k]);
+        Topology::split_face(V, corners, splits, seam_vertices, triangles);
+        out_faces.insert(out_faces.end(), triangles.begin(), triangles.end());
+        out_labels.insert(out_labels.end(), triangles.size(), kept_labels[i]);
+    }
+    for (Eigen::Index i = 0; i < F.rows(); i++) {
+        out_faces.push_back({F(i, 0), F(i, 1), F(i, 2)});
+        out_labels.push_back(local_labels[source_faces[i]]);
+    }
+
+    const Eigen::Index num_resolved_vertices = V.rows();
+    V.conservativeResize(num_resolved_vertices + seam_vertices.size(), 3);
+    for (size_t i = 0; i < seam_vertices.size(); i++) {
+        for (int d = 0; d < 3; d++) V(num_resolved_vertices + i, d) = seam_vertices[i][d];
+    }
+
+    MatrixFr new_vertices;
+    round_rows(V, vertices.rows(), grid_size, new_vertices);
+    vertices.conservativeResize(vertices.rows() + new_vertices.rows(), 3);
+    vertices.bottomRows(new_vertices.rows()) = new_vertices;
+
+    faces.resize(out_faces.size(), 3);
+    face_labels.resize(out_faces.size());
+    for (size_t i = 0; i < out_faces.size(); i++) {
+        faces.row(i) << out_faces[i][0], out_faces[i][1], out_faces[i][2];
+        face_labels[i] = out_labels[i];
+    }
+}
+
+} // namespace
+
+void snap_round(MatrixEr& vertices,
+    MatrixIr& faces,
+    VectorI& face_labels,
+    Float grid_size,
+    size_t max_iterations)
+{
+    MatrixFr rounded_vertices;
+    round_rows(vertices, 0, grid_size, rounded_vertices);
+    cleanup(rounded_vertices, faces, face_labels, grid_size);
+
+    bool intersection_free = false;
+    for (size_t i = 0; i <= max_iterations; i++) {
+        const MatrixIr intersecting_faces = detect_intersections(rounded_vertices, faces);
+        if (intersecting_faces.rows() == 0) {
+            intersection_free = true;
+            break;
+        }
+        if (i == max_iterations) break;
+        repair(rounded_vertices, faces, face_labels, intersecting_faces, grid_size);
+        cleanup(rounded_vertices, faces, face_labels, grid_size);
+    }
+    if (!intersection_free) {
+        throw RuntimeError("Snap rounding did not converge to an intersection-free mesh");
+    }
+
+    MatrixFr compact_vertices;
+    MatrixIr compact_faces;
+    Eigen::VectorXi I;
+    igl::remove_unreferenced(rounded_vertices, faces, compact_vertices, compact_faces, I);
+    vertices = compact_vertices.cast<ExactScalar>();
+    faces = compact_faces;
+}
+
+} // namespace SnapRounding
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
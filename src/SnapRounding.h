@@ -0,0 +1,42 @@
+#pragma once
+
+#ifdef ARRANGEMENT_IGL
+
+#include <arrangement/EigenTypedef.h>
+
+#include "ExactUtils.h"
+
+namespace arrangement {
+namespace SnapRounding {
+
+/**
+ * Snap round an exactly resolved mesh.
+ *
+ * Vertices are rounded to the nearest double (grid_size == 0) or to the nearest
+ * point of a uniform grid of spacing grid_size.  Vertices that coincide after
+ * rounding are merged and collapsed faces are dropped.  Faces that intersect
+ * because of the rounding are then re-resolved locally and the new vertices are
+ * rounded again, until the rounded mesh is free of self-intersections.
+ *
+ * On return, vertices are exactly representable as doubles and the mesh is
+ * free of self-intersections.
+ *
+ * @param vertices Exact vertices, replaced by the snapped vertices.
+ * @param faces Faces, replaced by the snapped faces.
+ * @param face_labels Per-face labels, updated to match the snapped faces.
+ * @param grid_size Grid spacing, or 0 to round to doubles.
+ * @param max_iterations Maximum number of repair rounds.
+ *
+ * @throws RuntimeError if the mesh is still self-intersecting after
+ * max_iterations rounds.
+ */
+void snap_round(ExactUtils::MatrixEr& vertices,
+    MatrixIr& faces,
+    VectorI& face_labels,
+    Float grid_size,
+    size_t max_iterations = 16);
+
+} // namespace SnapRounding
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
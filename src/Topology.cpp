@@ -0,0 +1,149 @@
+#ifdef ARRANGEMENT_IGL
+
+#include <arrangement/Arrangement.h>
+
+#include <igl/copyleft/cgal/extract_cells.h>
+#include <igl/copyleft/cgal/propagate_winding_numbers.h>
+#include <igl/extract_manifold_patches.h>
+#include <igl/unique_edge_map.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include "Topology.h"
+
+namespace arrangement {
+namespace Topology {
+
+void ResolvedMesh::build_edge_map()
+{
+    if (has_edge_map) return;
+    igl::unique_edge_map(faces, E, uE, EMAP, uEC, uEE);
+    has_edge_map = true;
+}
+
+void ResolvedMesh::clear_edge_map()
+{
+    E.resize(0, 0);
+    uE.resize(0, 0);
+    uEC.resize(0, 0);
+    uEE.resize(0, 0);
+    EMAP.resize(0);
+    has_edge_map = false;
+}
+
+void compute_patches(ResolvedMesh& mesh, VectorI& patches)
+{
+    mesh.build_edge_map();
+    igl::extract_manifold_patches(mesh.faces, mesh.EMAP, mesh.uEC, mesh.uEE, patches);
+}
+
+void compute_cells(ResolvedMesh& mesh, const VectorI& patches, MatrixIr& cells)
+{
+    mesh.build_edge_map();
+    igl::copyleft::cgal::extract_cells(mesh.vertices,
+        mesh.faces,
+        patches,
+        mesh.uE,
+        mesh.EMAP,
+        mesh.uEC,
+        mesh.uEE,
+        cells);
+    assert(cells.cols() == 2);
+}
+
+void compute_winding_numbers(ResolvedMesh& mesh,
+    const VectorI& patches,
+    const MatrixIr& cells,
+    MatrixIr& winding_number)
+{
+    mesh.build_edge_map();
+    const size_t num_patches = patches.size() > 0 ? patches.maxCoeff() + 1 : 0;
+    const size_t num_cells = cells.rows() > 0 ? cells.maxCoeff() + 1 : 0;
+    VectorI labels = VectorI::Zero(mesh.faces.rows());
+    igl::copyleft::cgal::propagate_winding_numbers(mesh.vertices,
+        mesh.faces,
+        mesh.uE,
+        mesh.uEC,
+        mesh.uEE,
+        num_patches,
+        patches,
+        num_cells,
+        cells,
+        labels,
+        winding_number);
+}
+
+void compute_stages(ResolvedMesh& mesh,
+    unsigned stages,
+    unsigned computed_stages,
+    bool partial,
+    VectorI& patches,
+    MatrixIr& cells,
+    MatrixIr& winding_number,
+    Metrics& metrics)
+{
+    if (stages & TOPOLOGY_PATCHES) {
+        ScopedTimer timer(metrics, "patches");
+        compute_patches(mesh, patches);
+    }
+    if (stages & TOPOLOGY_CELLS) {
+        ScopedTimer timer(metrics, "cells");
+        if (partial) {
+            cells.resize(0, 2);
+        } else {
+            compute_cells(mesh, patches, cells);
+        }
+    }
+    if (stages & TOPOLOGY_WINDING_NUMBERS) {
+        ScopedTimer timer(metrics, "winding_numbers");
+        if (partial) {
+            winding_number.resize(0, 2);
+        } else {
+            compute_winding_numbers(mesh, patches, cells, winding_number);
+        }
+    }
+
+    // The edge map is only needed until the last stage is done.
+    if ((computed_stages | stages) == TOPOLOGY_ALL) {
+        mesh.clear_edge_map();
+    }
+}
+
+void to_float_vertices(const ResolvedMesh& mesh, MatrixFr& vertices)
+{
+    vertices = MatrixFr(mesh.vertices.rows(), mesh.vertices.cols());
+    std::transform(mesh.vertices.data(),
+        mesh.vertices.data() + mesh.vertices.size(),
+        vertices.data(),
+        [](const ExactUtils::ExactScalar& val) { return CGAL::to_double(val); });
+}
+
+void stream_vertices(ResolvedMesh& mesh, bool exact_output, OutputSink& sink)
+{
+    mesh.clear_edge_map();
+    const size_t num_vertices = mesh.vertices.rows();
+    const size_t chunk_size = std::max<size_t>(1, sink.get_chunk_size());
+    MatrixFr chunk;
+    std::vector<std::string> exact_chunk;
+    for (size_t begin = 0; begin < num_vertices; begin += chunk_size) {
+        const size_t n = std::min(chunk_size, num_vertices - begin);
+        const auto exact_rows = mesh.vertices.middleRows(begin, n);
+        chunk.resize(n, 3);
+        std::transform(exact_rows.data(),
+            exact_rows.data() + exact_rows.size(),
+            chunk.data(),
+            [](const ExactUtils::ExactScalar& val) { return CGAL::to_double(val); });
+        if (exact_output) {
+            ExactUtils::to_rational_strings(exact_rows, exact_chunk);
+        }
+        sink.write_vertices(begin, chunk, exact_chunk);
+    }
+    mesh.vertices.resize(0, 3);
+    mesh.faces.resize(0, 3);
+}
+
+} // namespace Topology
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
@@ -0,0 +1,169 @@
+#pragma once
+
+#ifdef ARRANGEMENT_IGL
+
+#include <arrangement/EigenTypedef.h>
+#include <arrangement/Metrics.h>
+#include <arrangement/OutputSink.h>
+
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "ExactUtils.h"
+
+namespace arrangement {
+namespace Topology {
+
+/**
+ * Exactly resolved mesh kept by an engine after run(), together with the
+ * intermediate data shared by the topology stages.
+ */
+struct ResolvedMesh
+{
+    ExactUtils::MatrixEr vertices;
+    MatrixIr faces;
+
+    // Unique edge map, built on demand by the first stage that needs it.
+    Eigen::Matrix<Index, Eigen::Dynamic, Eigen::Dynamic> E, uE, uEC, uEE;
+    Eigen::Matrix<Index, Eigen::Dynamic, 1> EMAP;
+    bool has_edge_map = false;
+
+    void build_edge_map();
+    void clear_edge_map();
+};
+
+/**
+ * Extract manifold patches.
+ */
+void compute_patches(ResolvedMesh& mesh, VectorI& patches);
+
+/**
+ * Extract cells from the patches.
+ */
+void compute_cells(ResolvedMesh& mesh, const VectorI& patches, MatrixIr& cells);
+
+/**
+ * Propagate winding numbers across the cells.
+ */
+void compute_winding_numbers(ResolvedMesh& mesh,
+    const VectorI& patches,
+    const MatrixIr& cells,
+    MatrixIr& winding_number);
+
+/**
+ * Compute the requested stages (a mask of TopologyStage values, in dependency
+ * order), timing each into `metrics`.  When `partial` is set the mesh is only
+ * arranged within a region of interest and cells and winding numbers are left
+ * empty.  The edge map is released once all stages are computed.
+ */
+void compute_stages(ResolvedMesh& mesh,
+    unsigned stages,
+    unsigned computed_stages,
+    bool partial,
+    VectorI& patches,
+    MatrixIr& cells,
+    MatrixIr& winding_number,
+    Metrics& metrics);
+
+/**
+ * Cast the resolved vertices to Float.
+ */
+void to_float_vertices(const ResolvedMesh& mesh, MatrixFr& vertices);
+
+/**
+ * Write the resolved vertices to `sink` in chunks, cast to Float (and as
+ * rational strings if `exact_output` is set), then release the resolved mesh.
+ */
+void stream_vertices(ResolvedMesh& mesh, bool exact_output, OutputSink& sink);
+
+/**
+ * Keep the vertices of `candidates` lying strictly inside the segment (a, b),
+ * tested exactly, and order them from a to b.
+ */
+template <typename DerivedV>
+void order_on_segment(
+    const Eigen::MatrixBase<DerivedV>& vertices, Index a, Index b, std::vector<Index>& candidates)
+{
+    typedef CGAL::Epeck::Point_3 Point;
+    auto get_point = [&vertices](Index v) {
+        return Point(vertices(v, 0), vertices(v, 1), vertices(v, 2));
+    };
+    const Point pa = get_point(a);
+    const Point pb = get_point(b);
+    candidates.erase(std::remove_if(candidates.begin(),
+                         candidates.end(),
+                         [&](Index v) {
+                             if (v == a || v == b) return true;
+                             const Point p = get_point(v);
+                             return !CGAL::collinear(pa, p, pb) ||
+                                    !CGAL::collinear_are_strictly_ordered_along_line(pa, p, pb);
+                         }),
+        candidates.end());
+    std::sort(candidates.begin(), candidates.end(), [&](Index u, Index v) {
+        return CGAL::compare_distance_to_point(pa, get_point(u), get_point(v)) == CGAL::SMALLER;
+    });
+}
+
+/**
+ * Retriangulate a face to include the vertices inserted on its edges, so that
+ * it stays conforming with the faces across those edges.  A face with one split
+ * edge is fanned from the opposite corner.  A face with several is fanned from
+ * its centroid, which is appended to `seam_vertices` and numbered
+ * vertices.rows() + its position there.
+ *
+ * @param splits Vertices strictly inside each edge (corners[k], corners[k + 1]),
+ * ordered from corners[k] (see order_on_segment()).
+ * @param triangles Triangles replacing the face, oriented like it.
+ */
+template <typename DerivedV, typename Scalar>
+void split_face(const Eigen::MatrixBase<DerivedV>& vertices,
+    const std::array<Index, 3>& corners,
+    const std::array<std::vector<Index>, 3>& splits,
+    std::vector<std::array<Scalar, 3>>& seam_vertices,
+    std::vector<std::array<Index, 3>>& triangles)
+{
+    triangles.clear();
+    const size_t num_split_edges =
+        std::count_if(splits.begin(), splits.end(), [](const auto& s) { return !s.empty(); });
+    if (num_split_edges == 0) {
+        triangles.push_back(corners);
+    } else if (num_split_edges == 1) {
+        // Fan from the corner opposite to the split edge.
+        int k = 0;
+        while (splits[k].empty()) k++;
+        std::vector<Index> chain;
+        chain.push_back(corners[k]);
+        chain.insert(chain.end(), splits[k].begin(), splits[k].end());
+        chain.push_back(corners[(k + 1) % 3]);
+        const Index apex = corners[(k + 2) % 3];
+        for (size_t j = 0; j + 1 < chain.size(); j++) {
+            triangles.push_back({chain[j], chain[j + 1], apex});
+        }
+    } else {
+        // Fan from the centroid, which is strictly inside the face.
+        std::vector<Index> loop;
+        for (int k = 0; k < 3; k++) {
+            loop.push_back(corners[k]);
+            loop.insert(loop.end(), splits[k].begin(), splits[k].end());
+        }
+        const Index center = static_cast<Index>(vertices.rows() + seam_vertices.size());
+        std::array<Scalar, 3> centroid;
+        for (int d = 0; d < 3; d++) {
+            centroid[d] = (Scalar(vertices(corners[0], d)) + Scalar(vertices(corners[1], d)) +
+                              Scalar(vertices(corners[2], d))) /
+                          3;
+        }
+        seam_vertices.push_back(centroid);
+        for (size_t j = 0; j < loop.size(); j++) {
+            triangles.push_back({loop[j], loop[(j + 1) % loop.size()], center});
+        }
+    }
+}
+
+} // namespace Topology
+} // namespace arrangement
+
+#endif // ARRANGEMENT_IGL
@@ -0,0 +1,185 @@
+#include <arrangement/Exception.h>
+#include <arrangement/Trace.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace arrangement {
+namespace Trace {
+
+#ifdef ARRANGEMENT_WITH_TRACE
+
+namespace {
+
+struct Span
+{
+    std::string name;
+    const char* category;
+    Clock::time_point begin;
+    Clock::time_point end;
+    unsigned thread_id;
+};
+
+struct Session
+{
+    std::atomic<bool> recording{false};
+    std::mutex mutex;
+    Clock::time_point origin;
+    std::vector<Span> spans;
+    std::map<unsigned, std::string> thread_names;
+};
+
+Session& get_session()
+{
+    static Session session;
+    return session;
+}
+
+/// Small sequential id of the calling thread, stable for its lifetime.
+unsigned get_thread_id()
+{
+    static std::atomic<unsigned> next_id{0};
+    thread_local const unsigned id = next_id++;
+    return id;
+}
+
+std::string escape(std::string_view str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            result.push_back('\\');
+            result.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+            result += buffer;
+        } else {
+            result.push_back(c);
+        }
+    }
+    return result;
+}
+
+double to_microseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+bool is_available()
+{
+    return true;
+}
+
+void start()
+{
+    Session& session = get_session();
+    std::lock_guard<std::mutex> lock(session.mutex);
+    session.spans.clear();
+    session.origin = Clock::now();
+    session.recording = true;
+}
+
+void stop(const std::string& filename)
+{
+    Session& session = get_session();
+    std::lock_guard<std::mutex> lock(session.mutex);
+    if (!session.recording) {
+        throw RuntimeError("Trace::stop() called without Trace::start()");
+    }
+    session.recording = false;
+
+    std::ofstream out(filename);
+    if (!out) {
+        throw RuntimeError("Cannot open trace file: " + filename);
+    }
+    // Timestamps in microseconds, with nanosecond resolution.
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& [thread_id, name] : session.thread_names) {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << thread_id << ",\"args\":{\"name\":\"" << escape(name) << "\"}}";
+        first = false;
+    }
+    for (const auto& span : session.spans) {
+        out << (first ? "" : ",") << "\n{\"name\":\"" << escape(span.name) << "\",\"cat\":\""
+            << span.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << span.thread_id
+            << ",\"ts\":" << to_microseconds(span.begin - session.origin)
+            << ",\"dur\":" << to_microseconds(span.end - span.begin) << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+    session.spans.clear();
+    if (!out) {
+        throw RuntimeError("Failed to write trace file: " + filename);
+    }
+}
+
+bool is_recording()
+{
+    return get_session().recording.load(std::memory_order_relaxed);
+}
+
+void record_span(
+    std::string_view name, const char* category, Clock::time_point begin, Clock::time_point end)
+{
+    Session& session = get_session();
+    if (!session.recording.load(std::memory_order_relaxed)) return;
+    const unsigned thread_id = get_thread_id();
+    std::lock_guard<std::mutex> lock(session.mutex);
+    if (!session.recording) return;
+    session.spans.push_back({std::string(name), category, begin, end, thread_id});
+}
+
+void set_thread_name(std::string_view name)
+{
+    Session& session = get_session();
+    const unsigned thread_id = get_thread_id();
+    std::lock_guard<std::mutex> lock(session.mutex);
+    session.thread_names[thread_id] = std::string(name);
+}
+
+#else
+
+bool is_available()
+{
+    return false;
+}
+
+void start()
+{
+    throw NotImplementedError(
+        "Tracing is not compiled in, configure with ARRANGEMENT_WITH_TRACE=ON");
+}
+
+void stop(const std::string& /*filename*/)
+{
+    throw RuntimeError("Trace::stop() called without Trace::start()");
+}
+
+bool is_recording()
+{
+    return false;
+}
+
+void record_span(std::string_view /*name*/,
+    const char* /*category*/,
+    Clock::time_point /*begin*/,
+    Clock::time_point /*end*/)
+{}
+
+void set_thread_name(std::string_view /*name*/) {}
+
+#endif // ARRANGEMENT_WITH_TRACE
+
+} // namespace Trace
+} // namespace arrangement
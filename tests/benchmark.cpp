@@ -3,32 +3,32 @@
 #include <igl/write_triangle_mesh.h>
 
 #include <arrangement/Arrangement.h>
+#include <arrangement/EngineRegistry.h>
+#include <arrangement/MemoryUtils.h>
+#include <arrangement/PointLocator.h>
+#include <arrangement/PreviewArrangement.h>
+#ifdef ARRANGEMENT_IGL
+#include <arrangement/MeshArrangement.h>
+#endif
 
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
 #include <tuple>
-#include <numbers>
+#include <vector>
 
 TEST_CASE("benchmark", "[arrangement][!benchmark]")
 {
-    auto [tet_V, tet_F, tet_L] = generate_tet();
-    tet_V = tet_V.rowwise() - tet_V.colwise().mean();
-    Eigen::Vector3d axis(1, 2, 3);
-    axis.normalize();
-
     constexpr size_t N = 5;
-    arrangement::MatrixFr V(4 * N, 3);
-    arrangement::MatrixIr F(4 * N, 3);
-    arrangement::VectorI L(4 * N);
-
-    for (size_t i = 0; i < N; i++) {
-        Eigen::AngleAxisd rot(i * 2 * std::numbers::pi / N, axis);
-        V.block(4 * i, 0, 4, 3) = (rot.toRotationMatrix() * tet_V.transpose()).transpose();
-        F.block(4 * i, 0, 4, 3) = tet_F.array() + 4 * i;
-        L.segment(4 * i, 4) = tet_L;
-    }
+    arrangement::MatrixFr V;
+    arrangement::MatrixIr F;
+    arrangement::VectorI L;
+    std::tie(V, F, L) = generate_rotated_tets(N);
     //igl::write_triangle_mesh("test.obj", V, F);
     //{
     //    auto engine = arrangement::Arrangement::create_fast_arrangement(V, F, L);
@@ -63,3 +63,662 @@ TEST_CASE("benchmark", "[arrangement][!benchmark]")
     };
 #endif
 }
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("point location benchmark", "[arrangement][point_locator][!benchmark]")
+{
+    constexpr size_t N = 5;
+    arrangement::MatrixFr V;
+    arrangement::MatrixIr F;
+    arrangement::VectorI L;
+    std::tie(V, F, L) = generate_rotated_tets(N);
+    auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+    engine->run();
+
+    arrangement::PointLocator locator(*engine);
+
+    constexpr size_t num_points = 1000000;
+    const Eigen::RowVector3d bbox_min = V.colwise().minCoeff();
+    const Eigen::RowVector3d bbox_max = V.colwise().maxCoeff();
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(0, 1);
+    arrangement::MatrixFr P(num_points, 3);
+    for (size_t i = 0; i < num_points; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            P(i, j) = bbox_min[j] + dist(gen) * (bbox_max[j] - bbox_min[j]);
+        }
+    }
+
+    {
+        auto t_begin = std::chrono::high_resolution_clock::now();
+        auto winding_numbers = locator.compute_winding_numbers(P);
+        auto t_end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> query_time = t_end - t_begin;
+        std::cout << "PointLocator: " << num_points / query_time.count() << " points/s"
+                  << std::endl;
+    }
+
+    BENCHMARK("PointLocator build")
+    {
+        return arrangement::PointLocator(*engine).get_cell_winding_numbers();
+    };
+
+    BENCHMARK("PointLocator 1M winding number queries")
+    {
+        return locator.compute_winding_numbers(P);
+    };
+}
+#endif
+
+TEST_CASE("concurrent jobs benchmark", "[arrangement][threads][!benchmark]")
+{
+    constexpr size_t N = 5;
+    arrangement::MatrixFr V;
+    arrangement::MatrixIr F;
+    arrangement::VectorI L;
+    std::tie(V, F, L) = generate_rotated_tets(N);
+
+    constexpr size_t num_jobs = 4;
+    const size_t num_hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto run_jobs = [&](auto create_engine, size_t num_threads_per_job) {
+        std::vector<std::thread> jobs;
+        std::vector<size_t> num_faces(num_jobs, 0);
+        for (size_t i = 0; i < num_jobs; i++) {
+            jobs.emplace_back([&, i]() {
+                auto engine = create_engine(V, F, L);
+                engine->set_num_threads(num_threads_per_job);
+                engine->run();
+                num_faces[i] = engine->get_faces().rows();
+            });
+        }
+        for (auto& job : jobs) job.join();
+        return num_faces;
+    };
+
+#ifdef ARRANGEMENT_FAST
+    auto create_fast = [](const auto& vertices, const auto& faces, const auto& labels) {
+        return arrangement::Arrangement::create_fast_arrangement(vertices, faces, labels);
+    };
+
+    BENCHMARK("FastArrangement 4 concurrent jobs, all threads each")
+    {
+        return run_jobs(create_fast, 0);
+    };
+
+    BENCHMARK("FastArrangement 4 concurrent jobs, capped threads")
+    {
+        return run_jobs(create_fast, std::max<size_t>(1, num_hardware_threads / num_jobs));
+    };
+#endif
+
+#ifdef ARRANGEMENT_IGL
+    auto create_mesh = [](const auto& vertices, const auto& faces, const auto& labels) {
+        return arrangement::Arrangement::create_mesh_arrangement(vertices, faces, labels);
+    };
+
+    BENCHMARK("MeshArrangement 4 concurrent jobs")
+    {
+        return run_jobs(create_mesh, 1);
+    };
+#endif
+}
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("incremental update benchmark", "[arrangement][update][!benchmark]")
+{
+    // An assembly of clusters of overlapping tets, one label per tet.
+    constexpr size_t N = 5;
+    constexpr size_t num_clusters = 20;
+    arrangement::MatrixFr cluster_V;
+    arrangement::MatrixIr cluster_F;
+    arrangement::VectorI cluster_L;
+    std::tie(cluster_V, cluster_F, cluster_L) = generate_rotated_tets(N);
+
+    const size_t num_cluster_vertices = cluster_V.rows();
+    const size_t num_cluster_faces = cluster_F.rows();
+    arrangement::MatrixFr V(num_clusters * num_cluster_vertices, 3);
+    arrangement::MatrixIr F(num_clusters * num_cluster_faces, 3);
+    arrangement::VectorI L(num_clusters * num_cluster_faces);
+    for (size_t i = 0; i < num_clusters; i++) {
+        V.middleRows(i * num_cluster_vertices, num_cluster_vertices) =
+            cluster_V.rowwise() + Eigen::RowVector3d(3.0 * i, 0, 0);
+        F.middleRows(i * num_cluster_faces, num_cluster_faces) =
+            cluster_F.array() + static_cast<int>(i * num_cluster_vertices);
+    }
+    for (Eigen::Index i = 0; i < L.size(); i++) {
+        L[i] = static_cast<int>(i / 4);
+    }
+
+    // Move the first tet.
+    arrangement::MatrixFr part_V = V.topRows(4).rowwise() + Eigen::RowVector3d(0.05, 0, 0);
+    arrangement::MatrixIr part_F = F.topRows(4);
+    arrangement::VectorI part_L = L.head(4);
+    arrangement::VectorI changed(1);
+    changed << 0;
+
+    auto full_start = std::chrono::high_resolution_clock::now();
+    auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+    engine->run();
+    std::chrono::duration<double> full_time =
+        std::chrono::high_resolution_clock::now() - full_start;
+
+    auto updated = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+    updated->run();
+    auto update_start = std::chrono::high_resolution_clock::now();
+    updated->update(changed, part_V, part_F, part_L);
+    std::chrono::duration<double> update_time =
+        std::chrono::high_resolution_clock::now() - update_start;
+    std::cout << "Full run: " << full_time.count() << "s, single part update: "
+              << update_time.count() << "s" << std::endl;
+    // Only the cluster of the moved tet is resolved again.
+    REQUIRE(update_time.count() < full_time.count());
+
+    BENCHMARK("MeshArrangement full run")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->run();
+        return engine->get_num_cells();
+    };
+
+    BENCHMARK_ADVANCED("MeshArrangement single part update")(Catch::Benchmark::Chronometer meter)
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->run();
+        meter.measure([&] { engine->update(changed, part_V, part_F, part_L); });
+    };
+}
+#endif
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("intersection curves benchmark", "[arrangement][curves][!benchmark]")
+{
+    constexpr size_t N = 5;
+    arrangement::MatrixFr V;
+    arrangement::MatrixIr F;
+    arrangement::VectorI L;
+    std::tie(V, F, L) = generate_rotated_tets(N);
+
+    BENCHMARK("Intersection curves only")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        return engine->compute_intersection_curves();
+    };
+
+    BENCHMARK("MeshArrangement full run")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->run();
+        return engine->get_num_cells();
+    };
+
+#ifdef ARRANGEMENT_FAST
+    BENCHMARK("FastArrangement full run")
+    {
+        auto engine = arrangement::Arrangement::create_fast_arrangement(V, F, L);
+        engine->run();
+        return engine->get_num_cells();
+    };
+#endif
+}
+#endif
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("topology stages benchmark", "[arrangement][topology][!benchmark]")
+{
+    constexpr size_t N = 5;
+    arrangement::MatrixFr V;
+    arrangement::MatrixIr F;
+    arrangement::VectorI L;
+    std::tie(V, F, L) = generate_rotated_tets(N);
+
+    BENCHMARK("MeshArrangement resolve only")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->set_eager_stages(arrangement::TOPOLOGY_NONE);
+        engine->run();
+        return engine->get_faces().rows();
+    };
+
+    BENCHMARK("MeshArrangement patches")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->set_eager_stages(arrangement::TOPOLOGY_PATCHES);
+        engine->run();
+        return engine->get_num_patches();
+    };
+
+    BENCHMARK("MeshArrangement cells")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->set_eager_stages(arrangement::TOPOLOGY_CELLS);
+        engine->run();
+        return engine->get_num_cells();
+    };
+
+    BENCHMARK("MeshArrangement all stages")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->run();
+        return engine->get_winding_number().rows();
+    };
+}
+#endif
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("mesh kernel benchmark", "[arrangement][kernel][!benchmark]")
+{
+    for (const size_t N : {2, 5}) {
+        arrangement::MatrixFr V;
+        arrangement::MatrixIr F;
+        arrangement::VectorI L;
+        std::tie(V, F, L) = generate_rotated_tets(N);
+
+        for (const auto kernel : {arrangement::MeshKernel::Epeck,
+                 arrangement::MeshKernel::Rational,
+                 arrangement::MeshKernel::Gmpq,
+                 arrangement::MeshKernel::BoostRational,
+                 arrangement::MeshKernel::Leda}) {
+            if (!arrangement::MeshArrangement::is_kernel_available(kernel)) continue;
+            const std::string name = std::string("MeshArrangement ") +
+                                     arrangement::get_mesh_kernel_name(kernel) + " " +
+                                     std::to_string(N) + " tets";
+            BENCHMARK(name)
+            {
+                auto engine = arrangement::Arrangement::create_mesh_arrangement(
+                    V, F, L, arrangement::RegionOfInterest(), kernel);
+                engine->run();
+                return engine->get_num_cells();
+            };
+        }
+    }
+}
+#endif
+
+#ifdef ARRANGEMENT_FAST
+TEST_CASE("quantized input benchmark", "[arrangement][quantization][!benchmark]")
+{
+    // CAD-like input: every coordinate lives on a fixed-point grid.
+    constexpr double grid_size = 1.0 / 1024;
+    for (const size_t N : {5, 10}) {
+        arrangement::MatrixFr V;
+        arrangement::MatrixIr F;
+        arrangement::VectorI L;
+        std::tie(V, F, L) = generate_rotated_tets(N);
+        V = ((V / grid_size).array().round() * grid_size).matrix();
+
+        BENCHMARK("FastArrangement " + std::to_string(N) + " tets")
+        {
+            auto engine = arrangement::Arrangement::create_fast_arrangement(V, F, L);
+            engine->run();
+            return engine->get_num_cells();
+        };
+
+        BENCHMARK("FastArrangement quantized " + std::to_string(N) + " tets")
+        {
+            auto engine = arrangement::Arrangement::create_fast_arrangement(V, F, L);
+            engine->set_quantization(true, grid_size);
+            engine->run();
+            return engine->get_num_cells();
+        };
+    }
+}
+#endif
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("output sink benchmark", "[arrangement][sink][!benchmark]")
+{
+    // Peak RSS of keeping the output vs. streaming it to a sink that drops
+    // the chunks.  Each run starts from a reset peak, which requires Linux.
+    struct DiscardingSink : public arrangement::OutputSink
+    {
+        void write_vertices(
+            size_t, const arrangement::MatrixFr&, const std::vector<std::string>&) override
+        {}
+        void write_faces(size_t,
+            const arrangement::MatrixIr&,
+            const arrangement::VectorI&,
+            const arrangement::VectorI&) override
+        {}
+    };
+
+    constexpr size_t N = 20;
+    arrangement::MatrixFr V;
+    arrangement::MatrixIr F;
+    arrangement::VectorI L;
+    std::tie(V, F, L) = generate_rotated_tets(N);
+
+    auto measure = [&](auto create_engine, bool streaming) {
+        const bool reset = arrangement::MemoryUtils::reset_peak_rss();
+        const size_t rss_before = arrangement::MemoryUtils::get_current_rss();
+        DiscardingSink sink;
+        {
+            auto engine = create_engine(V, F, L);
+            if (streaming) engine->set_output_sink(&sink);
+            engine->run();
+        }
+        const size_t peak = arrangement::MemoryUtils::get_peak_rss();
+        return reset ? static_cast<double>(peak - std::min(peak, rss_before)) / (1 << 20) : -1.0;
+    };
+
+    auto report = [&](const std::string& name, auto create_engine) {
+        const double in_memory = measure(create_engine, false);
+        const double streaming = measure(create_engine, true);
+        std::cout << name << " peak RSS increase (MB), in memory: " << in_memory
+                  << ", streaming: " << streaming << std::endl;
+    };
+
+    report("MeshArrangement", [](const auto& vertices, const auto& faces, const auto& labels) {
+        return arrangement::Arrangement::create_mesh_arrangement(vertices, faces, labels);
+    });
+#ifdef ARRANGEMENT_FAST
+    report("FastArrangement", [](const auto& vertices, const auto& faces, const auto& labels) {
+        return arrangement::Arrangement::create_fast_arrangement(vertices, faces, labels);
+    });
+#endif
+}
+#endif
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("coplanar merge benchmark", "[arrangement][merge][!benchmark]")
+{
+    constexpr size_t N = 5;
+    arrangement::MatrixFr V;
+    arrangement::MatrixIr F;
+    arrangement::VectorI L;
+    std::tie(V, F, L) = generate_rotated_tets(N);
+
+    auto report = [](const std::string& name, const arrangement::Arrangement& engine) {
+        const auto& metrics = engine.get_metrics();
+        std::cout << name << " faces: " << metrics.values.at("merge_coplanar.num_input_faces")
+                  << " -> " << metrics.values.at("merge_coplanar.num_output_faces") << " in "
+                  << metrics.timings.at("merge_coplanar") << "s" << std::endl;
+    };
+
+#ifdef ARRANGEMENT_FAST
+    {
+        auto engine = arrangement::Arrangement::create_fast_arrangement(V, F, L);
+        engine->set_merge_coplanar(true);
+        engine->run();
+        report("FastArrangement", *engine);
+    }
+
+    BENCHMARK("FastArrangement merge coplanar")
+    {
+        auto engine = arrangement::Arrangement::create_fast_arrangement(V, F, L);
+        engine->set_merge_coplanar(true);
+        engine->run();
+        return engine->get_faces().rows();
+    };
+#endif
+
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->set_merge_coplanar(true);
+        engine->run();
+        report("MeshArrangement", *engine);
+    }
+
+    BENCHMARK("MeshArrangement merge coplanar")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->set_merge_coplanar(true);
+        engine->run();
+        return engine->get_faces().rows();
+    };
+}
+#endif
+
+TEST_CASE("many small jobs benchmark", "[arrangement][reset][!benchmark]")
+{
+    // Batch of small jobs: a new engine per job vs. one engine reset between
+    // jobs, which keeps its buffers.
+    constexpr size_t num_jobs = 100;
+    std::vector<std::tuple<arrangement::MatrixFr, arrangement::MatrixIr, arrangement::VectorI>>
+        jobs;
+    for (size_t i = 0; i < num_jobs; i++) {
+        auto [V, F, L] = generate_rotated_tets(2 + i % 3);
+        V.array() += static_cast<double>(i);
+        jobs.emplace_back(V, F, L);
+    }
+
+    auto run_fresh = [&](auto create_engine, bool merge_coplanar) {
+        size_t num_faces = 0;
+        for (const auto& [V, F, L] : jobs) {
+            auto engine = create_engine(V, F, L);
+            engine->set_merge_coplanar(merge_coplanar);
+            engine->run();
+            num_faces += engine->get_faces().rows();
+        }
+        return num_faces;
+    };
+
+    auto run_reused = [&](auto create_engine, bool merge_coplanar, bool run_arena) {
+        size_t num_faces = 0;
+        const auto& [V0, F0, L0] = jobs.front();
+        auto engine = create_engine(V0, F0, L0);
+        engine->set_merge_coplanar(merge_coplanar);
+        engine->set_run_arena(run_arena);
+        for (const auto& [V, F, L] : jobs) {
+            engine->reset(V, F, L);
+            engine->run();
+            num_faces += engine->get_faces().rows();
+        }
+        return num_faces;
+    };
+
+#ifdef ARRANGEMENT_FAST
+    auto create_fast = [](const auto& vertices, const auto& faces, const auto& labels) {
+        return arrangement::Arrangement::create_fast_arrangement(vertices, faces, labels);
+    };
+
+    BENCHMARK("FastArrangement new engine per job")
+    {
+        return run_fresh(create_fast, false);
+    };
+
+    BENCHMARK("FastArrangement reset between jobs")
+    {
+        return run_reused(create_fast, false, false);
+    };
+
+    BENCHMARK("FastArrangement merge coplanar, new engine per job")
+    {
+        return run_fresh(create_fast, true);
+    };
+
+    BENCHMARK("FastArrangement merge coplanar, reset between jobs, run arena")
+    {
+        return run_reused(create_fast, true, true);
+    };
+#endif
+
+#ifdef ARRANGEMENT_IGL
+    auto create_mesh = [](const auto& vertices, const auto& faces, const auto& labels) {
+        return arrangement::Arrangement::create_mesh_arrangement(vertices, faces, labels);
+    };
+
+    BENCHMARK("MeshArrangement merge coplanar, new engine per job")
+    {
+        return run_fresh(create_mesh, true);
+    };
+
+    BENCHMARK("MeshArrangement merge coplanar, reset between jobs")
+    {
+        return run_reused(create_mesh, true, false);
+    };
+
+    BENCHMARK("MeshArrangement merge coplanar, reset between jobs, run arena")
+    {
+        return run_reused(create_mesh, true, true);
+    };
+#endif
+}
+
+TEST_CASE("stage memory benchmark", "[arrangement][memory][!benchmark]")
+{
+    // Time and memory of each stage, as recorded in the metrics.  Allocations
+    // are only counted with ARRANGEMENT_WITH_MEMORY_STATS.
+    if (!arrangement::MemoryUtils::is_allocation_counting_enabled()) {
+        SKIP("Configure with ARRANGEMENT_WITH_MEMORY_STATS=ON to count allocations");
+    }
+
+    constexpr size_t N = 5;
+    arrangement::MatrixFr V;
+    arrangement::MatrixIr F;
+    arrangement::VectorI L;
+    std::tie(V, F, L) = generate_rotated_tets(N);
+
+    auto report = [&](const std::string& name, auto create_engine) {
+        auto engine = create_engine(V, F, L);
+        engine->run();
+        const auto& metrics = engine->get_metrics();
+        for (const auto& [stage, time] : metrics.timings) {
+            std::cout << name << " " << stage << ": " << time << " s";
+            auto itr = metrics.memory.find(stage);
+            if (itr != metrics.memory.end()) {
+                const auto& memory = itr->second;
+                std::cout << ", peak RSS increase "
+                          << static_cast<double>(memory.peak_rss_delta) / (1 << 20) << " MB, "
+                          << memory.num_allocations << " allocations, "
+                          << static_cast<double>(memory.allocated_bytes) / (1 << 20) << " MB";
+            }
+            std::cout << std::endl;
+        }
+    };
+
+#ifdef ARRANGEMENT_FAST
+    report("FastArrangement", [](const auto& vertices, const auto& faces, const auto& labels) {
+        return arrangement::Arrangement::create_fast_arrangement(vertices, faces, labels);
+    });
+#endif
+#ifdef ARRANGEMENT_IGL
+    report("MeshArrangement", [](const auto& vertices, const auto& faces, const auto& labels) {
+        return arrangement::Arrangement::create_mesh_arrangement(vertices, faces, labels);
+    });
+#endif
+#ifdef ARRANGEMENT_GEOGRAM
+    report("Geogram", [](const auto& vertices, const auto& faces, const auto& labels) {
+        return arrangement::Arrangement::create_geogram_arrangement(vertices, faces, labels);
+    });
+#endif
+}
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("planar benchmark", "[arrangement][planar][!benchmark]")
+{
+    // One sheet of overlapping triangles, and 8 layers of them.
+    for (const size_t num_layers : {size_t(1), size_t(8)}) {
+        arrangement::MatrixFr V;
+        arrangement::MatrixIr F;
+        arrangement::VectorI L;
+        std::tie(V, F, L) = generate_planar_layers(num_layers, 400 / num_layers);
+        const std::string suffix = " (" + std::to_string(num_layers) + " layers)";
+
+        BENCHMARK("PlanarArrangement" + suffix)
+        {
+            auto engine = arrangement::Arrangement::create_planar_arrangement(V, F, L);
+            engine->run();
+            return engine->get_num_cells();
+        };
+
+        BENCHMARK("MeshArrangement" + suffix)
+        {
+            auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+            engine->run();
+            return engine->get_num_cells();
+        };
+
+#ifdef ARRANGEMENT_FAST
+        BENCHMARK("FastArrangement" + suffix)
+        {
+            auto engine = arrangement::Arrangement::create_fast_arrangement(V, F, L);
+            engine->run();
+            return engine->get_num_cells();
+        };
+#endif
+    }
+}
+#endif
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("parts benchmark", "[arrangement][parts][!benchmark]")
+{
+    // An assembly of instances of one mesh: concatenating the transformed
+    // instances before creating the engine, versus passing them as parts.
+    const size_t N = 200;
+    arrangement::MatrixFr tet_V;
+    arrangement::MatrixIr tet_F;
+    arrangement::VectorI tet_L;
+    std::tie(tet_V, tet_F, tet_L) = generate_tet();
+    arrangement::Part tet;
+    tet.vertices = std::make_shared<const arrangement::MatrixFr>(tet_V);
+    tet.faces = std::make_shared<const arrangement::MatrixIr>(tet_F);
+    tet.face_labels = std::make_shared<const arrangement::VectorI>(tet_L);
+    std::vector<arrangement::Part> parts(N, tet);
+    for (size_t i = 0; i < N; i++) {
+        parts[i].transform = Eigen::Translation3d(0.5 * i, 0, 0) *
+                             Eigen::AngleAxisd(0.1 * i, Eigen::Vector3d::UnitZ());
+    }
+
+    BENCHMARK("concatenate")
+    {
+        arrangement::MatrixFr V(4 * N, 3);
+        arrangement::MatrixIr F(4 * N, 3);
+        arrangement::VectorI L(4 * N);
+        for (size_t i = 0; i < N; i++) {
+            const auto& transform = parts[i].transform;
+            V.middleRows(4 * i, 4) = (tet_V * transform.linear().transpose()).rowwise() +
+                                     transform.translation().transpose();
+            F.middleRows(4 * i, 4) = tet_F.array() + static_cast<int>(4 * i);
+            L.segment(4 * i, 4) = tet_L;
+        }
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->run();
+        return engine->get_num_cells();
+    };
+
+    BENCHMARK("parts")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(parts);
+        engine->run();
+        return engine->get_num_cells();
+    };
+}
+#endif
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("preview benchmark", "[arrangement][preview][!benchmark]")
+{
+    // Time to first result: a full run() versus a preview on the first proxy
+    // level, and on as many levels as fit in 100ms.
+    arrangement::MatrixFr V;
+    arrangement::MatrixIr F;
+    arrangement::VectorI L;
+    std::tie(V, F, L) = generate_spheres(8, 64);
+
+    std::vector<std::string> engines = {"mesh"};
+#ifdef ARRANGEMENT_FAST
+    engines.push_back("fast");
+#endif
+    for (const auto& name : engines) {
+        BENCHMARK("full " + name)
+        {
+            auto engine = arrangement::EngineRegistry::create(name, V, F, L);
+            engine->run();
+            return engine->get_num_cells();
+        };
+
+        for (const int budget : {0, 100}) {
+            BENCHMARK("preview " + name + " (budget " + std::to_string(budget) + "ms)")
+            {
+                arrangement::PreviewArrangement engine(V, F, L);
+                engine.set_engine(name);
+                engine.set_time_budget(budget / 1000.0);
+                engine.run();
+                return engine.get_num_cells();
+            };
+        }
+    }
+}
+#endif
@@ -1,12 +1,27 @@
 #include "utils.h"
 
 #include <arrangement/Arrangement.h>
+#include <arrangement/AutoArrangement.h>
+#include <arrangement/EngineRegistry.h>
+#include <arrangement/Exception.h>
+#include <arrangement/MeshArrangement.h>
+#include <arrangement/PlanarArrangement.h>
+#include <arrangement/PreviewArrangement.h>
+#include <arrangement/Trace.h>
 
 #include <igl/write_triangle_mesh.h>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
 #include <tuple>
 
 auto concatenate_mesh(const arrangement::MatrixFr& V1,
@@ -22,6 +37,77 @@ auto concatenate_mesh(const arrangement::MatrixFr& V1,
     return std::make_tuple(V, F, L);
 }
 
+/**
+ * Whether the faces with `label` form closed, edge-manifold and consistently
+ * oriented surfaces: each directed edge is used once, and so is its opposite.
+ */
+bool is_closed_manifold(const arrangement::MatrixIr& faces,
+    const arrangement::VectorI& face_labels,
+    int label)
+{
+    std::map<std::pair<arrangement::Index, arrangement::Index>, int> edges;
+    for (Eigen::Index i = 0; i < faces.rows(); i++) {
+        if (face_labels[i] != label) continue;
+        for (Eigen::Index k = 0; k < 3; k++) edges[{faces(i, k), faces(i, (k + 1) % 3)}]++;
+    }
+    for (const auto& [edge, count] : edges) {
+        auto opposite = edges.find({edge.second, edge.first});
+        if (count != 1 || opposite == edges.end() || opposite->second != 1) return false;
+    }
+    return !edges.empty();
+}
+
+/**
+ * Output sink reassembling the streamed chunks.
+ */
+class CollectingSink : public arrangement::OutputSink
+{
+public:
+    size_t get_chunk_size() const override { return 5; }
+
+    void begin(size_t num_vertices, size_t num_faces) override
+    {
+        vertices.resize(num_vertices, 3);
+        faces.resize(num_faces, 3);
+        face_labels.resize(num_faces);
+        patches.resize(num_faces);
+    }
+
+    void write_vertices(size_t offset,
+        const arrangement::MatrixFr& chunk,
+        const std::vector<std::string>& exact_chunk) override
+    {
+        vertices.middleRows(offset, chunk.rows()) = chunk;
+        exact_vertices.insert(exact_vertices.end(), exact_chunk.begin(), exact_chunk.end());
+        num_chunks++;
+    }
+
+    void write_faces(size_t offset,
+        const arrangement::MatrixIr& chunk,
+        const arrangement::VectorI& chunk_labels,
+        const arrangement::VectorI& chunk_patches) override
+    {
+        faces.middleRows(offset, chunk.rows()) = chunk;
+        face_labels.segment(offset, chunk.rows()) = chunk_labels;
+        if (chunk_patches.size() > 0) patches.segment(offset, chunk.rows()) = chunk_patches;
+        num_chunks++;
+    }
+
+    void write_cells(const arrangement::MatrixIr& c) override { cells = c; }
+    void write_winding_numbers(const arrangement::MatrixIr& w) override { winding_number = w; }
+    void end() override { ended = true; }
+
+    arrangement::MatrixFr vertices;
+    arrangement::MatrixIr faces;
+    arrangement::VectorI face_labels;
+    arrangement::VectorI patches;
+    arrangement::MatrixIr cells;
+    arrangement::MatrixIr winding_number;
+    std::vector<std::string> exact_vertices;
+    size_t num_chunks = 0;
+    bool ended = false;
+};
+
 #ifdef ARRANGEMENT_FAST
 TEST_CASE("FastArrangement", "[arrangement]")
 {
@@ -130,6 +216,138 @@ TEST_CASE("FastArrangement", "[arrangement]")
         REQUIRE(vertices.rows() == 9);
         REQUIRE(faces.rows() == 13);
     }
+
+    SECTION("Quantized input")
+    {
+        arrangement::MatrixFr V2(3, 3);
+        // clang-format off
+        V2 <<
+            0, 0, 0.5,
+            1, 0, 0.5,
+            0, 1, 0.5;
+        // clang-format on
+
+        arrangement::MatrixIr F2(1, 3);
+        F2 << 0, 1, 2;
+
+        arrangement::VectorI L2(1);
+        L2 << 4;
+
+        auto [V3, F3, L3] = concatenate_mesh(V, F, L, V2, F2, L2);
+
+        // Perturbations below half the grid spacing are snapped away.
+        const double grid_size = 1.0 / 64;
+        V3.array() += grid_size / 8;
+
+        auto engine = arrangement::Arrangement::create_fast_arrangement(V3, F3, L3);
+        engine->set_quantization(true, grid_size);
+        engine->run();
+
+        REQUIRE(engine->get_num_cells() == 2 + 1);
+        REQUIRE(engine->get_num_patches() == 4);
+        REQUIRE(engine->get_vertices().rows() == 9);
+        REQUIRE(engine->get_faces().rows() == 13);
+
+        const auto& metrics = engine->get_metrics();
+        REQUIRE(metrics.values.at("quantization_grid_size") == grid_size);
+        REQUIRE(metrics.values.at("num_collapsed_faces") == 0);
+        REQUIRE(metrics.values.at("num_integer_points") +
+                    metrics.values.at("num_fallback_points") ==
+                engine->get_vertices().rows() - V3.rows());
+#ifdef __SIZEOF_INT128__
+        // The grid is coarse enough for every intersection to fit in integers.
+        REQUIRE(metrics.values.at("num_integer_points") > 0);
+#endif
+
+        // Automatic grid.
+        auto engine2 = arrangement::Arrangement::create_fast_arrangement(V3, F3, L3);
+        engine2->set_quantization(true);
+        engine2->run();
+        REQUIRE(engine2->get_num_cells() == 2 + 1);
+        REQUIRE(engine2->get_metrics().values.at("quantization_bits") <= 26);
+
+        // Three crossing planes meet at a 3-plane intersection, which the
+        // automatic grid keeps within integer range.
+        arrangement::MatrixFr V4(9, 3);
+        // clang-format off
+        V4 <<
+            -1, -1, 0.5,
+            2, -1, 0.5,
+            -1, 2, 0.5,
+            0.25, -1, -1,
+            0.25, 2, -1,
+            0.25, -1, 2,
+            -1, 0.25, -1,
+            2, 0.25, -1,
+            -1, 0.25, 2;
+        // clang-format on
+        arrangement::MatrixIr F4(3, 3);
+        F4 << 0, 1, 2, 3, 4, 5, 6, 7, 8;
+        arrangement::VectorI L4(3);
+        L4 << 0, 1, 2;
+        auto engine5 = arrangement::Arrangement::create_fast_arrangement(V4, F4, L4);
+        engine5->set_quantization(true);
+        engine5->run();
+#ifdef __SIZEOF_INT128__
+        const auto& metrics5 = engine5->get_metrics();
+        REQUIRE(metrics5.values.at("num_integer_tpi_points") == 1);
+        REQUIRE(metrics5.values.at("num_fallback_points") == 0);
+#endif
+
+        auto engine3 = arrangement::Arrangement::create_mesh_arrangement(V3, F3, L3);
+        engine3->set_quantization(true, grid_size);
+        REQUIRE_THROWS_AS(engine3->run(), arrangement::NotImplementedError);
+
+        // Snap rounding is not applied on top of quantization.
+        auto engine4 = arrangement::Arrangement::create_fast_arrangement(V3, F3, L3);
+        engine4->set_quantization(true, grid_size);
+        engine4->set_snap_rounding(true, grid_size);
+        REQUIRE_THROWS_AS(engine4->run(), arrangement::NotImplementedError);
+    }
+
+    SECTION("Reset")
+    {
+        arrangement::MatrixFr V2(3, 3);
+        // clang-format off
+        V2 <<
+            0, 0, 0.5,
+            1, 0, 0.5,
+            0, 1, 0.5;
+        // clang-format on
+
+        arrangement::MatrixIr F2(1, 3);
+        F2 << 0, 1, 2;
+
+        arrangement::VectorI L2(1);
+        L2 << 4;
+
+        auto [V3, F3, L3] = concatenate_mesh(V, F, L, V2, F2, L2);
+
+        auto reference = arrangement::Arrangement::create_fast_arrangement(V3, F3, L3);
+        reference->run();
+
+        auto engine = arrangement::Arrangement::create_fast_arrangement(V, F, L);
+        engine->set_eager_stages(arrangement::TOPOLOGY_ALL);
+        engine->run();
+        REQUIRE(engine->get_faces().rows() == 4);
+
+        engine->reset(V3, F3, L3);
+        REQUIRE(engine->get_faces() == F3);
+        REQUIRE(engine->get_metrics().values.empty());
+        REQUIRE(engine->get_eager_stages() == arrangement::TOPOLOGY_ALL);
+        engine->run();
+        REQUIRE(engine->get_vertices() == reference->get_vertices());
+        REQUIRE(engine->get_faces() == reference->get_faces());
+        REQUIRE(engine->get_num_cells() == 2 + 1);
+        REQUIRE(engine->get_num_patches() == 4);
+
+        // Back to a smaller input.
+        engine->reset(V, F, L);
+        engine->run();
+        REQUIRE(engine->get_vertices().rows() == 4);
+        REQUIRE(engine->get_faces().rows() == 4);
+        REQUIRE(engine->get_num_cells() == 1 + 1);
+    }
 }
 #endif // ARRANGEMENT_FAST
 
@@ -154,6 +372,19 @@ TEST_CASE("MeshArrangement", "[arrangement]")
         REQUIRE(faces.rows() == 4);
     }
 
+    SECTION("Single precision input")
+    {
+        const arrangement::MatrixF32r V32 = V.cast<float>();
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V32, F, L);
+        engine->run();
+
+        REQUIRE(engine->get_vertices() == V);
+        REQUIRE(engine->get_num_cells() == 1 + 1);
+
+        const arrangement::MatrixU32r faces = engine->get_faces_u32();
+        REQUIRE(faces.cast<arrangement::Index>() == engine->get_faces());
+    }
+
     SECTION("Disjoint tets")
     {
         auto V2 = (V.array() + 10).matrix().eval();
@@ -208,6 +439,539 @@ TEST_CASE("MeshArrangement", "[arrangement]")
         REQUIRE(vertices.rows() == 4);
         REQUIRE(faces.rows() == 6);
     }
+
+    SECTION("Exact round trip")
+    {
+        arrangement::MatrixFr V2(3, 3);
+        // clang-format off
+        V2 <<
+            0, 0, 1.0 / 3,
+            1, 0, 1.0 / 3,
+            0, 1, 1.0 / 3;
+        // clang-format on
+
+        arrangement::MatrixIr F2(1, 3);
+        F2 << 0, 1, 2;
+
+        arrangement::VectorI L2(1);
+        L2 << 4;
+
+        auto [V3, F3, L3] = concatenate_mesh(V, F, L, V2, F2, L2);
+
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V3, F3, L3);
+        engine->set_exact_output(true);
+        engine->run();
+
+        const auto& exact_vertices = engine->get_exact_vertices();
+        REQUIRE(exact_vertices.size() == engine->get_vertices().size());
+
+        // Feed the exact result back as already resolved input.
+        auto engine2 = arrangement::Arrangement::create_mesh_arrangement(
+            engine->get_vertices(), engine->get_faces(), engine->get_out_face_labels());
+        engine2->set_exact_vertices(exact_vertices);
+        engine2->set_input_resolved(true);
+        engine2->set_exact_output(true);
+        engine2->run();
+
+        REQUIRE(engine2->get_faces() == engine->get_faces());
+        REQUIRE(engine2->get_exact_vertices() == exact_vertices);
+        REQUIRE(engine2->get_num_cells() == engine->get_num_cells());
+        REQUIRE(engine2->get_num_patches() == engine->get_num_patches());
+
+        // Re-resolving exact input does not introduce new vertices.
+        auto engine3 = arrangement::Arrangement::create_mesh_arrangement(
+            engine->get_vertices(), engine->get_faces(), engine->get_out_face_labels());
+        engine3->set_exact_vertices(exact_vertices);
+        engine3->run();
+        REQUIRE(engine3->get_vertices().rows() == engine->get_vertices().rows());
+        REQUIRE(engine3->get_faces().rows() == engine->get_faces().rows());
+    }
+
+    SECTION("Invalid exact coordinates")
+    {
+        for (const std::string bad : {"1/0", "1/", "", "1.5", "12a", "-", "1/-0", "1/2/3"}) {
+            auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+            std::vector<std::string> coordinates(V.size(), "0");
+            coordinates[1] = bad;
+            engine->set_exact_vertices(coordinates);
+            REQUIRE_THROWS_AS(engine->run(), arrangement::RuntimeError);
+        }
+
+        // Signs are accepted on both sides.
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        std::vector<std::string> coordinates;
+        for (Eigen::Index i = 0; i < V.size(); i++) {
+            coordinates.push_back(std::to_string(static_cast<int>(V.data()[i] * 2)) + "/2");
+        }
+        coordinates[0] = "+0/-3";
+        engine->set_exact_vertices(coordinates);
+        REQUIRE_NOTHROW(engine->run());
+    }
+
+    SECTION("Snap rounding")
+    {
+        arrangement::MatrixFr V2(3, 3);
+        // clang-format off
+        V2 <<
+            -1, -1, 1.0 / 3,
+             2, -1, 1.0 / 3,
+            -1,  2, 1.0 / 3;
+        // clang-format on
+
+        arrangement::MatrixIr F2(1, 3);
+        F2 << 0, 1, 2;
+
+        arrangement::VectorI L2(1);
+        L2 << 4;
+
+        auto [V3, F3, L3] = concatenate_mesh(V, F, L, V2, F2, L2);
+
+        const double grid_size = 1.0 / 64;
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V3, F3, L3);
+        engine->set_snap_rounding(true, grid_size);
+        engine->run();
+
+        const auto& vertices = engine->get_vertices();
+        const auto& faces = engine->get_faces();
+        REQUIRE(vertices.rows() > 0);
+        REQUIRE(((vertices / grid_size).array().round() * grid_size == vertices.array()).all());
+        REQUIRE(engine->get_out_face_labels().size() == faces.rows());
+
+        // The snapped output is intersection-free: resolving it again is a no-op.
+        auto engine2 = arrangement::Arrangement::create_mesh_arrangement(
+            vertices, faces, engine->get_out_face_labels());
+        engine2->run();
+        REQUIRE(engine2->get_faces().rows() == faces.rows());
+        REQUIRE(engine2->get_vertices().rows() == vertices.rows());
+    }
+
+    SECTION("Snap rounding keeps surfaces closed")
+    {
+        // Two closed tets whose intersection segments end on shared edges of
+        // both.  Rounding the intersection points to a coarse grid makes faces
+        // intersect again, and the repair must split the kept neighbours of
+        // the re-resolved faces instead of leaving T-junctions.
+        arrangement::MatrixFr V2 = V * 0.8;
+        V2.rowwise() += Eigen::RowVector3d(0.13, 0.21, 0.17);
+        arrangement::VectorI L1 = arrangement::VectorI::Zero(F.rows());
+        arrangement::VectorI L2 = arrangement::VectorI::Ones(F.rows());
+        auto [V3, F3, L3] = concatenate_mesh(V, F, L1, V2, F, L2);
+
+        for (const double grid_size : {1.0 / 16, 1.0 / 32}) {
+            auto engine = arrangement::Arrangement::create_mesh_arrangement(V3, F3, L3);
+            engine->set_snap_rounding(true, grid_size);
+            engine->run();
+
+            const auto& faces = engine->get_faces();
+            const auto& labels = engine->get_out_face_labels();
+            REQUIRE(is_closed_manifold(faces, labels, 0));
+            REQUIRE(is_closed_manifold(faces, labels, 1));
+        }
+    }
+
+    SECTION("Snap rounding splits around collapsed faces")
+    {
+        // Unit cube whose bottom side is a fan around a vertex just off its
+        // front edge.  Rounding moves the vertex onto the edge, collapsing the
+        // sliver between it and the edge: the front side must be split there.
+        arrangement::MatrixFr V2(9, 3);
+        // clang-format off
+        V2 <<
+            0, 0, 0,
+            1, 0, 0,
+            1, 1, 0,
+            0, 1, 0,
+            0, 0, 1,
+            1, 0, 1,
+            1, 1, 1,
+            0, 1, 1,
+            0.5, 0.01, 0;
+        arrangement::MatrixIr F2(14, 3);
+        F2 <<
+            8, 0, 3,
+            8, 3, 2,
+            8, 2, 1,
+            8, 1, 0,
+            4, 5, 6,
+            4, 6, 7,
+            0, 1, 5,
+            0, 5, 4,
+            1, 2, 6,
+            1, 6, 5,
+            2, 3, 7,
+            2, 7, 6,
+            3, 0, 4,
+            3, 4, 7;
+        // clang-format on
+        arrangement::VectorI L2 = arrangement::VectorI::Zero(14);
+
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V2, F2, L2);
+        engine->set_snap_rounding(true, 1.0 / 16);
+        engine->run();
+        REQUIRE(engine->get_faces().rows() == 14);
+        REQUIRE(is_closed_manifold(engine->get_faces(), engine->get_out_face_labels(), 0));
+    }
+
+    SECTION("Kernels")
+    {
+        auto [V2, F2, L2] = generate_rotated_tets(2);
+        auto reference = arrangement::Arrangement::create_mesh_arrangement(V2, F2, L2);
+        reference->run();
+
+        for (const auto kernel : {arrangement::MeshKernel::Rational,
+                 arrangement::MeshKernel::Gmpq,
+                 arrangement::MeshKernel::BoostRational,
+                 arrangement::MeshKernel::Leda}) {
+            if (!arrangement::MeshArrangement::is_kernel_available(kernel)) {
+                REQUIRE_THROWS_AS(arrangement::Arrangement::create_mesh_arrangement(
+                                      V2, F2, L2, arrangement::RegionOfInterest(), kernel),
+                    arrangement::NotImplementedError);
+                continue;
+            }
+            auto engine = arrangement::Arrangement::create_mesh_arrangement(
+                V2, F2, L2, arrangement::RegionOfInterest(), kernel);
+            engine->run();
+            // Rounding of the exact coordinates may differ in the last bit.
+            REQUIRE(engine->get_vertices().rows() == reference->get_vertices().rows());
+            REQUIRE((engine->get_vertices() - reference->get_vertices()).cwiseAbs().maxCoeff() <
+                    1e-12);
+            REQUIRE(engine->get_faces() == reference->get_faces());
+            REQUIRE(engine->get_cells() == reference->get_cells());
+            REQUIRE(engine->get_winding_number() == reference->get_winding_number());
+        }
+    }
+
+    SECTION("Lazy topology")
+    {
+        auto eager = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        eager->run();
+
+        auto lazy = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        lazy->set_eager_stages(arrangement::TOPOLOGY_NONE);
+        lazy->run();
+        REQUIRE(lazy->get_computed_stages() == arrangement::TOPOLOGY_NONE);
+        REQUIRE(lazy->get_faces() == eager->get_faces());
+
+        // Cells pull in patches, but not winding numbers.
+        REQUIRE(lazy->get_cells() == eager->get_cells());
+        REQUIRE(lazy->get_computed_stages() ==
+                (arrangement::TOPOLOGY_PATCHES | arrangement::TOPOLOGY_CELLS));
+        REQUIRE(lazy->get_patches() == eager->get_patches());
+
+        REQUIRE(lazy->get_winding_number() == eager->get_winding_number());
+        REQUIRE(lazy->get_computed_stages() == arrangement::TOPOLOGY_ALL);
+    }
+
+    SECTION("Merge coplanar")
+    {
+        // Unit cube whose top side is a fan around its center.
+        arrangement::MatrixFr V2(9, 3);
+        // clang-format off
+        V2 <<
+            0, 0, 0,
+            1, 0, 0,
+            1, 1, 0,
+            0, 1, 0,
+            0, 0, 1,
+            1, 0, 1,
+            1, 1, 1,
+            0, 1, 1,
+            0.5, 0.5, 1;
+        arrangement::MatrixIr F2(14, 3);
+        F2 <<
+            0, 2, 1,
+            0, 3, 2,
+            4, 5, 8,
+            5, 6, 8,
+            6, 7, 8,
+            7, 4, 8,
+            0, 1, 5,
+            0, 5, 4,
+            1, 2, 6,
+            1, 6, 5,
+            2, 3, 7,
+            2, 7, 6,
+            3, 0, 4,
+            3, 4, 7;
+        // clang-format on
+        arrangement::VectorI L2 = arrangement::VectorI::Zero(14);
+
+        auto reference = arrangement::Arrangement::create_mesh_arrangement(V2, F2, L2);
+        reference->run();
+        REQUIRE(reference->get_faces().rows() == 14);
+
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V2, F2, L2);
+        engine->set_merge_coplanar(true);
+        engine->run();
+
+        // The fan collapses to 2 triangles, the other sides are minimal already.
+        REQUIRE(engine->get_faces().rows() == 12);
+        REQUIRE(engine->get_vertices().rows() == 8);
+        REQUIRE(engine->get_out_face_labels().size() == 12);
+        REQUIRE(engine->get_num_patches() == reference->get_num_patches());
+        REQUIRE(engine->get_num_cells() == reference->get_num_cells());
+        REQUIRE(engine->get_winding_number() == reference->get_winding_number());
+
+        const auto& metrics = engine->get_metrics();
+        REQUIRE(metrics.values.at("merge_coplanar.num_input_faces") == 14);
+        REQUIRE(metrics.values.at("merge_coplanar.num_output_faces") == 12);
+        REQUIRE(metrics.values.at("merge_coplanar.num_regions") == 1);
+        REQUIRE(metrics.values.at("merge_coplanar.num_removed_vertices") == 1);
+        REQUIRE(metrics.timings.count("merge_coplanar") == 1);
+
+        // Same result from a reused engine with its temporaries in an arena.
+        auto reused = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        reused->set_merge_coplanar(true);
+        reused->set_run_arena(true);
+        reused->run();
+        const double arena_bytes = reused->get_metrics().values.at("run_arena_bytes");
+        REQUIRE(arena_bytes > 0);
+
+        reused->reset(V2, F2, L2);
+        REQUIRE_THROWS_AS(reused->update(arrangement::VectorI::Zero(1), V2, F2, L2),
+            arrangement::RuntimeError);
+        reused->run();
+        REQUIRE(reused->get_vertices() == engine->get_vertices());
+        REQUIRE(reused->get_faces() == engine->get_faces());
+        REQUIRE(reused->get_winding_number() == engine->get_winding_number());
+        REQUIRE(reused->get_metrics().values.at("run_arena_bytes") >= arena_bytes);
+    }
+
+    SECTION("Merge coplanar with coincident faces")
+    {
+        // Two overlapping squares in the plane z = 0, each a fan around its
+        // center, with different labels.
+        arrangement::MatrixFr V2(10, 3);
+        // clang-format off
+        V2 <<
+            0, 0, 0,
+            2, 0, 0,
+            2, 2, 0,
+            0, 2, 0,
+            1, 1, 0,
+            1, 1, 0,
+            3, 1, 0,
+            3, 3, 0,
+            1, 3, 0,
+            2, 2, 0;
+        arrangement::MatrixIr F2(8, 3);
+        F2 <<
+            0, 1, 4,
+            1, 2, 4,
+            2, 3, 4,
+            3, 0, 4,
+            5, 6, 9,
+            6, 7, 9,
+            7, 8, 9,
+            8, 5, 9;
+        // clang-format on
+        arrangement::VectorI L2(8);
+        L2 << 0, 0, 0, 0, 1, 1, 1, 1;
+
+        for (const bool flip : {false, true}) {
+            // The second square also faces the other way.
+            if (flip) {
+                for (arrangement::Index i = 4; i < 8; i++) std::swap(F2(i, 1), F2(i, 2));
+            }
+
+            auto engine = arrangement::Arrangement::create_mesh_arrangement(V2, F2, L2);
+            engine->set_merge_coplanar(true);
+            engine->run();
+
+            // The overlap is triangulated identically for both labels.
+            const auto& V_out = engine->get_vertices();
+            const auto& F_out = engine->get_faces();
+            const auto& L_out = engine->get_out_face_labels();
+            std::array<std::set<std::array<arrangement::Index, 3>>, 2> overlap;
+            for (arrangement::Index i = 0; i < F_out.rows(); i++) {
+                const arrangement::Vector3F centroid =
+                    (V_out.row(F_out(i, 0)) + V_out.row(F_out(i, 1)) + V_out.row(F_out(i, 2)))
+                        .transpose() /
+                    3;
+                if (centroid.x() <= 1 || centroid.x() >= 2 || centroid.y() <= 1 ||
+                    centroid.y() >= 2) {
+                    continue;
+                }
+                std::array<arrangement::Index, 3> corners = {
+                    F_out(i, 0), F_out(i, 1), F_out(i, 2)};
+                std::sort(corners.begin(), corners.end());
+                overlap[L_out[i]].insert(corners);
+            }
+            REQUIRE(!overlap[0].empty());
+            REQUIRE(overlap[0] == overlap[1]);
+        }
+    }
+
+    SECTION("Output sink")
+    {
+        auto [V2, F2, L2] = generate_rotated_tets(2);
+        auto reference = arrangement::Arrangement::create_mesh_arrangement(V2, F2, L2);
+        reference->set_exact_output(true);
+        reference->run();
+
+        CollectingSink sink;
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V2, F2, L2);
+        engine->set_exact_output(true);
+        engine->set_output_sink(&sink);
+        engine->run();
+
+        REQUIRE(sink.ended);
+        REQUIRE(sink.num_chunks > 2);
+        REQUIRE(sink.vertices == reference->get_vertices());
+        REQUIRE(sink.exact_vertices == reference->get_exact_vertices());
+        REQUIRE(sink.faces == reference->get_faces());
+        REQUIRE(sink.face_labels == reference->get_out_face_labels());
+        REQUIRE(sink.patches == reference->get_patches());
+        REQUIRE(sink.cells == reference->get_cells());
+        REQUIRE(sink.winding_number == reference->get_winding_number());
+
+        // Nothing is kept but the metrics.
+        REQUIRE(engine->get_vertices().rows() == 0);
+        REQUIRE(engine->get_faces().rows() == 0);
+        REQUIRE(engine->get_metrics().values.at("num_output_faces") ==
+                reference->get_faces().rows());
+    }
+
+    SECTION("Incremental update")
+    {
+        auto total_area = [](const arrangement::MatrixFr& vertices,
+                              const arrangement::MatrixIr& faces) {
+            double area = 0;
+            for (Eigen::Index i = 0; i < faces.rows(); i++) {
+                const Eigen::Vector3d v0 = vertices.row(faces(i, 0)).transpose();
+                const Eigen::Vector3d v1 = vertices.row(faces(i, 1)).transpose();
+                const Eigen::Vector3d v2 = vertices.row(faces(i, 2)).transpose();
+                area += (v1 - v0).cross(v2 - v0).norm() / 2;
+            }
+            return area;
+        };
+
+        auto F2 = F;
+        auto L2 = (L.array() + F.rows()).matrix().eval();
+        arrangement::VectorI changed = L2;
+        arrangement::VectorI groups(8);
+        groups << 0, 0, 0, 0, 1, 1, 1, 1;
+
+        auto V2 = (V.array() + 0.2).matrix().eval();
+        auto [V3, F3, L3] = concatenate_mesh(V, F, L, V2, F2, L2);
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V3, F3, L3);
+        engine->run();
+        REQUIRE(engine->get_num_cells() == 4);
+
+        // Move the second tet and compare with a full run.
+        auto V4 = (V.array() + 0.3).matrix().eval();
+        engine->update(changed, V4, F2, L2);
+        auto [V5, F5, L5] = concatenate_mesh(V, F, L, V4, F2, L2);
+        auto full = arrangement::Arrangement::create_mesh_arrangement(V5, F5, L5);
+        full->run();
+
+        REQUIRE(engine->get_num_cells() == full->get_num_cells());
+        REQUIRE(engine->get_num_patches() == full->get_num_patches());
+        REQUIRE(engine->get_out_face_labels().size() == engine->get_faces().rows());
+        using arrangement::BooleanOperation;
+        REQUIRE_THAT(total_area(engine->get_vertices(),
+                         engine->extract_boolean(BooleanOperation::Intersection, groups)),
+            Catch::Matchers::WithinAbs(total_area(full->get_vertices(),
+                                           full->extract_boolean(
+                                               BooleanOperation::Intersection, groups)),
+                1e-9));
+        REQUIRE(engine->get_metrics().values.at("update.num_resolved_faces") > 0);
+
+        // Move it far away.
+        auto V6 = (V.array() + 10).matrix().eval();
+        engine->update(changed, V6, F2, L2);
+        REQUIRE(engine->get_num_cells() == 3);
+        REQUIRE(engine->get_num_patches() == 2);
+        // Nothing overlaps the moved tet, only its own vertices are resolved.
+        REQUIRE(engine->get_metrics().values.at("update.num_resolved_vertices") == 4);
+
+        // Remove it.
+        engine->update(changed, arrangement::MatrixFr(0, 3), arrangement::MatrixIr(0, 3),
+            arrangement::VectorI(0));
+        REQUIRE(engine->get_num_cells() == 2);
+        REQUIRE(engine->get_num_patches() == 1);
+        REQUIRE_THAT(total_area(engine->get_vertices(), engine->get_faces()),
+            Catch::Matchers::WithinAbs(total_area(V, F), 1e-9));
+
+        // Labels must be listed as changed.
+        REQUIRE_THROWS(engine->update(arrangement::VectorI(0), V4, F2, L2));
+    }
+
+    SECTION("Region of interest box")
+    {
+        auto F2 = F;
+        auto L2 = (L.array() + F.rows()).matrix().eval();
+        auto V2 = (V.array() + 0.2).matrix().eval();
+        auto [V3, F3, L3] = concatenate_mesh(V, F, L, V2, F2, L2);
+
+        // The same pair of overlapping tets, far away.
+        auto V4 = (V3.array() + 10).matrix().eval();
+        auto L4 = (L3.array() + L3.size()).matrix().eval();
+        auto [V5, F5, L5] = concatenate_mesh(V3, F3, L3, V4, F3, L4);
+
+        auto full = arrangement::Arrangement::create_mesh_arrangement(V3, F3, L3);
+        full->run();
+
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V5,
+            F5,
+            L5,
+            arrangement::RegionOfInterest::from_box(
+                Eigen::Vector3d(-1, -1, -1), Eigen::Vector3d(2, 2, 2)));
+        engine->run();
+
+        // Only the first pair is resolved, the second passes through.
+        REQUIRE(engine->get_faces().rows() == full->get_faces().rows() + 8);
+        REQUIRE(engine->get_num_patches() == full->get_num_patches() + 2);
+        REQUIRE(engine->get_num_cells() == 0);
+        REQUIRE(engine->get_metrics().values.at("num_region_faces") == 8);
+    }
+
+    SECTION("Region of interest seam")
+    {
+        // Two triangles of a unit square and a vertical triangle crossing the
+        // first one and their shared edge at (0.5, 0.5, 0).
+        arrangement::MatrixFr V2(7, 3);
+        // clang-format off
+        V2 <<
+            0, 0, 0,
+            1, 0, 0,
+            0, 1, 0,
+            1, 1, 0,
+            0.2, 0.2, -1,
+            0.8, 0.8, -1,
+            0.5, 0.5, 1;
+        // clang-format on
+        arrangement::MatrixIr F2(3, 3);
+        F2 << 0, 1, 2, 1, 3, 2, 4, 5, 6;
+        arrangement::VectorI L2(3);
+        L2 << 0, 1, 2;
+        arrangement::VectorI mask(3);
+        mask << 1, 0, 1;
+
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(
+            V2, F2, L2, arrangement::RegionOfInterest::from_face_mask(mask));
+        engine->run();
+
+        const auto& vertices = engine->get_vertices();
+        const auto& faces = engine->get_faces();
+        const auto& labels = engine->get_out_face_labels();
+        REQUIRE(labels.size() == faces.rows());
+
+        int seam_vertex = -1;
+        for (Eigen::Index i = 0; i < vertices.rows(); i++) {
+            if (vertices.row(i) == Eigen::RowVector3d(0.5, 0.5, 0)) seam_vertex = i;
+        }
+        REQUIRE(seam_vertex >= 0);
+
+        // The face outside the region is split at the seam vertex.
+        size_t num_outside_faces = 0;
+        for (Eigen::Index i = 0; i < faces.rows(); i++) {
+            if (labels[i] != 1) continue;
+            num_outside_faces++;
+            REQUIRE((faces.row(i).array() == seam_vertex).any());
+        }
+        REQUIRE(num_outside_faces == 2);
+    }
 }
 #endif // ARRANGEMENT_IGL
 
@@ -325,3 +1089,712 @@ TEST_CASE("GeogramArrangement", "[arrangement]")
     }
 }
 #endif // ARRANGEMENT_GEOGRAM
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("Boolean", "[arrangement][boolean]")
+{
+    auto [V, F, L] = generate_tet();
+
+    SECTION("Single tet")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->run();
+
+        arrangement::VectorI groups = arrangement::VectorI::Zero(4);
+        auto winding_numbers = engine->get_cell_winding_numbers(groups);
+        REQUIRE(winding_numbers.rows() == 2);
+        REQUIRE(winding_numbers.cols() == 1);
+        REQUIRE(winding_numbers(0, 0) == 0);
+        REQUIRE(winding_numbers(1, 0) == 1);
+
+        auto faces = engine->extract_boolean(arrangement::BooleanOperation::Union, groups);
+        REQUIRE(faces.rows() == 4);
+        REQUIRE(faces == engine->get_cell_faces(1));
+    }
+
+    SECTION("Overlapping tets")
+    {
+        auto V2 = (V.array() + 0.2).matrix().eval();
+        auto F2 = F;
+        auto L2 = (L.array() + F.rows()).matrix().eval();
+        auto [V3, F3, L3] = concatenate_mesh(V, F, L, V2, F2, L2);
+
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V3, F3, L3);
+        engine->run();
+        const auto num_faces = engine->get_faces().rows();
+
+        arrangement::VectorI groups(8);
+        groups << 0, 0, 0, 0, 1, 1, 1, 1;
+
+        auto winding_numbers = engine->get_cell_winding_numbers(groups);
+        REQUIRE(winding_numbers.rows() == 4);
+        REQUIRE(winding_numbers.row(0).isZero());
+
+        using arrangement::BooleanOperation;
+        auto union_faces = engine->extract_boolean(BooleanOperation::Union, groups);
+        auto intersection_faces = engine->extract_boolean(BooleanOperation::Intersection, groups);
+        REQUIRE(union_faces.rows() > 0);
+        REQUIRE(intersection_faces.rows() > 0);
+        // Every face bounds either the union or the intersection.
+        REQUIRE(union_faces.rows() + intersection_faces.rows() == num_faces);
+
+        auto a_minus_b = engine->extract_boolean(BooleanOperation::Difference, groups);
+        arrangement::VectorI swapped_groups(8);
+        swapped_groups << 1, 1, 1, 1, 0, 0, 0, 0;
+        auto b_minus_a = engine->extract_boolean(BooleanOperation::Difference, swapped_groups);
+        REQUIRE(a_minus_b.rows() + b_minus_a.rows() == num_faces);
+
+        auto xor_faces = engine->extract_boolean(BooleanOperation::SymmetricDifference, groups);
+        REQUIRE(xor_faces.rows() == num_faces);
+
+        auto custom_faces = engine->extract_region(
+            groups, [](const arrangement::VectorI& w) { return w.sum() >= 2; });
+        REQUIRE(custom_faces == intersection_faces);
+    }
+}
+#endif // ARRANGEMENT_IGL
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("AutoArrangement", "[arrangement][auto]")
+{
+    auto [V, F, L] = generate_tet();
+
+    SECTION("Simple")
+    {
+        auto engine = arrangement::Arrangement::create_auto_arrangement(V, F, L);
+        engine->run();
+
+        REQUIRE(engine->get_num_cells() == 1 + 1);
+        REQUIRE(engine->get_num_patches() == 1);
+        REQUIRE(engine->get_faces().rows() == 4);
+
+        const auto& metrics = engine->get_metrics();
+        // Tiny inputs go to the mesh engine first.
+        REQUIRE(metrics.notes.at("engine") == "mesh");
+        REQUIRE(metrics.notes.at("attempt.mesh") == "ok");
+        REQUIRE(metrics.timings.count("profile") == 1);
+        REQUIRE(metrics.timings.count("resolve") == 1);
+        REQUIRE(metrics.values.at("profile.num_faces") == 4);
+        REQUIRE(metrics.values.at("profile.num_labels") == 4);
+    }
+
+    SECTION("Fallback")
+    {
+        arrangement::AutoArrangement engine(V, F, L);
+        engine.set_engines({"unknown", "mesh"});
+        engine.run();
+
+        REQUIRE(engine.get_selected_engine() == "mesh");
+        REQUIRE(engine.get_num_cells() == 1 + 1);
+        const auto& metrics = engine.get_metrics();
+        REQUIRE(metrics.notes.at("attempt.unknown").rfind("failed", 0) == 0);
+        REQUIRE(metrics.timings.count("attempt.unknown") == 1);
+        REQUIRE(metrics.timings.count("attempt.mesh") == 1);
+    }
+
+    SECTION("All engines fail")
+    {
+        arrangement::AutoArrangement engine(V, F, L);
+        engine.set_engines({"unknown"});
+        REQUIRE_THROWS(engine.run());
+    }
+
+    SECTION("Profile")
+    {
+        auto profile = arrangement::AutoArrangement::compute_profile(V, F, L);
+        REQUIRE(profile.num_faces == 4);
+        REQUIRE(profile.max_label == 3);
+        // All faces of a tet touch each other, none is coplanar.
+        REQUIRE(profile.candidate_pairs == 6);
+        REQUIRE(profile.coplanarity_ratio == 0);
+        REQUIRE(profile.num_planes == 0);
+
+        arrangement::MatrixFr V2(3, 3);
+        // clang-format off
+        V2 <<
+            0, 0, 0,
+            1, 0, 0,
+            0, 1, 0;
+        // clang-format on
+        arrangement::MatrixIr F2(2, 3);
+        F2 << 0, 1, 2, 2, 1, 0;
+        arrangement::VectorI L2(2);
+        L2 << 0, 1;
+
+        profile = arrangement::AutoArrangement::compute_profile(V2, F2, L2);
+        REQUIRE(profile.candidate_pairs == 1);
+        REQUIRE(profile.coplanarity_ratio == 1);
+        REQUIRE(profile.num_planes == 1);
+    }
+}
+#endif // ARRANGEMENT_IGL
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("PlanarArrangement", "[arrangement][planar]")
+{
+    // Two overlapping triangles in z = 0, with opposite orientations, and a
+    // third one in z = 1.
+    arrangement::MatrixFr V(9, 3);
+    // clang-format off
+    V <<
+        0, 0, 0,
+        2, 0, 0,
+        0, 2, 0,
+        1, 1, 0,
+        -1, 1, 0,
+        1, -1, 0,
+        0, 0, 1,
+        1, 0, 1,
+        0, 1, 1;
+    // clang-format on
+    arrangement::MatrixIr F(3, 3);
+    F << 0, 1, 2, 3, 5, 4, 6, 7, 8;
+    arrangement::VectorI L(3);
+    L << 0, 1, 2;
+
+    auto get_label_areas = [](const arrangement::Arrangement& engine) {
+        const auto& out_V = engine.get_vertices();
+        const auto& out_F = engine.get_faces();
+        const auto& out_L = engine.get_out_face_labels();
+        std::vector<double> areas(out_L.maxCoeff() + 1, 0.0);
+        for (Eigen::Index i = 0; i < out_F.rows(); i++) {
+            const arrangement::Vector3F v0 = out_V.row(out_F(i, 0)).transpose();
+            const arrangement::Vector3F v1 = out_V.row(out_F(i, 1)).transpose();
+            const arrangement::Vector3F v2 = out_V.row(out_F(i, 2)).transpose();
+            areas[out_L[i]] += (v1 - v0).cross(v2 - v0).z() / 2;
+        }
+        return areas;
+    };
+
+    SECTION("Detect planes")
+    {
+        auto planes = arrangement::PlanarArrangement::detect_planes(V, F);
+        REQUIRE(planes.size() == 3);
+        REQUIRE(planes[0] == planes[1]);
+        REQUIRE(planes[0] != planes[2]);
+        REQUIRE(arrangement::PlanarArrangement::detect_planes(V, F, 1).size() == 0);
+
+        auto [tet_V, tet_F, tet_L] = generate_tet();
+        REQUIRE(arrangement::PlanarArrangement::detect_planes(tet_V, tet_F).size() == 0);
+    }
+
+    SECTION("Same result as the mesh engine")
+    {
+        auto planar = arrangement::Arrangement::create_planar_arrangement(V, F, L);
+        planar->run();
+        auto mesh = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        mesh->run();
+
+        REQUIRE(planar->get_metrics().values.at("num_planes") == 2);
+        REQUIRE(planar->get_num_cells() == mesh->get_num_cells());
+        REQUIRE(planar->get_num_patches() == mesh->get_num_patches());
+        const auto planar_areas = get_label_areas(*planar);
+        const auto mesh_areas = get_label_areas(*mesh);
+        REQUIRE(planar_areas.size() == mesh_areas.size());
+        for (size_t i = 0; i < planar_areas.size(); i++) {
+            REQUIRE_THAT(planar_areas[i], Catch::Matchers::WithinAbs(mesh_areas[i], 1e-12));
+        }
+        // Orientation is kept: the second triangle is clockwise.
+        REQUIRE(planar_areas[1] < 0);
+    }
+
+    SECTION("Not planar")
+    {
+        auto [tet_V, tet_F, tet_L] = generate_tet();
+        auto engine = arrangement::Arrangement::create_planar_arrangement(tet_V, tet_F, tet_L);
+        REQUIRE_THROWS_AS(engine->run(), arrangement::RuntimeError);
+    }
+
+    SECTION("Auto engine")
+    {
+        arrangement::AutoArrangement engine(V, F, L);
+        engine.run();
+        REQUIRE(engine.get_selected_engine() == "planar");
+        REQUIRE(engine.get_metrics().values.at("profile.num_planes") == 2);
+    }
+}
+#endif // ARRANGEMENT_IGL
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("IntersectionCurves", "[arrangement][curves]")
+{
+    SECTION("Crossing triangles")
+    {
+        arrangement::MatrixFr V(6, 3);
+        // clang-format off
+        V <<
+            0, 0, 0,
+            1, 0, 0,
+            0, 1, 0,
+            0.2, 0.25, -1,
+            0.5, 0.25, 1,
+            0.8, 0.25, -1;
+        // clang-format on
+        arrangement::MatrixIr F(2, 3);
+        F << 0, 1, 2, 3, 4, 5;
+        arrangement::VectorI L(2);
+        L << 0, 1;
+
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        auto curves = engine->compute_intersection_curves();
+        REQUIRE(curves.segments.rows() == 1);
+        REQUIRE(curves.face_pairs.row(0) == Eigen::RowVector2i(0, 1));
+        REQUIRE(curves.vertices.rows() == 2);
+        REQUIRE(curves.polylines.size() == 1);
+        REQUIRE(curves.polylines[0].size() == 2);
+        REQUIRE(curves.num_coplanar_pairs == 0);
+        for (Eigen::Index i = 0; i < 2; i++) {
+            REQUIRE_THAT(curves.vertices(i, 1), Catch::Matchers::WithinAbs(0.25, 1e-12));
+            REQUIRE_THAT(curves.vertices(i, 2), Catch::Matchers::WithinAbs(0, 1e-12));
+        }
+
+        // The engine input is left untouched.
+        REQUIRE(engine->get_faces() == F);
+    }
+
+    SECTION("Overlapping tets")
+    {
+        auto [V, F, L] = generate_tet();
+        auto V2 = (V.array() + 0.2).matrix().eval();
+        auto L2 = (L.array() + F.rows()).matrix().eval();
+        auto [V3, F3, L3] = concatenate_mesh(V, F, L, V2, F, L2);
+
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V3, F3, L3);
+        auto curves = engine->compute_intersection_curves();
+        REQUIRE(curves.segments.rows() > 0);
+        // Each segment comes from one face of each tet.
+        for (Eigen::Index i = 0; i < curves.face_pairs.rows(); i++) {
+            REQUIRE(curves.face_pairs(i, 0) < 4);
+            REQUIRE(curves.face_pairs(i, 1) >= 4);
+        }
+        // Two convex surfaces intersect along closed loops.
+        REQUIRE(!curves.polylines.empty());
+        for (const auto& polyline : curves.polylines) {
+            REQUIRE(polyline.size() > 3);
+            REQUIRE(polyline.front() == polyline.back());
+        }
+    }
+
+    SECTION("Coplanar overlap")
+    {
+        arrangement::MatrixFr V(6, 3);
+        // clang-format off
+        V <<
+            0, 0, 0,
+            2, 0, 0,
+            0, 2, 0,
+            0.5, 0.5, 0,
+            2.5, 0.5, 0,
+            0.5, 2.5, 0;
+        // clang-format on
+        arrangement::MatrixIr F(2, 3);
+        F << 0, 1, 2, 3, 4, 5;
+        arrangement::VectorI L(2);
+        L << 0, 1;
+
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        auto curves = engine->compute_intersection_curves();
+        REQUIRE(curves.num_coplanar_pairs == 1);
+        // The overlap is the triangle (0.5, 0.5), (1.5, 0.5), (0.5, 1.5).
+        REQUIRE(curves.segments.rows() == 3);
+        REQUIRE(curves.vertices.rows() == 3);
+        REQUIRE(curves.polylines.size() == 1);
+        REQUIRE(curves.polylines[0].size() == 4);
+        REQUIRE(curves.polylines[0].front() == curves.polylines[0].back());
+
+        // Touching along an edge is not an overlap.
+        V.row(3) << 2, 0, 0;
+        V.row(4) << 2, 2, 0;
+        V.row(5) << 0, 2, 0;
+        engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        curves = engine->compute_intersection_curves();
+        REQUIRE(curves.num_coplanar_pairs == 0);
+        REQUIRE(curves.segments.rows() == 0);
+    }
+
+    SECTION("Shared vertex")
+    {
+        arrangement::MatrixFr V(5, 3);
+        // clang-format off
+        V <<
+            0, 0, 0,
+            1, 0, 0,
+            0, 1, 0,
+            1, 1, 1,
+            1, 1, -1;
+        // clang-format on
+        arrangement::MatrixIr F(2, 3);
+        F << 0, 1, 2, 0, 3, 4;
+        arrangement::VectorI L(2);
+        L << 0, 1;
+
+        // The second face crosses the first along the diagonal from the
+        // shared vertex.
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        auto curves = engine->compute_intersection_curves();
+        REQUIRE(curves.segments.rows() == 1);
+        REQUIRE(curves.polylines.size() == 1);
+        REQUIRE(curves.polylines[0].size() == 2);
+    }
+
+    SECTION("Exact input")
+    {
+        const double third = 1.0 / 3;
+        arrangement::MatrixFr V(6, 3);
+        // clang-format off
+        V <<
+            0, 0, third,
+            1, 0, third,
+            0, 1, third,
+            0.2, 0.25, -1,
+            0.8, 0.25, third,
+            0.2, 0.25, third;
+        // clang-format on
+        arrangement::MatrixIr F(2, 3);
+        F << 0, 1, 2, 3, 4, 5;
+        arrangement::VectorI L(2);
+        L << 0, 1;
+
+        // In floating point, the top edge of the second face lies on the first.
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        REQUIRE(engine->compute_intersection_curves().segments.rows() == 1);
+
+        // Exactly, the first face lies just above it.
+        const std::string above = "100000000000000000001/300000000000000000000";
+        engine->set_exact_vertices({"0", "0", above, "1", "0", above, "0", "1", above,
+            "1/5", "1/4", "-1", "4/5", "1/4", "1/3", "1/5", "1/4", "1/3"});
+        REQUIRE(engine->compute_intersection_curves().segments.rows() == 0);
+    }
+}
+#endif // ARRANGEMENT_IGL
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("Trace", "[arrangement][trace]")
+{
+    auto [V, F, L] = generate_tet();
+    if (!arrangement::Trace::is_available()) {
+        REQUIRE_THROWS_AS(arrangement::Trace::start(), arrangement::NotImplementedError);
+        return;
+    }
+
+    const auto filename =
+        (std::filesystem::temp_directory_path() / "arrangement_trace.json").string();
+    arrangement::Trace::start();
+    REQUIRE(arrangement::Trace::is_recording());
+    auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+    engine->run();
+    arrangement::Trace::stop(filename);
+    REQUIRE(!arrangement::Trace::is_recording());
+    REQUIRE_THROWS_AS(arrangement::Trace::stop(filename), arrangement::RuntimeError);
+
+    std::ifstream in(filename);
+    std::stringstream content;
+    content << in.rdbuf();
+    const std::string json = content.str();
+    REQUIRE(json.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(json.find("\"MeshArrangement::run\"") != std::string::npos);
+    REQUIRE(json.find("\"resolve\"") != std::string::npos);
+    REQUIRE(json.find("\"patches\"") != std::string::npos);
+    std::filesystem::remove(filename);
+}
+#endif // ARRANGEMENT_IGL
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("Stage memory", "[arrangement][memory]")
+{
+    auto [V, F, L] = generate_tet();
+    const bool counting = arrangement::MemoryUtils::is_allocation_counting_enabled();
+
+    SECTION("Mesh")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->run();
+
+        const auto& metrics = engine->get_metrics();
+        if (!counting) {
+            REQUIRE(metrics.memory.empty());
+            return;
+        }
+        REQUIRE(metrics.memory.count("resolve") == 1);
+        REQUIRE(metrics.memory.count("extract") == 1);
+        const auto& resolve = metrics.memory.at("resolve");
+        REQUIRE(resolve.num_allocations > 0);
+        REQUIRE(resolve.allocated_bytes >= resolve.num_allocations);
+    }
+
+    SECTION("Auto")
+    {
+        // Stages run by the selected engine are reported by the auto engine.
+        auto engine = arrangement::Arrangement::create_auto_arrangement(V, F, L);
+        engine->run();
+
+        const auto& metrics = engine->get_metrics();
+        if (!counting) {
+            REQUIRE(metrics.memory.empty());
+            return;
+        }
+        REQUIRE(metrics.memory.count("resolve") == 1);
+        REQUIRE(metrics.memory.at("resolve").num_allocations > 0);
+    }
+}
+#endif // ARRANGEMENT_IGL
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("Parts", "[arrangement][parts]")
+{
+    auto [tet_V, tet_F, tet_L] = generate_tet();
+    arrangement::Part tet;
+    tet.vertices = std::make_shared<const arrangement::MatrixFr>(tet_V);
+    tet.faces = std::make_shared<const arrangement::MatrixIr>(tet_F);
+
+    SECTION("Assemble")
+    {
+        arrangement::Part moved = tet;
+        moved.transform = Eigen::Translation3d(2, 0, 0);
+        moved.label = 7;
+        arrangement::Part mirrored = tet;
+        mirrored.transform = Eigen::Scaling(-1.0, 1.0, 1.0);
+        mirrored.face_labels = std::make_shared<const arrangement::VectorI>(tet_L);
+
+        arrangement::MatrixFr V;
+        arrangement::MatrixIr F;
+        arrangement::VectorI L;
+        arrangement::assemble_parts({tet, moved, mirrored}, V, F, L);
+        REQUIRE(V.rows() == 12);
+        REQUIRE(F.rows() == 12);
+        REQUIRE(V.row(5) == tet_V.row(1) + Eigen::RowVector3d(2, 0, 0));
+        REQUIRE(V(9, 0) == -1);
+        REQUIRE(F.row(4) == (tet_F.row(0).array() + 4).matrix());
+        // The reflection reverses the faces of the mirrored part.
+        REQUIRE(F.row(8) == (tet_F.row(0).reverse().array() + 8).matrix());
+        REQUIRE(L.segment(0, 4).isConstant(0));
+        REQUIRE(L.segment(4, 4).isConstant(7));
+        REQUIRE(L.segment(8, 4) == tet_L);
+
+        arrangement::Part empty;
+        REQUIRE_THROWS_AS(
+            arrangement::assemble_parts({tet, empty}, V, F, L), arrangement::RuntimeError);
+    }
+
+    SECTION("Same result as concatenation")
+    {
+        // Instances of a centered tet, like generate_rotated_tets().
+        const size_t N = 5;
+        arrangement::MatrixFr centered = tet_V.rowwise() - tet_V.colwise().mean();
+        tet.vertices = std::make_shared<const arrangement::MatrixFr>(centered);
+        tet.face_labels = std::make_shared<const arrangement::VectorI>(tet_L);
+        Eigen::Vector3d axis(1, 2, 3);
+        axis.normalize();
+        std::vector<arrangement::Part> parts(N, tet);
+        for (size_t i = 0; i < N; i++) {
+            parts[i].transform = Eigen::AngleAxisd(i * 2 * std::numbers::pi / N, axis);
+        }
+
+        auto [V, F, L] = generate_rotated_tets(N);
+        auto expected = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        expected->run();
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(parts);
+        engine->run();
+
+        REQUIRE(engine->get_out_face_labels().maxCoeff() == L.maxCoeff());
+        REQUIRE(engine->get_num_cells() == expected->get_num_cells());
+        REQUIRE(engine->get_num_patches() == expected->get_num_patches());
+        REQUIRE(engine->get_faces().rows() == expected->get_faces().rows());
+    }
+}
+#endif // ARRANGEMENT_IGL
+
+// In plugin builds the engines are only reachable through the registry.
+#if defined(ARRANGEMENT_IGL) || defined(ARRANGEMENT_ENGINE_PLUGINS)
+TEST_CASE("EngineRegistry", "[arrangement][registry]")
+{
+    auto [V, F, L] = generate_tet();
+    using arrangement::EngineRegistry::create;
+    using arrangement::EngineRegistry::is_available;
+
+#ifdef ARRANGEMENT_MESH_ENGINE
+    SECTION("Builtin engines")
+    {
+        // Registered up front, or loaded from their module in plugin builds.
+        REQUIRE(is_available("mesh"));
+        REQUIRE(is_available("planar"));
+        auto engine = create("mesh", V, F, L);
+        REQUIRE(engine != nullptr);
+        engine->run();
+        REQUIRE(engine->get_num_cells() == 1 + 1);
+
+        const auto names = arrangement::EngineRegistry::get_engine_names();
+        REQUIRE(std::find(names.begin(), names.end(), "mesh") != names.end());
+    }
+
+    SECTION("Registered engine")
+    {
+        // Shared, the registry outlives this section.
+        auto num_created = std::make_shared<size_t>(0);
+        arrangement::EngineRegistry::register_engine("test_mesh",
+            [num_created](arrangement::MatrixFr vertices,
+                const arrangement::MatrixIr& faces,
+                const arrangement::VectorI& face_labels,
+                const arrangement::EngineOptions& options) {
+                (*num_created)++;
+                return arrangement::Arrangement::create_mesh_arrangement(
+                    std::move(vertices), faces, face_labels, options.region_of_interest);
+            });
+        REQUIRE(is_available("test_mesh"));
+        REQUIRE(create("test_mesh", V, F, L) != nullptr);
+        REQUIRE(*num_created == 1);
+
+        // The auto engine tries registered engines by name.
+        arrangement::AutoArrangement engine(V, F, L);
+        engine.set_engines({"test_mesh"});
+        engine.run();
+        REQUIRE(engine.get_selected_engine() == "test_mesh");
+        REQUIRE(engine.get_num_cells() == 1 + 1);
+        REQUIRE(*num_created == 2);
+    }
+#endif
+
+    SECTION("Unknown engine")
+    {
+        REQUIRE_FALSE(is_available("unknown"));
+        REQUIRE(create("unknown", V, F, L) == nullptr);
+        REQUIRE_FALSE(is_available("../unknown"));
+        REQUIRE(create("../unknown", V, F, L) == nullptr);
+    }
+
+#ifdef ARRANGEMENT_ENGINE_PLUGINS
+    SECTION("Bad plugin")
+    {
+        REQUIRE_THROWS_AS(arrangement::EngineRegistry::load_plugin("missing.so"),
+            arrangement::RuntimeError);
+
+        // A module failing to load keeps failing, it is not taken for a
+        // missing one on the next lookup.
+        const auto dir = std::filesystem::temp_directory_path() / "arrangement_bad_plugin";
+        std::filesystem::create_directories(dir);
+        std::ofstream(dir / "arrangement_broken.so") << "not a shared library";
+        const char* env = std::getenv("ARRANGEMENT_PLUGIN_PATH");
+        const std::string saved_path = env != nullptr ? env : "";
+        setenv("ARRANGEMENT_PLUGIN_PATH", dir.c_str(), 1);
+        REQUIRE_THROWS_AS(create("broken", V, F, L), arrangement::RuntimeError);
+        REQUIRE_THROWS_AS(create("broken", V, F, L), arrangement::RuntimeError);
+        if (env != nullptr) {
+            setenv("ARRANGEMENT_PLUGIN_PATH", saved_path.c_str(), 1);
+        } else {
+            unsetenv("ARRANGEMENT_PLUGIN_PATH");
+        }
+        std::filesystem::remove_all(dir);
+    }
+#endif
+}
+#endif
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("PreviewArrangement", "[arrangement][preview]")
+{
+    auto [V, F, L] = generate_spheres(2, 32);
+
+    SECTION("Proxy")
+    {
+        auto proxy = arrangement::PreviewArrangement::compute_proxy(V, F, L, 0.25);
+        REQUIRE(proxy.faces.rows() > 0);
+        REQUIRE(proxy.faces.rows() < F.rows() / 4);
+        REQUIRE(proxy.vertices.rows() < V.rows() / 4);
+        REQUIRE(proxy.source_faces.size() == static_cast<size_t>(proxy.faces.rows()));
+        for (Eigen::Index i = 0; i < proxy.faces.rows(); i++) {
+            REQUIRE(proxy.faces(i, 0) != proxy.faces(i, 1));
+            REQUIRE(proxy.faces(i, 1) != proxy.faces(i, 2));
+            REQUIRE(proxy.faces(i, 2) != proxy.faces(i, 0));
+            REQUIRE(proxy.face_labels[i] == L[proxy.source_faces[i]]);
+        }
+
+        proxy = arrangement::PreviewArrangement::compute_proxy(V, F, L, 0);
+        REQUIRE(proxy.vertices == V);
+        REQUIRE(proxy.faces == F);
+    }
+
+    SECTION("Preview and refinement")
+    {
+        auto full = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        full->run();
+
+        arrangement::PreviewArrangement engine(V, F, L);
+        engine.set_engine("mesh");
+        engine.set_proxy_resolution(8);
+        arrangement::Arrangement::Ptr refined;
+        engine.set_refine_callback(
+            [&](arrangement::Arrangement::Ptr arrangement, const std::string& /*error*/) {
+                refined = arrangement;
+            });
+        engine.run();
+        REQUIRE(engine.is_approximate());
+        REQUIRE(engine.get_faces().rows() < F.rows() / 4);
+        REQUIRE(engine.get_out_face_labels().maxCoeff() == 1);
+        REQUIRE(engine.get_num_cells() > 1);
+        REQUIRE(engine.get_metrics().notes.at("preview") == "approximate");
+        REQUIRE(engine.get_metrics().values.at("preview.num_levels") == 1);
+
+        engine.wait_for_refinement();
+        REQUIRE(refined != nullptr);
+        REQUIRE(refined->get_num_cells() == full->get_num_cells());
+        REQUIRE(refined->get_faces().rows() == full->get_faces().rows());
+    }
+
+    SECTION("Time budget")
+    {
+        arrangement::PreviewArrangement engine(V, F, L);
+        engine.set_engine("mesh");
+        engine.set_proxy_resolution(8);
+        engine.set_time_budget(60);
+        engine.run();
+        REQUIRE(engine.get_metrics().values.at("preview.num_levels") > 1);
+        REQUIRE(engine.get_num_cells() > 1);
+    }
+
+    SECTION("Exact")
+    {
+        // The vertices of a tet never share a cell of the first level.
+        auto [tet_V, tet_F, tet_L] = generate_tet();
+        arrangement::PreviewArrangement engine(tet_V, tet_F, tet_L);
+        engine.set_engine("mesh");
+        arrangement::Arrangement::Ptr refined;
+        engine.set_refine_callback(
+            [&](arrangement::Arrangement::Ptr arrangement, const std::string& /*error*/) {
+                refined = arrangement;
+            });
+        engine.run();
+        REQUIRE_FALSE(engine.is_approximate());
+        REQUIRE(refined != nullptr);
+        // Handed over to the callback, the preview keeps no reference.
+        REQUIRE(refined.use_count() == 1);
+        REQUIRE(engine.get_num_cells() == 1 + 1);
+        REQUIRE(engine.get_winding_number() == refined->get_winding_number());
+        REQUIRE(engine.get_faces().rows() == 4);
+    }
+
+    SECTION("Fine first level")
+    {
+        // A grid finer than the input merges nothing: the full input is
+        // arranged right away.
+        auto full = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        full->run();
+
+        arrangement::PreviewArrangement engine(V, F, L);
+        engine.set_engine("mesh");
+        engine.set_proxy_resolution(size_t(1) << 20);
+        engine.run();
+        REQUIRE_FALSE(engine.is_approximate());
+        REQUIRE(engine.get_metrics().notes.at("preview") == "exact");
+        REQUIRE(engine.get_metrics().values.at("preview.num_levels") == 0);
+        REQUIRE(engine.get_faces().rows() == full->get_faces().rows());
+        REQUIRE(engine.get_num_cells() == full->get_num_cells());
+    }
+
+    SECTION("Unknown engine")
+    {
+        arrangement::PreviewArrangement engine(V, F, L);
+        engine.set_engine("unknown");
+        REQUIRE_THROWS_AS(engine.run(), arrangement::NotImplementedError);
+    }
+}
+#endif // ARRANGEMENT_IGL
@@ -0,0 +1,113 @@
+#include "utils.h"
+
+#include <arrangement/Arrangement.h>
+#include <arrangement/PointLocator.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef ARRANGEMENT_IGL
+TEST_CASE("PointLocator", "[arrangement][point_locator]")
+{
+    auto [V, F, L] = generate_tet();
+
+    SECTION("Single tet")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->run();
+
+        arrangement::PointLocator locator(*engine);
+
+        arrangement::MatrixFr points(3, 3);
+        // clang-format off
+        points <<
+            0.1, 0.1, 0.1,
+            2.0, 2.0, 2.0,
+           -0.1, 0.2, 0.2;
+        // clang-format on
+
+        auto cell_ids = locator.locate(points);
+        REQUIRE(cell_ids[0] == 1);
+        REQUIRE(cell_ids[1] == 0);
+        REQUIRE(cell_ids[2] == 0);
+
+        auto winding_numbers = locator.compute_winding_numbers(points);
+        REQUIRE(winding_numbers.cols() == 1);
+        REQUIRE(winding_numbers(0, 0) == 1);
+        REQUIRE(winding_numbers(1, 0) == 0);
+        REQUIRE(winding_numbers(2, 0) == 0);
+    }
+
+    SECTION("Points on the surface")
+    {
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V, F, L);
+        engine->run();
+
+        arrangement::PointLocator locator(*engine);
+
+        arrangement::MatrixFr points(4, 3);
+        // clang-format off
+        points <<
+            0.5, 0.0, 0.0,   // on an edge
+            0.0, 0.0, 1.0,   // on a vertex
+            0.25, 0.25, 0.0, // on a face
+            0.5, 1e-3, 1e-3; // close to an edge, inside
+        // clang-format on
+
+        auto cell_ids = locator.locate(points);
+        REQUIRE(cell_ids[0] == -1);
+        REQUIRE(cell_ids[1] == -1);
+        REQUIRE(cell_ids[2] == -1);
+        REQUIRE(cell_ids[3] == 1);
+
+        auto winding_numbers = locator.compute_winding_numbers(points);
+        REQUIRE(winding_numbers(0, 0) == arrangement::PointLocator::UNKNOWN_WINDING_NUMBER);
+        REQUIRE(winding_numbers(3, 0) == 1);
+    }
+
+    SECTION("Overlapping tets")
+    {
+        arrangement::MatrixFr V2 = (V.array() + 0.2).matrix();
+        arrangement::MatrixIr F2 = (F.array() + 4).matrix();
+        arrangement::VectorI L2 = (L.array() + 4).matrix();
+
+        arrangement::MatrixFr V3(8, 3);
+        arrangement::MatrixIr F3(8, 3);
+        arrangement::VectorI L3(8);
+        V3 << V, V2;
+        F3 << F, F2;
+        L3 << L, L2;
+
+        auto engine = arrangement::Arrangement::create_mesh_arrangement(V3, F3, L3);
+        engine->run();
+
+        arrangement::VectorI groups(8);
+        groups << 0, 0, 0, 0, 1, 1, 1, 1;
+        arrangement::PointLocator locator(*engine, groups);
+
+        arrangement::MatrixFr points(4, 3);
+        // clang-format off
+        points <<
+            0.1, 0.1, 0.1,   // in the first tet only
+            0.3, 0.3, 0.3,   // in both tets
+            0.6, 0.3, 0.3,   // in the second tet only
+            5.0, 0.0, 0.0;   // outside
+        // clang-format on
+
+        auto winding_numbers = locator.compute_winding_numbers(points);
+        REQUIRE(winding_numbers.rows() == 4);
+        REQUIRE(winding_numbers.cols() == 2);
+        REQUIRE(winding_numbers(0, 0) == 1);
+        REQUIRE(winding_numbers(0, 1) == 0);
+        REQUIRE(winding_numbers(1, 0) == 1);
+        REQUIRE(winding_numbers(1, 1) == 1);
+        REQUIRE(winding_numbers(2, 0) == 0);
+        REQUIRE(winding_numbers(2, 1) == 1);
+        REQUIRE(winding_numbers.row(3).isZero());
+
+        auto cell_ids = locator.locate(points);
+        REQUIRE(cell_ids[3] == 0);
+        REQUIRE(cell_ids[0] != cell_ids[1]);
+        REQUIRE(cell_ids[1] != cell_ids[2]);
+    }
+}
+#endif // ARRANGEMENT_IGL
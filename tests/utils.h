@@ -1,6 +1,11 @@
 #pragma once
 #include <arrangement/Arrangement.h>
 
+#include <Eigen/Geometry>
+
+#include <numbers>
+#include <random>
+
 inline auto generate_tet()
 {
     arrangement::MatrixFr vertices(4, 3);
@@ -36,3 +41,101 @@ auto concatentate_rows(
     C << A, B;
     return C;
 }
+
+/**
+ * N copies of the unit tet rotated around a common axis through their centroid.
+ */
+inline auto generate_rotated_tets(size_t N)
+{
+    auto [tet_V, tet_F, tet_L] = generate_tet();
+    tet_V = tet_V.rowwise() - tet_V.colwise().mean();
+    Eigen::Vector3d axis(1, 2, 3);
+    axis.normalize();
+
+    arrangement::MatrixFr V(4 * N, 3);
+    arrangement::MatrixIr F(4 * N, 3);
+    arrangement::VectorI L(4 * N);
+
+    for (size_t i = 0; i < N; i++) {
+        Eigen::AngleAxisd rot(i * 2 * std::numbers::pi / N, axis);
+        V.block(4 * i, 0, 4, 3) = (rot.toRotationMatrix() * tet_V.transpose()).transpose();
+        F.block(4 * i, 0, 4, 3) = tet_F.array() + 4 * i;
+        L.segment(4 * i, 4) = tet_L;
+    }
+    return std::make_tuple(V, F, L);
+}
+
+/**
+ * Random triangles in `num_layers` parallel planes z = 0, 1, ..., overlapping
+ * within each plane, like stacked sheets or layered boards.
+ */
+inline auto generate_planar_layers(size_t num_layers, size_t num_triangles_per_layer)
+{
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> position(0, 10);
+    std::uniform_real_distribution<double> offset(-1, 1);
+
+    const size_t num_faces = num_layers * num_triangles_per_layer;
+    arrangement::MatrixFr V(3 * num_faces, 3);
+    arrangement::MatrixIr F(num_faces, 3);
+    arrangement::VectorI L(num_faces);
+    for (size_t i = 0; i < num_faces; i++) {
+        const double z = static_cast<double>(i / num_triangles_per_layer);
+        const double x = position(gen);
+        const double y = position(gen);
+        for (size_t k = 0; k < 3; k++) {
+            V.row(3 * i + k) << x + offset(gen), y + offset(gen), z;
+        }
+        F.row(i) << 3 * i, 3 * i + 1, 3 * i + 2;
+        L[i] = static_cast<int>(i % 8);
+    }
+    return std::make_tuple(V, F, L);
+}
+
+/**
+ * `num_spheres` overlapping unit UV spheres with centers 1 apart along x, each
+ * with `n` bands of `2n` triangles or quads (n >= 2) and its own label.  Dense,
+ * smooth inputs.
+ */
+inline auto generate_spheres(size_t num_spheres, size_t n)
+{
+    const size_t m = 2 * n;
+    const size_t num_vertices = (n - 1) * m + 2;
+    const size_t num_faces = 4 * n * (n - 1);
+    arrangement::MatrixFr V(num_spheres * num_vertices, 3);
+    arrangement::MatrixIr F(num_spheres * num_faces, 3);
+    arrangement::VectorI L(num_spheres * num_faces);
+    for (size_t s = 0; s < num_spheres; s++) {
+        const size_t v0 = s * num_vertices;
+        const double x = static_cast<double>(s);
+        // Poles first, then the rings from north to south.
+        V.row(v0) << x, 0, 1;
+        V.row(v0 + 1) << x, 0, -1;
+        for (size_t i = 1; i < n; i++) {
+            const double theta = std::numbers::pi * i / n;
+            for (size_t j = 0; j < m; j++) {
+                const double phi = std::numbers::pi * j / n;
+                V.row(v0 + 2 + (i - 1) * m + j) << x + std::sin(theta) * std::cos(phi),
+                    std::sin(theta) * std::sin(phi), std::cos(theta);
+            }
+        }
+        auto ring = [&](size_t i, size_t j) {
+            return static_cast<arrangement::Index>(v0 + 2 + (i - 1) * m + j % m);
+        };
+        const auto north = static_cast<arrangement::Index>(v0);
+        const auto south = static_cast<arrangement::Index>(v0 + 1);
+        size_t f = s * num_faces;
+        for (size_t j = 0; j < m; j++) {
+            F.row(f++) << north, ring(1, j), ring(1, j + 1);
+            F.row(f++) << south, ring(n - 1, j + 1), ring(n - 1, j);
+        }
+        for (size_t i = 1; i + 1 < n; i++) {
+            for (size_t j = 0; j < m; j++) {
+                F.row(f++) << ring(i, j), ring(i + 1, j), ring(i + 1, j + 1);
+                F.row(f++) << ring(i, j), ring(i + 1, j + 1), ring(i, j + 1);
+            }
+        }
+        L.segment(s * num_faces, num_faces).setConstant(static_cast<int>(s));
+    }
+    return std::make_tuple(V, F, L);
+}